@@ -0,0 +1,44 @@
+#pragma once
+
+#ifndef __GNUC__
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+// SIMD code paths are compiled with TARGET_AVX2 (no global compiler option is needed)
+// and are selected at runtime with CpuFeature::hasAVX2().
+#ifdef __GNUC__
+#define TARGET_AVX2     __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+struct CpuFeature {
+    static bool hasAVX2() {
+        static const bool res = checkAVX2();
+        return res;
+    }
+
+private:
+    static bool checkAVX2() {
+#ifdef __GNUC__
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // OSXSAVE & AVX, and the OS saves YMM registers
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+            return false;
+        if ((_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#endif
+    }
+};
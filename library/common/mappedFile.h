@@ -0,0 +1,94 @@
+#pragma once
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include <cstddef>
+
+// a read-only memory-mapped file
+struct MappedFile {
+    MappedFile() : ptr(nullptr), length(0) {
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator =(const MappedFile&) = delete;
+
+    bool open(const char* path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        HANDLE mapping = NULL;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+            mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file);
+        if (mapping == NULL)
+            return false;
+
+        ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (ptr == NULL)
+            return false;
+        length = size_t(size.QuadPart);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+            p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return false;
+
+        ptr = p;
+        length = size_t(st.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+        if (!ptr)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(ptr);
+#else
+        munmap(ptr, length);
+#endif
+        ptr = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const {
+        return ptr != nullptr;
+    }
+
+    const void* data() const {
+        return ptr;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    void* ptr;
+    size_t length;
+};
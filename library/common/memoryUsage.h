@@ -0,0 +1,60 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <cstdio>
+#include <cstring>
+#endif
+
+// process memory usage in bytes (0 if it's not available)
+struct MemoryUsage {
+    // peak resident set size
+    static size_t peakRSS() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return size_t(pmc.PeakWorkingSetSize);
+        return 0;
+#else
+        return readStatus("VmHWM:");
+#endif
+    }
+
+    // current resident set size
+    static size_t currentRSS() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return size_t(pmc.WorkingSetSize);
+        return 0;
+#else
+        return readStatus("VmRSS:");
+#endif
+    }
+
+private:
+#ifndef _WIN32
+    static size_t readStatus(const char* key) {
+        FILE* fp = fopen("/proc/self/status", "r");
+        if (!fp)
+            return 0;
+
+        size_t res = 0;
+        char line[256];
+        size_t keyLen = strlen(key);
+        while (fgets(line, sizeof(line), fp)) {
+            if (strncmp(line, key, keyLen) == 0) {
+                unsigned long long kb = 0;
+                if (sscanf(line + keyLen, "%llu", &kb) == 1)
+                    res = size_t(kb) * 1024;
+                break;
+            }
+        }
+        fclose(fp);
+        return res;
+    }
+#endif
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+// fork-join helpers built on std::thread
+struct Parallel {
+    static int threadCount() {
+        int n = int(std::thread::hardware_concurrency());
+        return n > 0 ? n : 1;
+    }
+
+    // calls f(lo, hi) for contiguous chunks of [first, last), one chunk per thread
+    // - chunk boundaries are multiples of 'align' (relative to first)
+    template <typename Func>
+    static void forRange(int first, int last, int threadN, Func f, int align = 1) {
+        int n = last - first;
+        int units = (n + align - 1) / align;
+        if (threadN > units)
+            threadN = units;
+        if (threadN <= 1) {
+            if (n > 0)
+                f(first, last);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadN - 1);
+        for (int t = 1; t < threadN; t++) {
+            int lo = first + int(1ll * units * t / threadN) * align;
+            int hi = (t + 1 == threadN) ? last : first + int(1ll * units * (t + 1) / threadN) * align;
+            threads.emplace_back([f, lo, hi]() { f(lo, hi); });
+        }
+        f(first, std::min(last, first + int(1ll * units / threadN) * align));
+        for (auto& th : threads)
+            th.join();
+    }
+
+    // calls f(i) for all i in [0, taskN), each thread takes the next task dynamically
+    template <typename Func>
+    static void forEach(int taskN, int threadN, Func f) {
+        if (threadN > taskN)
+            threadN = taskN;
+        if (threadN <= 1) {
+            for (int i = 0; i < taskN; i++)
+                f(i);
+            return;
+        }
+
+        std::atomic<int> next(0);
+        auto worker = [&]() {
+            for (int i = next++; i < taskN; i = next++)
+                f(i);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadN - 1);
+        for (int t = 1; t < threadN; t++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& th : threads)
+            th.join();
+    }
+
+    // runs f1 and f2 at the same time
+    template <typename Func1, typename Func2>
+    static void invoke(Func1 f1, Func2 f2) {
+        std::thread th(f1);
+        f2();
+        th.join();
+    }
+};
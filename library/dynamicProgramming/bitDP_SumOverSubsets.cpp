@@ -31,6 +31,52 @@ void testBitDP() {
     auto ans = solveSOS(N, A);
 
     assert(gt == ans);
+    assert(solveSOSInverse(N, ans) == A);
+
+    {
+        const int MOD = 1000000007;
+
+        vector<int> B(1 << N);
+        for (int i = 0; i < (1 << N); i++)
+            B[i] = RandInt32::get() % 65536;
+
+        auto C = solveSubsetConvolution<MOD>(N, A, B);
+        for (int x = 0; x < (1 << N); x++) {
+            long long sum = 0;
+            for (int i = x; ; i = (i - 1) & x) {
+                sum = (sum + 1ll * A[i] * B[x ^ i]) % MOD;
+                if (!i)
+                    break;
+            }
+            assert(C[x] == sum);
+        }
+    }
 
     cout << "OK!" << endl;
+    {
+        cout << "*** Speed test: SOS, N = 2^24 ***" << endl;
+
+        int N = 24;
+        vector<int> A(1 << N);
+        for (int i = 0; i < (1 << N); i++)
+            A[i] = RandInt32::get() % 16;
+
+        cout << "  plain loops" << endl;
+        PROFILE_HI_START(0);
+        vector<int> F(A);
+        for (int i = 0; i < N; ++i) {
+            for (int mask = 0; mask < (1 << N); mask++) {
+                if (mask & (1 << i))
+                    F[mask] += F[mask ^ (1 << i)];
+            }
+        }
+        PROFILE_HI_STOP(0);
+
+        cout << "  solveSOS()" << endl;
+        PROFILE_HI_START(1);
+        auto ans = solveSOS(N, A);
+        PROFILE_HI_STOP(1);
+
+        assert(ans == F);
+    }
 }
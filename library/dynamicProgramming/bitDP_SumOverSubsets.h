@@ -1,6 +1,8 @@
 #pragma once
 #pragma warning(disable: 4334)
 
+#include "../polynomial/walshHadamardFast.h"
+
 ///////////////////////////////////////////////////////////////////////////////
 // Sum over Subsets(SOS)
 // http://codeforces.com/blog/usaxena95
@@ -30,19 +32,27 @@ inline vector<int> solveSOSNaive(int bitSize, const vector<int>& A) {
 // 
 // https://www.hackerearth.com/practice/algorithms/dynamic-programming/bit-masking/practice-problems/algorithm/compatibility-queries-0c068f8f/
 // 
-inline vector<int> solveSOS(int bitSize, const vector<int>& A) {
-    vector<int> F(1 << bitSize);
-
-    for (int mask = 0; mask < (1 << bitSize); mask++)
-        F[mask] = A[mask];
-
-    for (int i = 0; i < bitSize; ++i) {
-        for (int mask = 0; mask < (1 << bitSize); mask++) {
-            if (mask & (1 << i))
-                F[mask] += F[mask ^ (1 << i)];
-        }
-    }
-
+// - cache-blocked, AVX2 and multithreaded zeta transform (FWHTFast<int>::transformOr())
+// - threadN <= 0 : all hardware threads
+inline vector<int> solveSOS(int bitSize, const vector<int>& A, int threadN = 1) {
+    vector<int> F(A.begin(), A.begin() + (1 << bitSize));
+    FWHTFast<int>::transformOr(F.data(), 1 << bitSize, false, threadN);
     return F;
 }
 
+// the inverse of solveSOS() (Mobius transform), O(b * 2^b)
+// F : F(x) = SUM A[i],  i = subsets of X
+// return : A
+inline vector<int> solveSOSInverse(int bitSize, const vector<int>& F, int threadN = 1) {
+    vector<int> A(F.begin(), F.begin() + (1 << bitSize));
+    FWHTFast<int>::transformOr(A.data(), 1 << bitSize, true, threadN);
+    return A;
+}
+
+// O(b^2 * 2^b)
+// return : C(x) = SUM A[i] * B[x ^ i],  i = subsets of X  (modulo 'mod')
+template <int mod>
+inline vector<int> solveSubsetConvolution(int bitSize, const vector<int>& A, const vector<int>& B, int threadN = 1) {
+    return FWHTModFast<mod>::subsetConvolution(vector<int>(A.begin(), A.begin() + (1 << bitSize)),
+                                               vector<int>(B.begin(), B.begin() + (1 << bitSize)), threadN);
+}
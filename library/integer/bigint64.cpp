@@ -0,0 +1,214 @@
+#include <cmath>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <istream>
+#include <algorithm>
+
+using namespace std;
+
+#include "bigint64.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+static string getRandomDecimal(int len) {
+    string s;
+    s += char('1' + RandInt32::get() % 9);
+    for (int i = 1; i < len; i++)
+        s += char('0' + RandInt32::get() % 10);
+    return s;
+}
+
+static bigint64 getRandomBigint64(int limbs) {
+    bigint64 res;
+    res.a.resize(limbs);
+    for (auto& v : res.a)
+        v = (unsigned long long)RandInt32::get() << 32 | RandInt32::get();
+    // runs of all-ones and zeros for the carry paths
+    if (limbs > 4 && RandInt32::get() % 3 == 0)
+        fill(res.a.begin() + limbs / 4, res.a.begin() + limbs / 2, ~0ull);
+    if (limbs > 4 && RandInt32::get() % 3 == 0)
+        fill(res.a.begin() + limbs / 2, res.a.end() - 1, 0ull);
+    res.trim();
+    if (RandInt32::get() & 1)
+        res = -res;
+    return res;
+}
+
+static bigint64 multiplySlow(const bigint64& x, const bigint64& y) {
+    // shift-and-add over the limbs of y
+    bigint64 res;
+    bigint64 t = x.abs();
+    for (int i = 0; i < int(y.a.size()); i++) {
+        bigint64 part;
+        part.a = bigint64::multiply(t.a, vector<unsigned long long>{ y.a[i] });
+        part.a.insert(part.a.begin(), i, 0ull);
+        part.trim();
+        res += part;
+    }
+    if (x.sign * y.sign < 0)
+        res = -res;
+    return res;
+}
+
+static double elapsedSec(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+}
+
+void testBigInt64() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "------------ Big Integer (64-bit limbs) --------------" << endl;
+    {
+        assert(bigint64("0").toString() == "0");
+        assert(bigint64("-0").toString() == "0");
+        assert(bigint64("-000123").toString() == "-123");
+        assert(bigint64(-1234567890123456789ll).toString() == "-1234567890123456789");
+        assert(bigint64("18446744073709551616").a == (vector<unsigned long long>{ 0, 1 }));
+
+        for (int len : { 1, 9, 10, 18, 19, 20, 100, 1000, 5000, 30000 }) {
+            string s = getRandomDecimal(len);
+            bigint64 x(s);
+            assert(x.toString() == s);
+            assert((-x).toString() == "-" + s);
+
+            bigint b(s);
+            assert(bigint64(b) == x);
+            assert(x.toBigint() == b);
+        }
+    }
+    // multiplication : every algorithm against the slow one and bigint
+    {
+        for (int n : { 1, 2, 31, 32, 33, 64, 100, 159, 160, 161, 300, 699, 700, 701, 1500, 3000 }) {
+            for (int m : { 1, 7, n / 3 + 1, n / 2 + 1, n }) {
+                bigint64 x = getRandomBigint64(n), y = getRandomBigint64(m);
+                bigint64 z = x * y;
+                assert(z == multiplySlow(x, y));
+                assert(z == y * x);
+                if (n <= 700 && m == n) {
+                    assert(z.toBigint() == x.toBigint() * y.toBigint());
+                    assert(x * x == multiplySlow(x, x));
+                }
+            }
+        }
+        // 16-bit NTT chunks (more than 2^21 32-bit chunks)
+        {
+            bigint64 x = getRandomBigint64(1 << 20 | 5), y = getRandomBigint64(1 << 20 | 3);
+            bigint64 z = x * y;
+            bigint64 m(1000000007);
+            assert(z % m == (x % m) * (y % m) % m);
+            bigint64 q, r;
+            tie(q, r) = divMod(z, x);
+            assert(q == y && r.isZero());
+        }
+    }
+    // division
+    {
+        for (int n : { 1, 2, 10, 64, 65, 100, 200, 500, 1000, 3000 }) {
+            for (int m : { 1, 2, n / 4 + 1, n / 2, n - 1, n }) {
+                if (m <= 0)
+                    continue;
+                bigint64 x = getRandomBigint64(n), y = getRandomBigint64(m);
+                if (y.isZero())
+                    continue;
+
+                bigint64 q, r;
+                tie(q, r) = divMod(x, y);
+                assert(q * y + r == x);
+                assert(r.abs() < y.abs());
+                assert(r.isZero() || r.sign == x.sign);
+
+                if (n <= 200) {
+                    bigint q2, r2;
+                    tie(q2, r2) = divMod(x.toBigint(), y.toBigint());
+                    assert(q.toBigint() == q2);
+                    assert(r.toBigint() == r2);
+                }
+            }
+        }
+        // exact multiples and divisors with small top limbs
+        for (int n : { 100, 700, 2000 }) {
+            bigint64 x = getRandomBigint64(n).abs(), y = getRandomBigint64(n / 2).abs();
+            y.a.back() = 1;
+            bigint64 z = x * y;
+            assert(z / y == x);
+            assert((z % y).isZero());
+            assert((z - bigint64(1)) / y == x - bigint64(1));
+        }
+    }
+    cout << "OK!" << endl;
+    {
+        cout << "*** Speed test: bigint vs bigint64 ***" << endl;
+
+        for (int digits : { 10000, 100000 }) {
+            bigint x(getRandomDecimal(digits)), y(getRandomDecimal(digits));
+            bigint64 x64(x), y64(y);
+
+            auto start = chrono::high_resolution_clock::now();
+            bigint z = x * y;
+            double t1 = elapsedSec(start);
+
+            start = chrono::high_resolution_clock::now();
+            bigint64 z64 = x64 * y64;
+            double t2 = elapsedSec(start);
+            if (digits <= 10000)
+                assert(z64.toBigint() == z);    // bigint's FFT loses precision above it
+
+            cout << "  multiply " << digits << " digits : bigint = " << t1 << " sec, bigint64 = " << t2 << " sec" << endl;
+        }
+        {
+            bigint x(getRandomDecimal(20000)), y(getRandomDecimal(4000));
+            bigint64 x64(x), y64(y);
+
+            auto start = chrono::high_resolution_clock::now();
+            bigint q = x / y;
+            double t1 = elapsedSec(start);
+
+            start = chrono::high_resolution_clock::now();
+            bigint64 q64 = x64 / y64;
+            double t2 = elapsedSec(start);
+            assert(q64.toBigint() == q);
+
+            cout << "  divide 20000 / 4000 digits : bigint = " << t1 << " sec, bigint64 = " << t2 << " sec" << endl;
+        }
+
+        cout << "*** Speed test: bigint64 ***" << endl;
+        for (int digits : { 1000000, 10000000 }) {
+            string s = getRandomDecimal(digits);
+            string s2 = getRandomDecimal(digits / 2);
+
+            auto start = chrono::high_resolution_clock::now();
+            bigint64 x(s), y(s2);
+            double tParse = elapsedSec(start);
+
+            start = chrono::high_resolution_clock::now();
+            bigint64 z = x * x;
+            double tMul = elapsedSec(start);
+
+            start = chrono::high_resolution_clock::now();
+            bigint64 q, r;
+            tie(q, r) = divMod(x, y);
+            double tDiv = elapsedSec(start);
+
+            start = chrono::high_resolution_clock::now();
+            string out = x.toString();
+            double tStr = elapsedSec(start);
+
+            assert(out == s);
+            assert(q * y + r == x && r < y);
+            if (z.sign < 0)
+                cout << "What?" << endl;
+
+            cout << "  " << digits << " digits : parse = " << tParse << " sec, square = " << tMul
+                 << " sec, divide by " << digits / 2 << " digits = " << tDiv << " sec, toString = " << tStr << " sec" << endl;
+        }
+    }
+}
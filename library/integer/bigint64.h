@@ -0,0 +1,1024 @@
+#pragma once
+
+#ifndef __GNUC__
+#include <intrin.h>
+#endif
+#include "bigint.h"
+#include "garnerAlgorithm.h"
+#include "../polynomial/ntt_avx2.h"
+
+/*
+  Big integer with binary limbs (2^64), LSB first
+
+  - multiplication : schoolbook -> Karatsuba -> Toom-3 -> 3-prime NTT (AVX2), chosen by the size
+  - division       : Knuth's algorithm D for short quotients or divisors,
+                     Newton's reciprocal (exact floor(B^2m / b)) and block division for the others
+  - decimal        : divide and conquer with cached 10^(9 * 2^k) and their reciprocals,
+                     O(M(n) log n) for both toString() and parsing
+  - bigint         : bigint64(const bigint&) and toBigint() convert through base-10^9 words
+
+  <How to use>
+    bigint64 a("123456789012345678901234567890"), b(12345);
+    bigint64 c = a * b, d = a / b, e = a % b;
+    string s = c.toString();
+    bigint x = c.toBigint();
+*/
+struct bigint64 {
+    typedef unsigned long long u64;
+
+    static const int KARATSUBA_THRESHOLD = 32;      // in limbs
+    static const int TOOM3_THRESHOLD = 160;
+    static const int NTT_THRESHOLD = 700;
+    static const int DIV_THRESHOLD = 64;            // Newton division is used above it
+    static const int DECIMAL_THRESHOLD = 48;        // leaves of decimal conversion
+
+    vector<u64> a;      // magnitude without leading zeros
+    int sign;           // 1 or -1 (1 for zero)
+
+    bigint64() : sign(1) {
+    }
+
+    explicit bigint64(long long v) {
+        *this = v;
+    }
+
+    explicit bigint64(const string& s) {
+        operator =(s);
+    }
+
+    explicit bigint64(const bigint& v) {
+        sign = v.sign;
+        a = fromBase1e9(v.a);
+        trim();
+    }
+
+    bigint64& operator =(long long v) {
+        sign = 1;
+        a.clear();
+        if (v < 0) {
+            sign = -1;
+            a.push_back(u64(0) - u64(v));
+        } else if (v > 0) {
+            a.push_back(u64(v));
+        }
+        return *this;
+    }
+
+    bigint64& operator =(const string& s) {
+        int pos = 0;
+        int sgn = 1;
+        while (pos < int(s.size()) && (s[pos] == '-' || s[pos] == '+')) {
+            if (s[pos] == '-')
+                sgn = -sgn;
+            ++pos;
+        }
+
+        vector<int> words;
+        for (int i = int(s.size()) - 1; i >= pos; i -= 9) {
+            int x = 0;
+            for (int j = max(pos, i - 8); j <= i; j++)
+                x = x * 10 + s[j] - '0';
+            words.push_back(x);
+        }
+        a = fromBase1e9(words);
+        sign = sgn;
+        trim();
+        return *this;
+    }
+
+    bigint toBigint() const {
+        bigint res;
+        res.a = toBase1e9(a);
+        res.sign = sign;
+        res.trim();
+        return res;
+    }
+
+    string toString() const {
+        vector<int> words = toBase1e9(a);
+        if (words.empty())
+            return "0";
+
+        string res;
+        if (sign < 0)
+            res.push_back('-');
+        res += to_string(words.back());
+
+        size_t pos = res.size();
+        res.resize(pos + 9 * (words.size() - 1));
+        for (int i = int(words.size()) - 2; i >= 0; i--, pos += 9) {
+            int x = words[i];
+            for (int j = 8; j >= 0; j--, x /= 10)
+                res[pos + j] = char('0' + x % 10);
+        }
+        return res;
+    }
+
+
+    bool isZero() const {
+        return a.empty();
+    }
+
+    bigint64 operator -() const {
+        bigint64 res = *this;
+        if (!res.isZero())
+            res.sign = -sign;
+        return res;
+    }
+
+    bigint64 abs() const {
+        bigint64 res = *this;
+        res.sign = 1;
+        return res;
+    }
+
+    long long longValue() const {
+        return a.empty() ? 0 : (long long)a[0] * sign;
+    }
+
+
+    bigint64 operator +(const bigint64& v) const {
+        bigint64 res;
+        if (sign == v.sign) {
+            res.a = addMag(a, v.a);
+            res.sign = sign;
+        } else if (compareMag(a, v.a) >= 0) {
+            res.a = subMag(a, v.a);
+            res.sign = sign;
+        } else {
+            res.a = subMag(v.a, a);
+            res.sign = v.sign;
+        }
+        res.trim();
+        return res;
+    }
+
+    bigint64& operator +=(const bigint64& v) {
+        *this = *this + v;
+        return *this;
+    }
+
+    bigint64 operator -(const bigint64& v) const {
+        return *this + (-v);
+    }
+
+    bigint64& operator -=(const bigint64& v) {
+        *this = *this - v;
+        return *this;
+    }
+
+    bigint64 operator *(const bigint64& v) const {
+        bigint64 res;
+        res.a = multiply(a, v.a);
+        res.sign = sign * v.sign;
+        res.trim();
+        return res;
+    }
+
+    bigint64& operator *=(const bigint64& v) {
+        *this = *this * v;
+        return *this;
+    }
+
+    bigint64 operator /(const bigint64& v) const {
+        return divMod(*this, v).first;
+    }
+
+    bigint64& operator /=(const bigint64& v) {
+        *this = *this / v;
+        return *this;
+    }
+
+    bigint64 operator %(const bigint64& v) const {
+        return divMod(*this, v).second;
+    }
+
+    bigint64& operator %=(const bigint64& v) {
+        *this = *this % v;
+        return *this;
+    }
+
+
+    bool operator <(const bigint64& v) const {
+        if (sign != v.sign)
+            return sign < v.sign;
+        int c = compareMag(a, v.a);
+        return sign > 0 ? c < 0 : c > 0;
+    }
+
+    bool operator >(const bigint64& v) const {
+        return v < *this;
+    }
+
+    bool operator <=(const bigint64& v) const {
+        return !(v < *this);
+    }
+
+    bool operator >=(const bigint64& v) const {
+        return !(*this < v);
+    }
+
+    bool operator ==(const bigint64& v) const {
+        return sign == v.sign && a == v.a;
+    }
+
+    bool operator !=(const bigint64& v) const {
+        return !(*this == v);
+    }
+
+
+    void trim() {
+        while (!a.empty() && a.back() == 0)
+            a.pop_back();
+        if (a.empty())
+            sign = 1;
+    }
+
+    // truncated division, the remainder has the sign of the dividend (the same as bigint)
+    friend pair<bigint64, bigint64> divMod(const bigint64& a1, const bigint64& b1) {
+        pair<bigint64, bigint64> res;
+        divModMag(a1.a, b1.a, res.first.a, res.second.a);
+        res.first.sign = a1.sign * b1.sign;
+        res.second.sign = a1.sign;
+        res.first.trim();
+        res.second.trim();
+        return res;
+    }
+
+    //--- magnitude operations (LSB first, no leading zeros)
+
+    static int compareMag(const vector<u64>& x, const vector<u64>& y) {
+        if (x.size() != y.size())
+            return x.size() < y.size() ? -1 : 1;
+        for (int i = int(x.size()) - 1; i >= 0; i--) {
+            if (x[i] != y[i])
+                return x[i] < y[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static vector<u64> addMag(const vector<u64>& x, const vector<u64>& y) {
+        if (x.size() < y.size())
+            return addMag(y, x);
+        vector<u64> res(x.size() + 1);
+        copy(x.begin(), x.end(), res.begin());
+        addTo(res.data(), int(res.size()), y.data(), int(y.size()));
+        trimMag(res);
+        return res;
+    }
+
+    // x >= y
+    static vector<u64> subMag(const vector<u64>& x, const vector<u64>& y) {
+        vector<u64> res(x);
+        subFrom(res.data(), int(res.size()), y.data(), int(y.size()));
+        trimMag(res);
+        return res;
+    }
+
+    static vector<u64> multiply(const vector<u64>& x, const vector<u64>& y) {
+        if (x.empty() || y.empty())
+            return vector<u64>();
+        vector<u64> res(x.size() + y.size());
+        multiply(x.data(), int(x.size()), y.data(), int(y.size()), res.data());
+        trimMag(res);
+        return res;
+    }
+
+    // out[0..xn+yn) = x * y, out must not overlap with x and y
+    static void multiply(const u64* x, int xn, const u64* y, int yn, u64* out) {
+        if (xn < yn) {
+            swap(x, y);
+            swap(xn, yn);
+        }
+        if (yn <= 0) {
+            fill(out, out + xn + yn, 0ull);
+            return;
+        }
+
+        if (yn < KARATSUBA_THRESHOLD)
+            multiplySchool(x, xn, y, yn, out);
+        else if (yn >= NTT_THRESHOLD && multiplyNTT(x, xn, y, yn, out))
+            return;
+        else if (2 * yn <= xn)
+            multiplyUnbalanced(x, xn, y, yn, out);
+        else if (yn < TOOM3_THRESHOLD)
+            multiplyKaratsuba(x, xn, y, yn, out);
+        else
+            multiplyToom3(x, xn, y, yn, out);
+    }
+
+    static void divModMag(const vector<u64>& x, const vector<u64>& y, vector<u64>& q, vector<u64>& r) {
+        //assert(!y.empty());
+        if (compareMag(x, y) < 0) {
+            q.clear();
+            r = x;
+            return;
+        }
+
+        int n = int(x.size()), m = int(y.size());
+        if (m <= DIV_THRESHOLD || n - m <= DIV_THRESHOLD) {
+            divModKnuth(x, y, q, r);
+            return;
+        }
+
+        // the quotient is much shorter than the divisor : q <= q' <= q + 2 with the top limbs only
+        int t = n - m + 2;
+        if (t < m) {
+            vector<u64> q2, r2;
+            divModMag(vector<u64>(x.begin() + (m - t), x.end()), vector<u64>(y.begin() + (m - t), y.end()), q2, r2);
+
+            vector<u64> prod = multiply(q2, y);
+            while (compareMag(prod, x) > 0) {
+                subFrom(q2.data(), int(q2.size()), vector<u64>{ 1 }.data(), 1);
+                prod = subMag(prod, y);
+                trimMag(q2);
+            }
+            q = q2;
+            r = subMag(x, prod);
+            return;
+        }
+
+        Divisor d(y);
+        d.divide(x, q, r);
+    }
+
+    //--- divisor with a cached reciprocal (for repeated divisions)
+
+    struct Divisor {
+        vector<u64> b;          // the divisor shifted left by 'shift' bits (the top bit is set)
+        int shift;
+        vector<u64> inv;        // floor(B^(2m) / b), m = |b|, only if m > DIV_THRESHOLD
+        vector<u64> original;
+
+        Divisor() : shift(0) {
+        }
+
+        explicit Divisor(const vector<u64>& y) {
+            init(y);
+        }
+
+        void init(const vector<u64>& y) {
+            original = y;
+            shift = clz64(y.back());
+            b = shiftLeftBits(y, shift);
+            inv.clear();
+            if (int(b.size()) > DIV_THRESHOLD)
+                inv = reciprocal(b);
+        }
+
+        void divide(const vector<u64>& x, vector<u64>& q, vector<u64>& r) const {
+            if (inv.empty()) {
+                divModKnuth(x, original, q, r);
+                return;
+            }
+
+            vector<u64> xs = shiftLeftBits(x, shift);
+            int m = int(b.size());
+            int n = int(xs.size());
+
+            // (m limbs) blocks from the top, the current remainder < b
+            q.assign(n + 1, 0);
+            vector<u64> cur;
+            int first = n % m;
+            if (first == 0)
+                first = m;
+            for (int pos = n - first; pos >= 0; pos -= m) {
+                int len = (pos + m <= n) ? m : n - pos;
+                vector<u64> block(xs.begin() + pos, xs.begin() + pos + len);
+                block.resize(m, 0);
+                block.insert(block.end(), cur.begin(), cur.end());
+                trimMag(block);
+
+                vector<u64> qb;
+                divide2(block, qb, cur);
+                copy(qb.begin(), qb.end(), q.begin() + pos);
+            }
+            trimMag(q);
+            r = shiftRightBits(cur, shift);
+        }
+
+    private:
+        // x < b * B^m
+        void divide2(const vector<u64>& x, vector<u64>& q, vector<u64>& r) const {
+            int m = int(b.size());
+            if (compareMag(x, b) < 0) {
+                q.clear();
+                r = x;
+                return;
+            }
+
+            // q = floor(floor(x / B^(m-1)) * inv / B^(m+1)), q <= floor(x / b) <= q + 3
+            q = multiply(vector<u64>(x.begin() + (m - 1), x.end()), inv);
+            if (int(q.size()) <= m + 1)
+                q.clear();
+            else
+                q.erase(q.begin(), q.begin() + (m + 1));
+
+            r = subMag(x, multiply(q, b));
+            while (compareMag(r, b) >= 0) {
+                r = subMag(r, b);
+                q = addMag(q, vector<u64>{ 1 });
+            }
+        }
+    };
+
+private:
+    static void trimMag(vector<u64>& x) {
+        while (!x.empty() && x.back() == 0)
+            x.pop_back();
+    }
+
+    static u64 mul64(u64 a, u64 b, u64& hi) {
+#ifdef __GNUC__
+        unsigned __int128 t = (unsigned __int128)a * b;
+        hi = u64(t >> 64);
+        return u64(t);
+#else
+        return _umul128(a, b, &hi);
+#endif
+    }
+
+    static int clz64(u64 x) {
+#ifndef __GNUC__
+        unsigned long idx;
+        _BitScanReverse64(&idx, x);
+        return 63 - int(idx);
+#else
+        return __builtin_clzll(x);
+#endif
+    }
+
+    // r[0..rn) += x[0..xn), xn <= rn, returns the carry
+    static u64 addTo(u64* r, int rn, const u64* x, int xn) {
+        u64 carry = 0;
+        int i = 0;
+        for (; i < xn; i++) {
+            u64 s = r[i] + carry;
+            carry = (s < carry);
+            s += x[i];
+            carry += (s < x[i]);
+            r[i] = s;
+        }
+        for (; carry && i < rn; i++)
+            carry = (++r[i] == 0);
+        return carry;
+    }
+
+    // r[0..rn) -= x[0..xn), xn <= rn, returns the borrow
+    static u64 subFrom(u64* r, int rn, const u64* x, int xn) {
+        u64 borrow = 0;
+        int i = 0;
+        for (; i < xn; i++) {
+            u64 s = r[i] - borrow;
+            borrow = (r[i] < borrow);
+            borrow += (s < x[i]);
+            r[i] = s - x[i];
+        }
+        for (; borrow && i < rn; i++)
+            borrow = (r[i]-- == 0);
+        return borrow;
+    }
+
+    static vector<u64> shiftLeftBits(const vector<u64>& x, int s) {
+        vector<u64> res(x.size() + 1);
+        for (int i = 0; i < int(x.size()); i++) {
+            res[i] |= x[i] << s;
+            if (s)
+                res[i + 1] = x[i] >> (64 - s);
+        }
+        trimMag(res);
+        return res;
+    }
+
+    static vector<u64> shiftRightBits(const vector<u64>& x, int s) {
+        vector<u64> res(x.size());
+        for (int i = 0; i < int(x.size()); i++) {
+            res[i] = x[i] >> s;
+            if (s && i + 1 < int(x.size()))
+                res[i] |= x[i + 1] << (64 - s);
+        }
+        trimMag(res);
+        return res;
+    }
+
+    // x = x * mul + add
+    static void mulAddSmall(vector<u64>& x, u64 mul, u64 add) {
+        u64 carry = add;
+        for (auto& v : x) {
+            u64 hi;
+            u64 lo = mul64(v, mul, hi);
+            lo += carry;
+            hi += (lo < carry);
+            v = lo;
+            carry = hi;
+        }
+        if (carry)
+            x.push_back(carry);
+    }
+
+    // x /= d, returns x % d, d < 2^32
+    static u64 divSmall(vector<u64>& x, u64 d) {
+        u64 rem = 0;
+        for (int i = int(x.size()) - 1; i >= 0; i--) {
+            u64 hi = (rem << 32) | (x[i] >> 32);
+            u64 qh = hi / d;
+            rem = hi % d;
+            u64 lo = (rem << 32) | (x[i] & 0xFFFFFFFFull);
+            u64 ql = lo / d;
+            rem = lo % d;
+            x[i] = (qh << 32) | ql;
+        }
+        trimMag(x);
+        return rem;
+    }
+
+    //--- multiplication
+
+    static void multiplySchool(const u64* x, int xn, const u64* y, int yn, u64* out) {
+        fill(out, out + xn + yn, 0ull);
+        for (int i = 0; i < yn; i++) {
+            u64 carry = 0;
+            u64* o = out + i;
+            for (int j = 0; j < xn; j++) {
+                u64 hi;
+                u64 lo = mul64(x[j], y[i], hi);
+                lo += carry;
+                hi += (lo < carry);
+                o[j] += lo;
+                hi += (o[j] < lo);
+                carry = hi;
+            }
+            o[xn] = carry;
+        }
+    }
+
+    // xn >= 2 * yn : yn-limb blocks of x
+    static void multiplyUnbalanced(const u64* x, int xn, const u64* y, int yn, u64* out) {
+        fill(out, out + xn + yn, 0ull);
+        vector<u64> tmp(2 * yn);
+        for (int i = 0; i < xn; i += yn) {
+            int len = min(yn, xn - i);
+            multiply(x + i, len, y, yn, tmp.data());
+            addTo(out + i, xn + yn - i, tmp.data(), len + yn);
+        }
+    }
+
+    // |x - y| -> out[0..n), returns true if x < y (xn = n >= yn)
+    static bool absDiff(const u64* x, int n, const u64* y, int yn, u64* out) {
+        bool less = false;
+        if (yn == n) {
+            for (int i = n - 1; i >= 0; i--) {
+                if (x[i] != y[i]) {
+                    less = x[i] < y[i];
+                    break;
+                }
+            }
+        } else {
+            bool highZero = true;
+            for (int i = yn; i < n; i++)
+                highZero &= (x[i] == 0);
+            if (highZero) {
+                for (int i = yn - 1; i >= 0; i--) {
+                    if (x[i] != y[i]) {
+                        less = x[i] < y[i];
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (less) {
+            copy(y, y + yn, out);
+            fill(out + yn, out + n, 0ull);
+            subFrom(out, n, x, n);
+        } else {
+            copy(x, x + n, out);
+            subFrom(out, n, y, yn);
+        }
+        return less;
+    }
+
+    // x0 * y1 + x1 * y0 = x0 * y0 + x1 * y1 - (x0 - x1) * (y0 - y1)
+    static void multiplyKaratsuba(const u64* x, int xn, const u64* y, int yn, u64* out) {
+        int h = (xn + 1) / 2;
+        if (yn <= h) {
+            multiplyUnbalanced(x, xn, y, yn, out);
+            return;
+        }
+
+        int x1n = xn - h, y1n = yn - h;
+        vector<u64> dx(h), dy(h), z1(2 * h), mid(2 * h + 1);
+        bool negX = absDiff(x, h, x + h, x1n, dx.data());
+        bool negY = absDiff(y, h, y + h, y1n, dy.data());
+
+        multiply(x, h, y, h, out);
+        multiply(x + h, x1n, y + h, y1n, out + 2 * h);
+        multiply(dx.data(), h, dy.data(), h, z1.data());
+
+        copy(out, out + 2 * h, mid.begin());
+        addTo(mid.data(), 2 * h + 1, out + 2 * h, x1n + y1n);
+        if (negX == negY)
+            subFrom(mid.data(), 2 * h + 1, z1.data(), 2 * h);
+        else
+            addTo(mid.data(), 2 * h + 1, z1.data(), 2 * h);
+
+        int midN = 2 * h + 1;
+        while (midN > 0 && mid[midN - 1] == 0)
+            midN--;
+        addTo(out + h, xn + yn - h, mid.data(), midN);
+    }
+
+    static bigint64 fromRaw(const u64* p, int n) {
+        bigint64 res;
+        if (n > 0)
+            res.a.assign(p, p + n);
+        res.trim();
+        return res;
+    }
+
+    // Bodrato's sequence, points = 0, 1, -1, -2, inf
+    static void multiplyToom3(const u64* x, int xn, const u64* y, int yn, u64* out) {
+        int k = (xn + 2) / 3;
+        if (yn <= k) {
+            multiplyUnbalanced(x, xn, y, yn, out);
+            return;
+        }
+
+        bigint64 x0 = fromRaw(x, k), x1 = fromRaw(x + k, min(k, xn - k)), x2 = fromRaw(x + 2 * k, xn - 2 * k);
+        bigint64 y0 = fromRaw(y, k), y1 = fromRaw(y + k, min(k, yn - k)), y2 = fromRaw(y + 2 * k, yn - 2 * k);
+
+        bigint64 p = x0 + x2;
+        bigint64 xp1 = p + x1, xm1 = p - x1;
+        bigint64 xm2 = xm1 + x2;
+        xm2 = xm2 + xm2 - x0;
+
+        bigint64 q = y0 + y2;
+        bigint64 yp1 = q + y1, ym1 = q - y1;
+        bigint64 ym2 = ym1 + y2;
+        ym2 = ym2 + ym2 - y0;
+
+        bigint64 r0 = x0 * y0;
+        bigint64 r1 = xp1 * yp1;
+        bigint64 rm1 = xm1 * ym1;
+        bigint64 rm2 = xm2 * ym2;
+        bigint64 rInf = x2 * y2;
+
+        bigint64 r3 = rm2 - r1;
+        divSmall(r3.a, 3);
+        r3.trim();
+        r1 = r1 - rm1;
+        r1.a = shiftRightBits(r1.a, 1);
+        r1.trim();
+        bigint64 r2 = rm1 - r0;
+        r3 = r2 - r3;
+        r3.a = shiftRightBits(r3.a, 1);
+        r3.trim();
+        r3 = r3 + rInf + rInf;
+        r2 = r2 + r1 - rInf;
+        r1 = r1 - r3;
+
+        fill(out, out + xn + yn, 0ull);
+        const bigint64* parts[5] = { &r0, &r1, &r2, &r3, &rInf };
+        for (int i = 0; i < 5; i++) {
+            int pos = i * k;
+            if (!parts[i]->isZero())
+                addTo(out + pos, xn + yn - pos, parts[i]->a.data(), int(parts[i]->a.size()));
+        }
+    }
+
+    //--- NTT multiplication (3 primes)
+
+    static const int P1 = 167772161;    // 5 * 2^25 + 1, primitive root = 3
+    static const int P2 = 469762049;    // 7 * 2^26 + 1, primitive root = 3
+    static const int P3 = 754974721;    // 45 * 2^24 + 1, primitive root = 11
+    static const int NTT_MAX_SIZE = 1 << 24;
+
+    static unsigned chunk(const u64* x, int i, int bits) {
+        if (bits == 32)
+            return unsigned(x[i >> 1] >> ((i & 1) << 5));
+        else
+            return unsigned(x[i >> 2] >> ((i & 3) << 4)) & 0xFFFFu;
+    }
+
+    // - 32-bit chunks : coefficients < min(cx, cy) * 2^64 < P1 * P2 * P3 when min(cx, cy) <= 2^21
+    // - 16-bit chunks : otherwise
+    static bool multiplyNTT(const u64* x, int xn, const u64* y, int yn, u64* out) {
+        int bits = 32;
+        long long cx = 2ll * xn, cy = 2ll * yn;
+        if (min(cx, cy) > (1 << 21) || cx + cy - 1 > NTT_MAX_SIZE) {
+            bits = 16;
+            cx = 4ll * xn;
+            cy = 4ll * yn;
+            if (cx + cy - 1 > NTT_MAX_SIZE)
+                return false;
+        }
+
+        int size = 1;
+        while (size < cx + cy - 1)
+            size <<= 1;
+
+        vector<unsigned> r1(size), r2(size), r3(size), tmp(size);
+        multiplyPrime<P1, 3>(x, int(cx), y, int(cy), bits, r1.data(), tmp.data(), size);
+        multiplyPrime<P2, 3>(x, int(cx), y, int(cy), bits, r2.data(), tmp.data(), size);
+        multiplyPrime<P3, 11>(x, int(cx), y, int(cy), bits, r3.data(), tmp.data(), size);
+
+        static const GarnerMod3<P1, P2, P3> g;
+        const u64 m12 = u64(P1) * P2;
+        const u64 mask = (bits == 32) ? 0xFFFFFFFFull : 0xFFFFull;
+        int perLimb = 64 / bits;
+
+        u64 carryLo = 0, carryHi = 0;
+        int outChunks = (xn + yn) * perLimb;
+        for (int i = 0; i < outChunks; i++) {
+            if (i < cx + cy - 1) {
+                long long v1 = ((long long)r2[i] - (long long)r1[i] + P2) % P2 * g.m1InvM2 % P2;
+                long long v2 = (((long long)r3[i] - (long long)r1[i] - 1ll * g.m1ModM3 * v1) % P3 + P3) % P3 * g.m12InvM3 % P3;
+
+                u64 lo = r1[i] + u64(P1) * u64(v1);
+                carryLo += lo;
+                carryHi += (carryLo < lo);
+
+                u64 hi;
+                lo = mul64(m12, u64(v2), hi);
+                carryLo += lo;
+                carryHi += hi + (carryLo < lo);
+            }
+            u64 c = carryLo & mask;
+            carryLo = (carryLo >> bits) | (carryHi << (64 - bits));
+            carryHi >>= bits;
+
+            int limb = i / perLimb, shift = (i % perLimb) * bits;
+            if (shift == 0)
+                out[limb] = c;
+            else
+                out[limb] |= c << shift;
+        }
+        return true;
+    }
+
+    // out[i] = (x * y)[i] mod p (chunk polynomials), tmp : scratch
+    template <int p, int g>
+    static void multiplyPrime(const u64* x, int cx, const u64* y, int cy, int bits, unsigned* out, unsigned* tmp, int size) {
+        typedef AVX2NTT<p, g> NTTp;
+        NTTp::Base::prepare(size);
+
+        for (int i = 0; i < size; i++)
+            out[i] = (i < cx) ? chunk(x, i, bits) % unsigned(p) : 0u;
+        NTTp::ntt(out, size);
+
+        if (x == y && cx == cy) {
+            NTTp::multiplyPointwise(out, out, out, size);
+        } else {
+            for (int i = 0; i < size; i++)
+                tmp[i] = (i < cy) ? chunk(y, i, bits) % unsigned(p) : 0u;
+            NTTp::ntt(tmp, size);
+            NTTp::multiplyPointwise(out, tmp, out, size);
+        }
+
+        NTTp::nttInv(out, size);
+        for (int i = 0; i < size; i++)
+            out[i] = NTTp::Base::normalize(out[i]);
+    }
+
+    //--- division
+
+    // base 2^32, Knuth's algorithm D (Hacker's Delight, divmnu64)
+    static void divModKnuth(const vector<u64>& x, const vector<u64>& y, vector<u64>& q, vector<u64>& r) {
+        vector<unsigned> u = toU32(x), v = toU32(y);
+        int m = int(u.size()), n = int(v.size());
+        if (m < n) {
+            q.clear();
+            r = x;
+            return;
+        }
+
+        vector<unsigned> qq(m - n + 1), rr(n);
+        if (n == 1) {
+            u64 rem = 0;
+            for (int j = m - 1; j >= 0; j--) {
+                u64 cur = (rem << 32) | u[j];
+                qq[j] = unsigned(cur / v[0]);
+                rem = cur % v[0];
+            }
+            rr[0] = unsigned(rem);
+        } else {
+            int s = clz64(v[n - 1]) - 32;
+            vector<unsigned> vn(n), un(m + 1);
+            for (int i = n - 1; i > 0; i--)
+                vn[i] = unsigned((u64(v[i]) << s) | (u64(v[i - 1]) >> (32 - s)));
+            vn[0] = v[0] << s;
+            un[m] = unsigned(u64(u[m - 1]) >> (32 - s));
+            for (int i = m - 1; i > 0; i--)
+                un[i] = unsigned((u64(u[i]) << s) | (u64(u[i - 1]) >> (32 - s)));
+            un[0] = u[0] << s;
+
+            const u64 b = 1ull << 32;
+            for (int j = m - n; j >= 0; j--) {
+                u64 num = (u64(un[j + n]) << 32) | un[j + n - 1];
+                u64 qhat = num / vn[n - 1];
+                u64 rhat = num - qhat * vn[n - 1];
+                while (qhat >= b || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                    qhat--;
+                    rhat += vn[n - 1];
+                    if (rhat >= b)
+                        break;
+                }
+
+                long long k = 0, t;
+                for (int i = 0; i < n; i++) {
+                    u64 prod = qhat * vn[i];
+                    t = (long long)un[i + j] - k - (long long)(prod & 0xFFFFFFFFull);
+                    un[i + j] = unsigned(t);
+                    k = (long long)(prod >> 32) - (t >> 32);
+                }
+                t = (long long)un[j + n] - k;
+                un[j + n] = unsigned(t);
+
+                qq[j] = unsigned(qhat);
+                if (t < 0) {
+                    qq[j]--;
+                    u64 c = 0;
+                    for (int i = 0; i < n; i++) {
+                        u64 s2 = u64(un[i + j]) + vn[i] + c;
+                        un[i + j] = unsigned(s2);
+                        c = s2 >> 32;
+                    }
+                    un[j + n] = unsigned(un[j + n] + c);
+                }
+            }
+            for (int i = 0; i < n; i++)
+                rr[i] = unsigned((u64(un[i]) >> s) | (u64(un[i + 1]) << (32 - s)));
+        }
+
+        q = fromU32(qq);
+        r = fromU32(rr);
+    }
+
+    static vector<unsigned> toU32(const vector<u64>& x) {
+        vector<unsigned> res(x.size() * 2);
+        for (int i = 0; i < int(x.size()); i++) {
+            res[2 * i] = unsigned(x[i]);
+            res[2 * i + 1] = unsigned(x[i] >> 32);
+        }
+        while (!res.empty() && res.back() == 0)
+            res.pop_back();
+        return res;
+    }
+
+    static vector<u64> fromU32(const vector<unsigned>& x) {
+        vector<u64> res((x.size() + 1) / 2);
+        for (int i = 0; i < int(x.size()); i++)
+            res[i >> 1] |= u64(x[i]) << ((i & 1) << 5);
+        trimMag(res);
+        return res;
+    }
+
+    // floor(B^(2m) / x), m = |x|, the top bit of x is set
+    // - Newton's iteration z' = z + z * (B^(2m) - x * z) / B^(2m) from the reciprocal of the top limbs
+    static vector<u64> reciprocal(const vector<u64>& x) {
+        int m = int(x.size());
+        vector<u64> pw(2 * m + 1);
+        pw[2 * m] = 1;
+
+        if (m <= DIV_THRESHOLD) {
+            vector<u64> q, r;
+            divModKnuth(pw, x, q, r);
+            return q;
+        }
+
+        int k = (m + 1) / 2 + 1;
+        vector<u64> zt = reciprocal(vector<u64>(x.end() - k, x.end()));
+
+        bigint64 X, Z, P;
+        X.a = x;
+        P.a = pw;
+        Z.a.assign(m - k, 0);
+        Z.a.insert(Z.a.end(), zt.begin(), zt.end());
+
+        bigint64 e = P - X * Z;
+        bigint64 ze = Z * e;
+        if (int(ze.a.size()) > 2 * m) {
+            ze.a.erase(ze.a.begin(), ze.a.begin() + 2 * m);
+            Z += ze;
+        }
+
+        // exact floor
+        bigint64 r = P - X * Z;
+        bigint64 one(1);
+        while (r.sign < 0) {
+            Z -= one;
+            r += X;
+        }
+        while (r >= X) {
+            Z += one;
+            r -= X;
+        }
+        return Z.a;
+    }
+
+    //--- decimal conversion (base 10^9 words)
+
+    // 10^(9 * 2^i)
+    static const vector<u64>& powerOf1e9(int i) {
+        static vector<vector<u64>> pw;
+        while (int(pw.size()) <= i) {
+            if (pw.empty())
+                pw.push_back(vector<u64>{ 1000000000ull });
+            else
+                pw.push_back(multiply(pw.back(), pw.back()));
+        }
+        return pw[i];
+    }
+
+    // 10^(9 * 2^i) with its reciprocal (built on first use)
+    static const Divisor& divisorOf1e9(int i) {
+        static vector<Divisor> divisors;
+        if (int(divisors.size()) <= i)
+            divisors.resize(i + 1);
+        if (divisors[i].original.empty())
+            divisors[i].init(powerOf1e9(i));
+        return divisors[i];
+    }
+
+    static vector<u64> fromBase1e9(const vector<int>& words) {
+        int n = int(words.size());
+        if (n == 0)
+            return vector<u64>();
+
+        int level = 0;
+        while ((1 << level) < n)
+            level++;
+        vector<u64> res = fromBase1e9(words.data(), n, level);
+        trimMag(res);
+        return res;
+    }
+
+    // n <= 2^level words
+    static vector<u64> fromBase1e9(const int* words, int n, int level) {
+        if (n <= DECIMAL_THRESHOLD * 2) {
+            vector<u64> res;
+            for (int i = n - 1; i >= 0; i--)
+                mulAddSmall(res, 1000000000ull, u64(words[i]));
+            trimMag(res);
+            return res;
+        }
+
+        int half = 1 << (level - 1);
+        if (n <= half)
+            return fromBase1e9(words, n, level - 1);
+
+        vector<u64> lo = fromBase1e9(words, half, level - 1);
+        vector<u64> hi = fromBase1e9(words + half, n - half, level - 1);
+        vector<u64> res = multiply(hi, powerOf1e9(level - 1));
+        if (res.size() < lo.size())
+            res.resize(lo.size());
+        res.push_back(0);
+        addTo(res.data(), int(res.size()), lo.data(), int(lo.size()));
+        trimMag(res);
+        return res;
+    }
+
+    static vector<int> toBase1e9(const vector<u64>& x) {
+        if (x.empty())
+            return vector<int>();
+
+        // x < 10^(9 * 2^level)
+        int level = 0;
+        while (compareMag(x, powerOf1e9(level)) >= 0)
+            level++;
+
+        vector<int> res(size_t(1) << level);
+        toBase1e9(x, level, res.data());
+        while (!res.empty() && res.back() == 0)
+            res.pop_back();
+        return res;
+    }
+
+    // x < 10^(9 * 2^level), out[0..2^level)
+    static void toBase1e9(const vector<u64>& x, int level, int* out) {
+        int n = 1 << level;
+        if (int(x.size()) <= DECIMAL_THRESHOLD) {
+            vector<u64> t(x);
+            for (int i = 0; i < n; i++)
+                out[i] = t.empty() ? 0 : int(divSmall(t, 1000000000ull));
+            return;
+        }
+
+        vector<u64> q, r;
+        divisorOf1e9(level - 1).divide(x, q, r);
+        toBase1e9(r, level - 1, out);
+        toBase1e9(q, level - 1, out + n / 2);
+    }
+};
+
+inline istream& operator >>(istream& is, bigint64& v) {
+    string s;
+    is >> s;
+    v = s;
+    return is;
+}
+
+inline ostream& operator <<(ostream& os, const bigint64& v) {
+    os << v.toString();
+    return os;
+}
@@ -112,4 +112,82 @@ void testDiscreteLog() {
         }
     }
     cout << "OK!" << endl;
+    {
+        // all (a, b) for small odd moduli
+        for (int m : { 1, 3, 9, 15, 343, 1001, 1024 + 1, 3 * 3 * 5 * 7 * 11 }) {
+            for (int a = 1; a < m || a == 1; a++) {
+                if (gcd(a, m) != 1)
+                    continue;
+                vector<int> gt(m, -1);
+                long long x = 1 % m;
+                for (int e = 0; e < m; e++) {
+                    if (gt[x] < 0)
+                        gt[x] = e;
+                    x = x * a % m;
+                }
+                for (unsigned long long q : { 1ull, 10ull, 1000000ull }) {
+                    DiscreteLogContext ctx(a, m, q);
+                    for (int b = 0; b < m; b++)
+                        assert(ctx.solve(b) == gt[b]);
+                }
+            }
+        }
+    }
+    {
+        // 64-bit moduli, batched queries
+        for (unsigned long long M : { 1000000007ull, 4294967291ull, 1000000000039ull, 100000015277ull * 3 }) {
+            Montgomery64 mont(M);
+            unsigned long long a = 5;
+            vector<unsigned long long> b;
+            for (int i = 0; i < 100; i++)
+                b.push_back(mont.fromMontgomery(mont.pow(mont.toMontgomery(a), (unsigned long long)RandInt64::get() % M)));
+            b.push_back(M + 1);
+            b.push_back(0);
+
+            DiscreteLogContext ctx(a, M, b.size());
+            for (int threadN : { 1, 3 }) {
+                auto ans = ctx.solve(b, threadN);
+                for (int i = 0; i < int(b.size()); i++) {
+                    if (ans[i] < 0) {
+                        assert(b[i] % M == 0);
+                        continue;
+                    }
+                    assert(mont.fromMontgomery(mont.pow(mont.toMontgomery(a), ans[i])) == b[i] % M);
+                }
+            }
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        int Q = 2000;
+        int a = 5;
+        vector<int> x(Q);
+        vector<unsigned long long> b(Q);
+        for (int i = 0; i < Q; i++) {
+            x[i] = RandInt32::get() % (MOD - 1);
+            b[i] = modPow(a, x[i], MOD);
+        }
+
+        cout << "FastDiscreteLog, " << Q << " queries : ";
+        FastDiscreteLog dsc;
+        vector<int> ans1(Q);
+        PROFILE_HI_START(0);
+        for (int i = 0; i < Q; i++)
+            ans1[i] = dsc.solve(a, int(b[i]), MOD);
+        PROFILE_HI_STOP(0);
+
+        for (unsigned long long expected : { 1ull, (unsigned long long)Q }) {
+            cout << "DiscreteLogContext (expected queries = " << expected << "), " << Q << " queries : ";
+            PROFILE_HI_START(1);
+            DiscreteLogContext ctx(a, MOD, expected);
+            auto ans2 = ctx.solve(b);
+            PROFILE_HI_STOP(1);
+            for (int i = 0; i < Q; i++) {
+                assert(ans2[i] == x[i]);
+                assert(modPow(a, ans1[i], MOD) == int(b[i]));
+            }
+        }
+    }
 }
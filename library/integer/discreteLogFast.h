@@ -1,5 +1,9 @@
 #pragma once
 
+#include <xmmintrin.h>
+#include "montgomery64.h"
+#include "../common/parallel.h"
+
 // from https://blog.csdn.net/Fallen_Breath/article/details/52758419
 /*
 https://www.spoj.com/problems/MOD/
@@ -108,3 +112,181 @@ private:
         return -1;
     }
 };
+
+
+/*
+  Baby-step giant-step for many queries with the same base and modulus
+
+    a^x = b (mod m), gcd(a, m) = 1, m is odd, m < 2^63
+
+  - the baby steps a^j (0 <= j < T) are built once into an open-addressing (linear probing) table
+    . 8-byte slots (32-bit key fingerprint, j), the load factor is at most 1/2
+    . T = sqrt(m * expectedQueries), at most MAX_TABLE_SIZE baby steps (a 32 MB table, larger than the cache,
+      lookups miss and rely on the prefetches of solve(vector); a cache-sized table costs more giant steps)
+  - a query walks b * a^(-T*i) with Montgomery multiplication, O(m / T) steps
+  - solve(vector) walks LANES queries at the same time and prefetches the next slot of each,
+    the groups are shared by threads
+
+  <How to use>
+    DiscreteLogContext ctx(5, 1'000'000'007, 100000);   // base, modulus, the expected number of queries
+    long long x = ctx.solve(b);                         // the smallest x, or -1
+    vector<long long> xs = ctx.solve(bs, 4);            // 4 threads
+*/
+struct DiscreteLogContext {
+    typedef unsigned int u32;
+    typedef unsigned long long u64;
+
+    static const int LANES = 8;
+    static const u64 MAX_TABLE_SIZE = 1ull << 21;      // baby steps, 2^22 slots x 8 bytes = 32 MB
+
+    u64 m = 0;
+    u64 step = 0;               // T, the number of baby steps
+    u64 giantN = 0;             // the number of giant steps
+    u64 order = 0;              // the order of a if it's at most T, or 0
+
+    DiscreteLogContext() {
+    }
+
+    DiscreteLogContext(u64 a, u64 m, u64 expectedQueries = 1) {
+        build(a, m, expectedQueries);
+    }
+
+    // O(T)
+    void build(u64 a, u64 m, u64 expectedQueries = 1) {
+        this->m = m;
+        if (m == 1) {
+            step = giantN = order = 1;
+            return;
+        }
+
+        mont.init(m);
+        aMont = mont.toMontgomery(a);
+
+        double t = sqrt(double(m) * double(max<u64>(1, expectedQueries)));
+        step = max<u64>(1, min(min(u64(t), m), u64(MAX_TABLE_SIZE)));
+        bits = 1;
+        while ((1ull << bits) < 2 * step)
+            bits++;
+        table.assign(size_t(1) << bits, Slot{ 0, EMPTY });
+        exactKey = (m >> 32) == 0;
+
+        order = 0;
+        u64 x = mont.r1;
+        for (u64 j = 0; j < step; j++) {
+            if (j > 0 && x == mont.r1) {
+                order = j;
+                break;
+            }
+            insert(x, u32(j));
+            x = mont.mul(x, aMont);
+        }
+
+        if (order) {
+            step = order;
+            giantN = 1;
+        } else {
+            giantN = (m + step - 1) / step;
+            giant = mont.toMontgomery(modInverse(mont.fromMontgomery(x), m));    // a^-T
+        }
+    }
+
+    // the smallest x with a^x = b (mod m), or -1, O(m / T)
+    long long solve(u64 b) const {
+        long long res;
+        solveGroup(&b, 1, &res);
+        return res;
+    }
+
+    // threadN = 0 : all hardware threads
+    vector<long long> solve(const vector<u64>& b, int threadN = 1) const {
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        int n = int(b.size());
+        vector<long long> res(n);
+        Parallel::forEach((n + LANES - 1) / LANES, threadN, [&](int group) {
+            int first = group * LANES;
+            solveGroup(b.data() + first, min(int(LANES), n - first), res.data() + first);
+        });
+        return res;
+    }
+
+private:
+    struct Slot {
+        u32 key;            // the low 32 bits of a^j in Montgomery form
+        u32 j;
+    };
+
+    static const u32 EMPTY = ~0u;
+
+    Montgomery64 mont;
+    u64 aMont = 0;
+    u64 giant = 0;          // a^-T in Montgomery form
+    int bits = 0;
+    bool exactKey = false;  // m < 2^32, a key is the whole value
+    vector<Slot> table;
+
+    size_t slotOf(u64 x) const {
+        return size_t((x * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+    }
+
+    void insert(u64 x, u32 j) {
+        size_t mask = table.size() - 1;
+        size_t h = slotOf(x);
+        while (table[h].j != EMPTY)
+            h = (h + 1) & mask;
+        table[h] = Slot{ u32(x), j };
+    }
+
+    // j with a^j = x, or -1
+    long long find(u64 x) const {
+        size_t mask = table.size() - 1;
+        for (size_t h = slotOf(x); table[h].j != EMPTY; h = (h + 1) & mask) {
+            if (table[h].key == u32(x) && (exactKey || mont.pow(aMont, table[h].j) == x))
+                return table[h].j;
+        }
+        return -1;
+    }
+
+    void solveGroup(const u64* b, int n, long long* out) const {
+        if (m == 1) {
+            for (int k = 0; k < n; k++)
+                out[k] = 0;
+            return;
+        }
+
+        u64 g[LANES];
+        int active[LANES], activeN = n;
+        for (int k = 0; k < n; k++) {
+            g[k] = mont.toMontgomery(b[k] % m);
+            out[k] = -1;
+            active[k] = k;
+        }
+
+        for (u64 i = 0; i < giantN && activeN > 0; i++) {
+            for (int t = 0; t < activeN; ) {
+                int k = active[t];
+                long long j = find(g[k]);
+                if (j >= 0) {
+                    out[k] = (long long)(i * step + j);
+                    active[t] = active[--activeN];
+                    continue;
+                }
+                g[k] = mont.mul(g[k], giant);
+                _mm_prefetch(reinterpret_cast<const char*>(&table[slotOf(g[k])]), _MM_HINT_T0);
+                t++;
+            }
+        }
+    }
+
+    // x^-1 mod m, gcd(x, m) = 1
+    static u64 modInverse(u64 x, u64 m) {
+        long long a = (long long)x, b = (long long)m, u = 1, v = 0;
+        while (b) {
+            long long q = a / b;
+            swap(a -= q * b, b);
+            swap(u -= q * v, v);
+        }
+        return u64(u < 0 ? u + (long long)m : u);
+    }
+};
@@ -0,0 +1,422 @@
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+#include "fastModInt.h"
+#include "fastModOp.h"
+#include "../polynomial/modInt.h"
+#include "../math/matrixMod.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+static long long modPowSlow(long long x, long long n, int mod) {
+    long long res = 1 % mod;
+    x %= mod;
+    for (; n > 0; n >>= 1) {
+        if (n & 1)
+            res = res * x % mod;
+        x = x * x % mod;
+    }
+    return res;
+}
+
+template <typename MInt>
+static void checkModInt(bool prime) {
+    const int mod = MInt::mod_value;
+
+    for (int i = 0; i < 100000; i++) {
+        long long a = RandInt64::get() % (3ll * mod) - mod;
+        long long b = RandInt32::get() % mod;
+        long long na = (a % mod + mod) % mod;
+
+        MInt x = a, y = b;
+        assert(x.get() == na);
+        assert((x + y).get() == (na + b) % mod);
+        assert((x - y).get() == (na - b + mod) % mod);
+        assert((-x).get() == (mod - na) % mod);
+        assert((x * y).get() == na * b % mod);
+        assert(x.pow(i).get() == modPowSlow(na, i, mod));
+        if (prime && b != 0) {
+            assert((y * y.inverse()).get() == 1);
+            assert((x / y * y).get() == na);
+        }
+    }
+    // boundary values
+    for (long long a : { 0ll, 1ll, mod - 1ll, mod - 2ll }) {
+        for (long long b : { 0ll, 1ll, mod - 1ll, mod - 2ll }) {
+            assert((MInt(a) * MInt(b)).get() == a * b % mod);
+            assert((MInt(a) + MInt(b)).get() == (a + b) % mod);
+            assert((MInt(a) - MInt(b)).get() == (a - b + mod) % mod);
+        }
+    }
+}
+
+template <typename MInt>
+static void checkKernels() {
+    const int mod = MInt::mod_value;
+
+    for (int n = 0; n < 40; n++) {
+        vector<int> a(n), b(n);
+        for (int i = 0; i < n; i++) {
+            a[i] = RandInt32::get() % mod;
+            b[i] = (i & 3) ? RandInt32::get() % mod : mod - 1;
+        }
+
+        vector<MInt> A(n), B(n), C(n);
+        MInt::fromInt(A.data(), a.data(), n);
+        MInt::fromInt(B.data(), b.data(), n);
+        for (int i = 0; i < n; i++)
+            assert(A[i] == MInt(a[i]));
+
+        vector<int> out(n);
+        MInt::multiply(C.data(), A.data(), B.data(), n);
+        MInt::toInt(out.data(), C.data(), n);
+        for (int i = 0; i < n; i++)
+            assert(out[i] == 1ll * a[i] * b[i] % mod);
+
+        MInt::add(C.data(), A.data(), B.data(), n);
+        MInt::toInt(out.data(), C.data(), n);
+        for (int i = 0; i < n; i++)
+            assert(out[i] == (1ll * a[i] + b[i]) % mod);
+
+        long long dot = 0;
+        for (int i = 0; i < n; i++)
+            dot = (dot + 1ll * a[i] * b[i]) % mod;
+        assert(MInt::dot(A.data(), B.data(), n).get() == dot);
+
+        MInt::prefixProduct(C.data(), A.data(), n);
+        long long prod = 1;
+        for (int i = 0; i < n; i++) {
+            prod = prod * a[i] % mod;
+            assert(C[i].get() == prod);
+        }
+    }
+
+    for (int n : { 1023, 1024, 1027, 5000 }) {
+        vector<MInt> A(n), C(n);
+        for (int i = 0; i < n; i++)
+            A[i] = RandInt32::get() % (mod - 1) + 1;
+
+        MInt::prefixProduct(C.data(), A.data(), n);
+        MInt x = 1;
+        for (int i = 0; i < n; i++) {
+            x *= A[i];
+            assert(C[i] == x);
+        }
+        MInt::prefixProduct(A.data(), A.data(), n);
+        assert(A == C);
+
+        MInt::multiply(C.data(), A.data(), x, n);
+        for (int i = 0; i < n; i++)
+            assert(C[i] == A[i] * x);
+    }
+    // the largest values in a long dot product
+    {
+        int n = 1 << 20;
+        vector<MInt> A(n, MInt(mod - 1)), B(n, MInt(mod - 1));
+        assert(MInt::dot(A.data(), B.data(), n).get() == n % mod);
+    }
+}
+
+// the previous implementations, for the speed test
+template <int mod>
+static void buildFactorialOld(int maxN, vector<int>& factorial, vector<int>& factInverse, vector<int>& inverse) {
+    factorial.resize(maxN + 1);
+    factInverse.resize(maxN + 1);
+    inverse.resize(maxN + 1);
+
+    inverse[0] = 0;
+    inverse[1] = 1;
+    for (int i = 2; i <= maxN; i++)
+        inverse[i] = int((mod - 1ll * (mod / i) * inverse[mod % i] % mod) % mod);
+
+    factorial[0] = 1;
+    factInverse[0] = 1;
+    factorial[1] = 1;
+    factInverse[1] = 1;
+    for (int i = 2; i <= maxN; i++) {
+        factorial[i] = int(1ll * factorial[i - 1] * i % mod);
+        factInverse[i] = int(1ll * factInverse[i - 1] * inverse[i] % mod);
+    }
+}
+
+template <int mod>
+static void multiplyMatrixOld(MatrixMod<mod>& out, const MatrixMod<mod>& left, const MatrixMod<mod>& right) {
+    int N = left.N;
+    for (int r = 0; r < N; r++) {
+        for (int c = 0; c < N; c++) {
+            long long x = 0;
+            for (int k = 0; k < N; k++)
+                x = (x + 1ll * left[r][k] * right[k][c]) % mod;
+            out[r][c] = static_cast<int>(x);
+        }
+    }
+}
+
+#define MOD     1000000007
+
+template <typename T>
+static int benchMulChain(const vector<T>& a) {
+    T x = a[0];
+    for (int i = 0; i < int(a.size()); i++)
+        x *= a[i];
+    return int(x);
+}
+
+template <typename T>
+static int benchAdd(const vector<T>& a) {
+    T x = a[0];
+    for (int i = 0; i < int(a.size()); i++)
+        x += a[i];
+    return int(x);
+}
+
+template <typename T>
+static int benchPow(const vector<T>& a, int n) {
+    T x = a[0];
+    for (int i = 0; i < n; i++)
+        x += a[i].pow(MOD - 3);
+    return int(x);
+}
+
+template <typename T>
+static int benchInverse(const vector<T>& a, int n) {
+    T x = a[0];
+    for (int i = 0; i < n; i++)
+        x += a[i].inverse();
+    return int(x);
+}
+
+void testFastModInt() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Montgomery / Barrett ModInt -------------------------" << endl;
+    {
+        checkModInt<MontgomeryModInt<1000000007>>(true);
+        checkModInt<MontgomeryModInt<998244353>>(true);
+        checkModInt<MontgomeryModInt<1000000009>>(true);
+        checkModInt<MontgomeryModInt<(1 << 30) - 35>>(true);
+        checkModInt<MontgomeryModInt<3>>(true);
+        checkModInt<MontgomeryModInt<999999999>>(false);
+        checkModInt<BarrettModInt<1000000007>>(true);
+        checkModInt<BarrettModInt<1000000000>>(false);
+        checkModInt<BarrettModInt<(1 << 30) - 1>>(false);
+        checkModInt<BarrettModInt<1 << 20>>(false);
+        checkModInt<BarrettModInt<2>>(true);
+        checkModInt<BarrettModInt<1>>(false);
+
+        checkKernels<MontgomeryModInt<1000000007>>();
+        checkKernels<MontgomeryModInt<(1 << 30) - 35>>();
+        checkKernels<MontgomeryModInt<3>>();
+        checkKernels<BarrettModInt<1000000007>>();
+        checkKernels<BarrettModInt<(1 << 30) - 1>>();
+    }
+    {
+        static_assert(MontgomeryModInt<MOD>::R1 == (1ull << 32) % MOD, "compile-time constant");
+        static_assert(unsigned(MontgomeryModInt<MOD>::NEG_INV * unsigned(MOD)) == ~0u, "compile-time constant");
+
+        for (int n : { 1, 2, 10, 1000, 100000 }) {
+            FastModOp<MOD> op(n);
+            vector<int> f, fi, inv;
+            buildFactorialOld<MOD>(n, f, fi, inv);
+            assert(op.factorial == f);
+            assert(op.factInverse == fi);
+            assert(op.inverse == inv);
+        }
+    }
+    {
+        for (int N : { 1, 2, 7, 8, 9, 33 }) {
+            MatrixMod<MOD> A(N), B(N), C(N), gt(N);
+            for (int i = 0; i < N; i++) {
+                for (int j = 0; j < N; j++) {
+                    A[i][j] = RandInt32::get() % MOD;
+                    B[i][j] = (i == j) ? MOD - 1 : RandInt32::get() % MOD;
+                }
+            }
+            MatrixMod<MOD>::multiply(C, A, B);
+            multiplyMatrixOld(gt, A, B);
+            assert(C == gt);
+
+            auto D = A * 12345;
+            D /= 12345;
+            assert(D == A);
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        int T = 30000000;
+        vector<int> in(T);
+        for (int i = 0; i < T; i++)
+            in[i] = RandInt32::get() % (MOD - 1) + 1;
+
+        vector<ModInt<int, MOD>> a1(in.begin(), in.end());
+        vector<ModInt<long long, MOD>> a2(in.begin(), in.end());
+        vector<MontgomeryModInt<MOD>> a3(in.begin(), in.end());
+        vector<BarrettModInt<MOD>> a4(in.begin(), in.end());
+
+        int ans;
+        cout << "mul (dependent chain), ModInt<int> : ";
+        PROFILE_HI_START(0);
+        ans = benchMulChain(a1);
+        PROFILE_HI_STOP(0);
+        cout << "mul (dependent chain), ModInt<long long> : ";
+        PROFILE_HI_START(1);
+        assert(benchMulChain(a2) == ans);
+        PROFILE_HI_STOP(1);
+        cout << "mul (dependent chain), MontgomeryModInt : ";
+        PROFILE_HI_START(2);
+        assert(benchMulChain(a3) == ans);
+        PROFILE_HI_STOP(2);
+        cout << "mul (dependent chain), BarrettModInt : ";
+        PROFILE_HI_START(3);
+        assert(benchMulChain(a4) == ans);
+        PROFILE_HI_STOP(3);
+
+        cout << "add, ModInt<int> : ";
+        PROFILE_HI_START(4);
+        ans = benchAdd(a1);
+        PROFILE_HI_STOP(4);
+        cout << "add, MontgomeryModInt : ";
+        PROFILE_HI_START(5);
+        assert(benchAdd(a3) == ans);
+        PROFILE_HI_STOP(5);
+        cout << "add, BarrettModInt : ";
+        PROFILE_HI_START(6);
+        assert(benchAdd(a4) == ans);
+        PROFILE_HI_STOP(6);
+
+        int P = 1000000;
+        cout << "pow, ModInt<int> : ";
+        PROFILE_HI_START(7);
+        ans = benchPow(a1, P);
+        PROFILE_HI_STOP(7);
+        cout << "pow, MontgomeryModInt : ";
+        PROFILE_HI_START(8);
+        assert(benchPow(a3, P) == ans);
+        PROFILE_HI_STOP(8);
+        cout << "pow, BarrettModInt : ";
+        PROFILE_HI_START(9);
+        assert(benchPow(a4, P) == ans);
+        PROFILE_HI_STOP(9);
+
+        cout << "inverse, ModInt<int> : ";
+        PROFILE_HI_START(10);
+        ans = benchInverse(a1, P);
+        PROFILE_HI_STOP(10);
+        cout << "inverse, MontgomeryModInt : ";
+        PROFILE_HI_START(11);
+        assert(benchInverse(a3, P) == ans);
+        PROFILE_HI_STOP(11);
+        cout << "inverse, BarrettModInt (extended Euclid) : ";
+        PROFILE_HI_START(12);
+        assert(benchInverse(a4, P) == ans);
+        PROFILE_HI_STOP(12);
+
+        //--- bulk kernels
+        typedef MontgomeryModInt<MOD> MInt;
+        vector<int> b(in.rbegin(), in.rend());
+        vector<int> out1(T), out2(T);
+        vector<MInt> A(a3), B(T), C(T);
+        MInt::fromInt(B.data(), b.data(), T);
+
+        cout << "elementwise mul, % : ";
+        PROFILE_HI_START(13);
+        for (int i = 0; i < T; i++)
+            out1[i] = int(1ll * in[i] * b[i] % MOD);
+        PROFILE_HI_STOP(13);
+        cout << "elementwise mul, MontgomeryModInt::multiply : ";
+        PROFILE_HI_START(14);
+        MInt::multiply(C.data(), A.data(), B.data(), T);
+        PROFILE_HI_STOP(14);
+        MInt::toInt(out2.data(), C.data(), T);
+        assert(out1 == out2);
+
+        cout << "elementwise add, branch : ";
+        PROFILE_HI_START(15);
+        for (int i = 0; i < T; i++) {
+            int x = in[i] + b[i];
+            out1[i] = (x >= MOD) ? x - MOD : x;
+        }
+        PROFILE_HI_STOP(15);
+        cout << "elementwise add, MontgomeryModInt::add : ";
+        PROFILE_HI_START(16);
+        MInt::add(C.data(), A.data(), B.data(), T);
+        PROFILE_HI_STOP(16);
+        MInt::toInt(out2.data(), C.data(), T);
+        assert(out1 == out2);
+
+        cout << "dot product, % : ";
+        long long dot = 0;
+        PROFILE_HI_START(17);
+        for (int i = 0; i < T; i++)
+            dot = (dot + 1ll * in[i] * b[i]) % MOD;
+        PROFILE_HI_STOP(17);
+        cout << "dot product, MontgomeryModInt::dot : ";
+        PROFILE_HI_START(18);
+        auto dot2 = MInt::dot(A.data(), B.data(), T);
+        PROFILE_HI_STOP(18);
+        assert(dot2.get() == dot);
+
+        cout << "prefix product, % : ";
+        PROFILE_HI_START(19);
+        long long prod = 1;
+        for (int i = 0; i < T; i++)
+            out1[i] = int(prod = prod * in[i] % MOD);
+        PROFILE_HI_STOP(19);
+        cout << "prefix product, MontgomeryModInt::prefixProduct : ";
+        PROFILE_HI_START(20);
+        MInt::prefixProduct(C.data(), A.data(), T);
+        PROFILE_HI_STOP(20);
+        MInt::toInt(out2.data(), C.data(), T);
+        assert(out1 == out2);
+    }
+    {
+        int N = 10000000;
+        vector<int> f, fi, inv;
+        cout << "factorial tables, old : ";
+        PROFILE_HI_START(0);
+        buildFactorialOld<MOD>(N, f, fi, inv);
+        PROFILE_HI_STOP(0);
+
+        cout << "factorial tables, FastModOp::build : ";
+        FastModOp<MOD> op;
+        PROFILE_HI_START(1);
+        op.build(N);
+        PROFILE_HI_STOP(1);
+        assert(op.factorial == f && op.factInverse == fi && op.inverse == inv);
+    }
+    {
+        int N = 300;
+        MatrixMod<MOD> A(N), B(N), C(N), D(N);
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                A[i][j] = RandInt32::get() % MOD;
+                B[i][j] = RandInt32::get() % MOD;
+            }
+        }
+        cout << "matrix multiplication (N = 300), old : ";
+        PROFILE_HI_START(0);
+        multiplyMatrixOld(C, A, B);
+        PROFILE_HI_STOP(0);
+
+        cout << "matrix multiplication (N = 300), MatrixMod::multiply : ";
+        PROFILE_HI_START(1);
+        MatrixMod<MOD>::multiply(D, A, B);
+        PROFILE_HI_STOP(1);
+        assert(C == D);
+    }
+}
@@ -0,0 +1,526 @@
+#pragma once
+
+#ifndef __GNUC__
+#include <intrin.h>
+#endif
+#include "../common/cpuFeature.h"
+
+/*
+  Modular integers with a compile-time modulus and no division in the hot operations
+
+  1) MontgomeryModInt<mod> : odd mod < 2^30, values are kept in Montgomery form (x * 2^32 mod mod)
+  2) BarrettModInt<mod>    : any mod < 2^30, values are kept in normal form, products are reduced with a
+                             precomputed 2^64 / mod
+
+  - the reduction constants are computed at compile time (constexpr)
+  - add, sub and mul have no data-dependent branches (a conditional subtraction is a signed compare + cmov)
+  - pow() runs square-and-multiply with a conditional move, inverse() is x^(mod - 2) for MontgomeryModInt
+    (mod must be a prime number) and the extended Euclidean algorithm for BarrettModInt
+  - bulk kernels over (pointer, size) arrays : multiply, add, dot, prefixProduct, fromInt, toInt
+    . prefixProduct() runs 4 independent chains (the latency of a multiplication is hidden) and fixes them up
+    . MontgomeryModInt : 8 lanes per AVX2 vector, selected at runtime (CpuFeature::hasAVX2()), with a scalar fallback
+    . dot() reduces lazily, each product is reduced once and the sum only at the end
+
+  <How to use>
+    typedef MontgomeryModInt<1'000'000'007> MInt;
+    MInt a = 3, b = -1;
+    int x = (a * b + a.pow(10) / b).get();
+
+    vector<MInt> A(n), B(n), C(n);
+    MInt::multiply(C.data(), A.data(), B.data(), n);
+    MInt s = MInt::dot(A.data(), B.data(), n);
+*/
+
+// n^-1 mod 2^32, n is odd
+inline constexpr unsigned int montgomeryInverse32(unsigned int n) {
+    unsigned int inv = n;                           // n * n == 1 (mod 8)
+    for (int i = 0; i < 4; i++)
+        inv *= 2u - n * inv;
+    return inv;
+}
+
+template <int mod = 1'000'000'007>
+struct MontgomeryModInt {
+    typedef unsigned int u32;
+    typedef unsigned long long u64;
+
+    static_assert(mod > 1 && (mod & 1) != 0 && mod < (1 << 30), "mod must be odd and less than 2^30");
+
+    static const int mod_value = mod;
+
+    static constexpr u32 MOD = u32(mod);
+    static constexpr u32 NEG_INV = 0u - montgomeryInverse32(u32(mod));  // -mod^-1 mod 2^32
+    static constexpr u32 R1 = u32((1ull << 32) % u32(mod));         // 2^32 mod mod (= 1 in Montgomery form)
+    static constexpr u32 R2 = u32((0ull - u32(mod)) % u32(mod));    // 2^64 mod mod
+
+    u32 value;      // Montgomery form, [0, mod)
+
+    constexpr MontgomeryModInt() : value(0) {
+    }
+
+    template <typename U>
+    MontgomeryModInt(U x) : value(reduce(u64(normalize(x)) * R2)) {
+    }
+
+    // from a value in Montgomery form
+    static MontgomeryModInt raw(u32 x) {
+        MontgomeryModInt res;
+        res.value = x;
+        return res;
+    }
+
+    // [0, mod)
+    int get() const {
+        return int(reduce(value));
+    }
+
+    explicit operator int() const {
+        return get();
+    }
+
+    MontgomeryModInt& operator +=(const MontgomeryModInt& rhs) {
+        value = add(value, rhs.value);
+        return *this;
+    }
+
+    MontgomeryModInt& operator -=(const MontgomeryModInt& rhs) {
+        value = sub(value, rhs.value);
+        return *this;
+    }
+
+    MontgomeryModInt& operator *=(const MontgomeryModInt& rhs) {
+        value = mul(value, rhs.value);
+        return *this;
+    }
+
+    MontgomeryModInt& operator /=(const MontgomeryModInt& rhs) {
+        return *this *= rhs.inverse();
+    }
+
+    MontgomeryModInt operator -() const { return raw(sub(0, value)); }
+
+    MontgomeryModInt operator +(const MontgomeryModInt& rhs) const { return raw(add(value, rhs.value)); }
+    MontgomeryModInt operator -(const MontgomeryModInt& rhs) const { return raw(sub(value, rhs.value)); }
+    MontgomeryModInt operator *(const MontgomeryModInt& rhs) const { return raw(mul(value, rhs.value)); }
+    MontgomeryModInt operator /(const MontgomeryModInt& rhs) const { return *this * rhs.inverse(); }
+
+    bool operator ==(const MontgomeryModInt& rhs) const { return value == rhs.value; }
+    bool operator !=(const MontgomeryModInt& rhs) const { return value != rhs.value; }
+
+    MontgomeryModInt pow(u64 n) const {
+        u32 res = R1, x = value;
+        for (; n; n >>= 1) {
+            u32 t = mul(res, x);
+            res = (n & 1) ? t : res;
+            x = mul(x, x);
+        }
+        return raw(res);
+    }
+
+    // mod must be a prime number
+    MontgomeryModInt inverse() const {
+        return pow(MOD - 2);
+    }
+
+    //--- bulk kernels
+
+    // out[i] = a[i] * b[i], out can be a or b
+    static void multiply(MontgomeryModInt* out, const MontgomeryModInt* a, const MontgomeryModInt* b, int n) {
+        int i = 0;
+        if (CpuFeature::hasAVX2())
+            i = multiplyAVX2(out, a, b, n);
+        for (; i < n; i++)
+            out[i].value = mul(a[i].value, b[i].value);
+    }
+
+    // out[i] = a[i] + b[i], out can be a or b
+    static void add(MontgomeryModInt* out, const MontgomeryModInt* a, const MontgomeryModInt* b, int n) {
+        int i = 0;
+        if (CpuFeature::hasAVX2())
+            i = addAVX2(out, a, b, n);
+        for (; i < n; i++)
+            out[i].value = add(a[i].value, b[i].value);
+    }
+
+    // SUM a[i] * b[i], n < 2^31
+    static MontgomeryModInt dot(const MontgomeryModInt* a, const MontgomeryModInt* b, int n) {
+        int i = 0;
+        u64 sum = 0;                                // SUM of values < 2 * mod
+        if (CpuFeature::hasAVX2())
+            i = dotAVX2(a, b, n, sum);
+        for (; i < n; i++)
+            sum += reduceLazy(u64(a[i].value) * b[i].value);
+        // sum = (the result in Montgomery form) + k * mod < mod * 2^32
+        return raw(mul(reduce(sum), R2));
+    }
+
+    // out[i] = a[i] * x, out can be a
+    static void multiply(MontgomeryModInt* out, const MontgomeryModInt* a, MontgomeryModInt x, int n) {
+        int i = 0;
+        if (CpuFeature::hasAVX2())
+            i = convertAVX2(reinterpret_cast<u32*>(out), reinterpret_cast<const u32*>(a), n, x.value);
+        for (; i < n; i++)
+            out[i].value = mul(a[i].value, x.value);
+    }
+
+    // out[i] = a[0] * a[1] * ... * a[i], out can be a
+    // - PREFIX_CHAINS independent chains over consecutive parts, then each part is scaled by the product before it
+    static void prefixProduct(MontgomeryModInt* out, const MontgomeryModInt* a, int n) {
+        int len = n / PREFIX_CHAINS;
+        if (len < PREFIX_MIN_LENGTH) {
+            u32 x = R1;
+            for (int i = 0; i < n; i++)
+                out[i].value = x = mul(x, a[i].value);
+            return;
+        }
+
+        u32 x[PREFIX_CHAINS];
+        for (int k = 0; k < PREFIX_CHAINS; k++)
+            x[k] = R1;
+        for (int i = 0; i < len; i++) {
+            for (int k = 0; k < PREFIX_CHAINS; k++)
+                out[k * len + i].value = x[k] = mul(x[k], a[k * len + i].value);
+        }
+        for (int i = PREFIX_CHAINS * len; i < n; i++)
+            out[i].value = x[PREFIX_CHAINS - 1] = mul(x[PREFIX_CHAINS - 1], a[i].value);
+
+        for (int k = 1; k < PREFIX_CHAINS; k++) {
+            int first = k * len, last = (k + 1 < PREFIX_CHAINS) ? first + len : n;
+            multiply(out + first, out + first, out[first - 1], last - first);
+        }
+    }
+
+    // out[i] = in[i], in[i] must be in [0, mod)
+    static void fromInt(MontgomeryModInt* out, const int* in, int n) {
+        int i = 0;
+        if (CpuFeature::hasAVX2())
+            i = convertAVX2(reinterpret_cast<u32*>(out), reinterpret_cast<const u32*>(in), n, R2);
+        for (; i < n; i++)
+            out[i].value = reduce(u64(u32(in[i])) * R2);
+    }
+
+    // out[i] = in[i].get()
+    static void toInt(int* out, const MontgomeryModInt* in, int n) {
+        int i = 0;
+        if (CpuFeature::hasAVX2())
+            i = convertAVX2(reinterpret_cast<u32*>(out), reinterpret_cast<const u32*>(in), n, 1);
+        for (; i < n; i++)
+            out[i] = int(reduce(in[i].value));
+    }
+
+private:
+    static const int PREFIX_CHAINS = 4;
+    static const int PREFIX_MIN_LENGTH = 256;
+
+    template <typename U>
+    static u32 normalize(U x) {
+        long long v = static_cast<long long>(x % static_cast<U>(mod));
+        if (v < 0)
+            v += mod;
+        return u32(v);
+    }
+
+    // values are below 2^30, so signed compares are safe (cmovg/cmovs are one uop, cmova is two)
+    static u32 add(u32 a, u32 b) {
+        u32 s = a + b;
+        return (int(s) >= int(MOD)) ? s - MOD : s;
+    }
+
+    static u32 sub(u32 a, u32 b) {
+        u32 s = a - b;
+        return (int(s) < 0) ? s + MOD : s;
+    }
+
+    static u32 mul(u32 a, u32 b) {
+        return reduce(u64(a) * b);
+    }
+
+    // x * 2^-32 mod mod in [0, 2 * mod), x < mod * 2^32
+    static u32 reduceLazy(u64 x) {
+        u32 m = u32(x) * NEG_INV;
+        return u32((x + u64(m) * MOD) >> 32);
+    }
+
+    // x * 2^-32 mod mod in [0, mod), x < mod * 2^32
+    static u32 reduce(u64 x) {
+        u32 r = reduceLazy(x);
+        return (int(r) >= int(MOD)) ? r - MOD : r;
+    }
+
+    // in [0, 2 * mod)
+    TARGET_AVX2
+    static __m256i mulLazyAVX2(__m256i a, __m256i b) {
+        const __m256i m = _mm256_set1_epi32(int(MOD));
+        const __m256i nInv = _mm256_set1_epi32(int(NEG_INV));
+        __m256i tE = _mm256_mul_epu32(a, b);
+        __m256i tO = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i sE = _mm256_add_epi64(tE, _mm256_mul_epu32(_mm256_mul_epu32(tE, nInv), m));
+        __m256i sO = _mm256_add_epi64(tO, _mm256_mul_epu32(_mm256_mul_epu32(tO, nInv), m));
+        return _mm256_blend_epi32(_mm256_srli_epi64(sE, 32), sO, 0xAA);
+    }
+
+    TARGET_AVX2
+    static __m256i mulAVX2(__m256i a, __m256i b) {
+        __m256i r = mulLazyAVX2(a, b);
+        return _mm256_min_epu32(r, _mm256_sub_epi32(r, _mm256_set1_epi32(int(MOD))));
+    }
+
+    TARGET_AVX2
+    static int multiplyAVX2(MontgomeryModInt* out, const MontgomeryModInt* a, const MontgomeryModInt* b, int n) {
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), mulAVX2(x, y));
+        }
+        return i;
+    }
+
+    TARGET_AVX2
+    static int addAVX2(MontgomeryModInt* out, const MontgomeryModInt* a, const MontgomeryModInt* b, int n) {
+        const __m256i m = _mm256_set1_epi32(int(MOD));
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i s = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epu32(s, _mm256_sub_epi32(s, m)));
+        }
+        return i;
+    }
+
+    TARGET_AVX2
+    static int dotAVX2(const MontgomeryModInt* a, const MontgomeryModInt* b, int n, u64& sum) {
+        const __m256i lowMask = _mm256_set1_epi64x(0xFFFFFFFFll);
+        __m256i accE = _mm256_setzero_si256(), accO = _mm256_setzero_si256();
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i r = mulLazyAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            accE = _mm256_add_epi64(accE, _mm256_and_si256(r, lowMask));
+            accO = _mm256_add_epi64(accO, _mm256_srli_epi64(r, 32));
+        }
+        alignas(32) u64 lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(accE, accO));
+        sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        return i;
+    }
+
+    // out[i] = in[i] * x * 2^-32 mod mod
+    TARGET_AVX2
+    static int convertAVX2(u32* out, const u32* in, int n, u32 x) {
+        const __m256i y = _mm256_set1_epi32(int(x));
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), mulAVX2(v, y));
+        }
+        return i;
+    }
+};
+
+template <int mod> constexpr unsigned int MontgomeryModInt<mod>::MOD;
+template <int mod> constexpr unsigned int MontgomeryModInt<mod>::NEG_INV;
+template <int mod> constexpr unsigned int MontgomeryModInt<mod>::R1;
+template <int mod> constexpr unsigned int MontgomeryModInt<mod>::R2;
+
+
+template <int mod = 1'000'000'007>
+struct BarrettModInt {
+    typedef unsigned int u32;
+    typedef unsigned long long u64;
+
+    static_assert(mod > 0 && mod < (1 << 30), "mod must be less than 2^30");
+
+    static const int mod_value = mod;
+
+    static constexpr u32 MOD = u32(mod);
+    static constexpr u64 M = ~0ull / u32(mod);          // floor((2^64 - 1) / mod)
+
+    u32 value;      // [0, mod)
+
+    constexpr BarrettModInt() : value(0) {
+    }
+
+    template <typename U>
+    BarrettModInt(U x) : value(normalize(x)) {
+    }
+
+    static BarrettModInt raw(u32 x) {
+        BarrettModInt res;
+        res.value = x;
+        return res;
+    }
+
+    int get() const {
+        return int(value);
+    }
+
+    explicit operator int() const {
+        return get();
+    }
+
+    BarrettModInt& operator +=(const BarrettModInt& rhs) {
+        value = add(value, rhs.value);
+        return *this;
+    }
+
+    BarrettModInt& operator -=(const BarrettModInt& rhs) {
+        value = sub(value, rhs.value);
+        return *this;
+    }
+
+    BarrettModInt& operator *=(const BarrettModInt& rhs) {
+        value = mul(value, rhs.value);
+        return *this;
+    }
+
+    BarrettModInt& operator /=(const BarrettModInt& rhs) {
+        return *this *= rhs.inverse();
+    }
+
+    BarrettModInt operator -() const { return raw(sub(0, value)); }
+
+    BarrettModInt operator +(const BarrettModInt& rhs) const { return raw(add(value, rhs.value)); }
+    BarrettModInt operator -(const BarrettModInt& rhs) const { return raw(sub(value, rhs.value)); }
+    BarrettModInt operator *(const BarrettModInt& rhs) const { return raw(mul(value, rhs.value)); }
+    BarrettModInt operator /(const BarrettModInt& rhs) const { return *this * rhs.inverse(); }
+
+    bool operator ==(const BarrettModInt& rhs) const { return value == rhs.value; }
+    bool operator !=(const BarrettModInt& rhs) const { return value != rhs.value; }
+
+    BarrettModInt pow(u64 n) const {
+        u32 res = 1 % MOD, x = value;
+        for (; n; n >>= 1) {
+            u32 t = mul(res, x);
+            res = (n & 1) ? t : res;
+            x = mul(x, x);
+        }
+        return raw(res);
+    }
+
+    // gcd(value, mod) must be 1
+    BarrettModInt inverse() const {
+        long long a = value, b = mod, x = 1, y = 0;
+        while (b) {
+            long long q = a / b;
+            swap(a -= q * b, b);
+            swap(x -= q * y, y);
+        }
+        return BarrettModInt(x);
+    }
+
+    //--- bulk kernels (scalar, AVX2 has no 64 x 64 -> 128 bit multiplication)
+
+    static void multiply(BarrettModInt* out, const BarrettModInt* a, const BarrettModInt* b, int n) {
+        for (int i = 0; i < n; i++)
+            out[i].value = mul(a[i].value, b[i].value);
+    }
+
+    static void add(BarrettModInt* out, const BarrettModInt* a, const BarrettModInt* b, int n) {
+        for (int i = 0; i < n; i++)
+            out[i].value = add(a[i].value, b[i].value);
+    }
+
+    // SUM a[i] * b[i], n < 2^31
+    static BarrettModInt dot(const BarrettModInt* a, const BarrettModInt* b, int n) {
+        u64 sum = 0;                                // SUM of values < 2 * mod
+        int i = 0;
+        for (; i + 4 <= n; i += 4) {
+            u64 t = u64(a[i].value) * b[i].value + u64(a[i + 1].value) * b[i + 1].value
+                  + u64(a[i + 2].value) * b[i + 2].value + u64(a[i + 3].value) * b[i + 3].value;
+            sum += reduceLazy(t);
+        }
+        for (; i < n; i++)
+            sum += reduceLazy(u64(a[i].value) * b[i].value);
+        return raw(reduce(sum));
+    }
+
+    static void multiply(BarrettModInt* out, const BarrettModInt* a, BarrettModInt x, int n) {
+        for (int i = 0; i < n; i++)
+            out[i].value = mul(a[i].value, x.value);
+    }
+
+    static void prefixProduct(BarrettModInt* out, const BarrettModInt* a, int n) {
+        int len = n / PREFIX_CHAINS;
+        if (len < PREFIX_MIN_LENGTH) {
+            u32 x = 1 % MOD;
+            for (int i = 0; i < n; i++)
+                out[i].value = x = mul(x, a[i].value);
+            return;
+        }
+
+        u32 x[PREFIX_CHAINS];
+        for (int k = 0; k < PREFIX_CHAINS; k++)
+            x[k] = 1 % MOD;
+        for (int i = 0; i < len; i++) {
+            for (int k = 0; k < PREFIX_CHAINS; k++)
+                out[k * len + i].value = x[k] = mul(x[k], a[k * len + i].value);
+        }
+        for (int i = PREFIX_CHAINS * len; i < n; i++)
+            out[i].value = x[PREFIX_CHAINS - 1] = mul(x[PREFIX_CHAINS - 1], a[i].value);
+
+        for (int k = 1; k < PREFIX_CHAINS; k++) {
+            int first = k * len, last = (k + 1 < PREFIX_CHAINS) ? first + len : n;
+            multiply(out + first, out + first, out[first - 1], last - first);
+        }
+    }
+
+    static void fromInt(BarrettModInt* out, const int* in, int n) {
+        for (int i = 0; i < n; i++)
+            out[i].value = u32(in[i]);
+    }
+
+    static void toInt(int* out, const BarrettModInt* in, int n) {
+        for (int i = 0; i < n; i++)
+            out[i] = int(in[i].value);
+    }
+
+private:
+    static const int PREFIX_CHAINS = 4;
+    static const int PREFIX_MIN_LENGTH = 256;
+
+    template <typename U>
+    static u32 normalize(U x) {
+        long long v = static_cast<long long>(x % static_cast<U>(mod));
+        if (v < 0)
+            v += mod;
+        return u32(v);
+    }
+
+    // values are below 2^30, so signed compares are safe (cmovg/cmovs are one uop, cmova is two)
+    static u32 add(u32 a, u32 b) {
+        u32 s = a + b;
+        return (int(s) >= int(MOD)) ? s - MOD : s;
+    }
+
+    static u32 sub(u32 a, u32 b) {
+        u32 s = a - b;
+        return (int(s) < 0) ? s + MOD : s;
+    }
+
+    static u32 mul(u32 a, u32 b) {
+        return reduce(u64(a) * b);
+    }
+
+    static u64 mulHi(u64 a, u64 b) {
+#ifdef __GNUC__
+        return u64(((unsigned __int128)a * b) >> 64);
+#else
+        return __umulh(a, b);
+#endif
+    }
+
+    // x mod mod in [0, 2 * mod), x < 2^62
+    static u32 reduceLazy(u64 x) {
+        return u32(x - mulHi(x, M) * MOD);
+    }
+
+    // x mod mod, x < 2^62
+    static u32 reduce(u64 x) {
+        u32 r = reduceLazy(x);
+        return (int(r) >= int(MOD)) ? r - MOD : r;
+    }
+};
+
+template <int mod> constexpr unsigned int BarrettModInt<mod>::MOD;
+template <int mod> constexpr unsigned long long BarrettModInt<mod>::M;
@@ -14,29 +14,26 @@ struct FastModOp {
         build(maxN);
     }
 
-    // O(N)
+    // O(N), without divisions, maxN < mod, mod must be a prime number
+    // - n! forward, 1/n! backward from one modular inverse, 1/n = (n-1)! / n!
     void build(int maxN) {
         N = max(1, maxN);
 
-        factorial.resize(maxN + 1);
-        factInverse.resize(maxN + 1);
-        inverse.resize(maxN + 1);
-
-        inverse[0] = 0;
-        inverse[1] = 1;
-        for (int i = 2; i <= maxN; i++)
-            inverse[i] = int((mod - 1ll * (mod / i) * inverse[mod % i] % mod) % mod);
+        factorial.resize(N + 1);
+        factInverse.resize(N + 1);
+        inverse.resize(N + 1);
 
         factorial[0] = 1;
-        factInverse[0] = 1;
+        for (int i = 1; i <= N; i++)
+            factorial[i] = int(1ll * factorial[i - 1] * i % mod);
 
-        factorial[1] = 1;
-        factInverse[1] = 1;
+        factInverse[N] = modInv(factorial[N]);
+        for (int i = N; i > 0; i--)
+            factInverse[i - 1] = int(1ll * factInverse[i] * i % mod);
 
-        for (int i = 2; i <= maxN; i++) {
-            factorial[i] = int(1ll * factorial[i - 1] * i % mod);
-            factInverse[i] = int(1ll * factInverse[i - 1] * inverse[i] % mod);
-        }
+        inverse[0] = 0;
+        for (int i = 1; i <= N; i++)
+            inverse[i] = int(1ll * factInverse[i] * factorial[i - 1] % mod);
     }
 
     // n!, O(1)
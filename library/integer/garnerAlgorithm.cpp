@@ -89,5 +89,29 @@ void testGarnerAlgorithm() {
         GarnerBigInt y(6);
         assert(x == y.get());
     }
+    {
+        const int M1 = 167772161, M2 = 469762049, M3 = 754974721;
+        const int MOD = 1000000007;
+
+        GarnerMod3<M1, M2, M3> garner;
+
+        int N = 1000;
+        vector<int> r1(N), r2(N), r3(N), out(N);
+        vector<long long> x(N);
+        for (int i = 0; i < N; i++) {
+            x[i] = RandInt64::get() % (1ll * M1 * M2);
+            r1[i] = int(x[i] % M1);
+            r2[i] = int(x[i] % M2);
+            r3[i] = int(x[i] % M3);
+            int ans = garner.get(r1[i], r2[i], r3[i], MOD);
+            if (ans != x[i] % MOD)
+                cout << "Mismatched : " << ans << ", " << x[i] % MOD << endl;
+            assert(ans == x[i] % MOD);
+        }
+
+        garner.get(r1.data(), r2.data(), r3.data(), out.data(), 0, N, MOD);
+        for (int i = 0; i < N; i++)
+            assert(out[i] == x[i] % MOD);
+    }
     cout << "OK!" << endl;
 }
@@ -138,3 +138,45 @@ private:
         R = invPrimes;
     }
 };
+
+
+/*
+  Garner Algorithm for 3 moduli (ex: results of 3 NTTs)
+
+  1. Formula
+     x = r1 + m1 * v1 + m1 * m2 * v2   (0 <= x < m1 * m2 * m3)
+       v1 = (r2 - r1) * m1^-1 (mod m2)
+       v2 = (r3 - (r1 + m1 * v1)) * (m1 * m2)^-1 (mod m3)
+
+  2. get() returns x mod 'mod'
+*/
+template <int m1, int m2, int m3>
+struct GarnerMod3 {
+    int m1InvM2;        // m1^-1 (mod m2)
+    int m12InvM3;       // (m1 * m2)^-1 (mod m3)
+    int m1ModM3;        // m1 (mod m3)
+
+    GarnerMod3() {
+        m1InvM2 = modInv(m1 % m2, m2);
+        m12InvM3 = modInv(int(1ll * m1 * m2 % m3), m3);
+        m1ModM3 = m1 % m3;
+    }
+
+    // 0 <= r1 < m1, 0 <= r2 < m2, 0 <= r3 < m3
+    int get(int r1, int r2, int r3, int mod) const {
+        int v1 = int(1ll * ((r2 - r1) % m2 + m2) * m1InvM2 % m2);
+        int v2 = int(((r3 - r1 - 1ll * m1ModM3 * v1) % m3 + m3) * m12InvM3 % m3);
+        return int((r1 + 1ll * (m1 % mod) * v1 + 1ll * m1 * m2 % mod * v2) % mod);
+    }
+
+    // out[i] = get(r1[i], r2[i], r3[i], mod), first <= i < last
+    void get(const int* r1, const int* r2, const int* r3, int* out, int first, int last, int mod) const {
+        int m1Mod = m1 % mod;
+        int m12Mod = int(1ll * m1 * m2 % mod);
+        for (int i = first; i < last; i++) {
+            int v1 = int(1ll * ((r2[i] - r1[i]) % m2 + m2) * m1InvM2 % m2);
+            int v2 = int(((r3[i] - r1[i] - 1ll * m1ModM3 * v1) % m3 + m3) * m12InvM3 % m3);
+            out[i] = int((r1[i] + 1ll * m1Mod * v1 + 1ll * m12Mod * v2) % mod);
+        }
+    }
+};
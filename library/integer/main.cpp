@@ -8,7 +8,10 @@ using namespace std;
 int main(void) {
     TEST(PrimeNumberBasic);
     TEST(PrimeNumberEratosthenes);
+    TEST(PrimeNumberSegmentedSieve);
+    TEST(PrimeCounting);
     TEST(PrimeNumberLinearSieve);
+    TEST(MultiplicativeSieve);
     TEST(Gcd);
     TEST(IntMod);
     TEST(FactorialMod);
@@ -21,15 +24,18 @@ int main(void) {
     TEST(DiophantineEquation);
     TEST(PrimitiveRoot);
     TEST(BigInt);
+    TEST(BigInt64);
     TEST(Bit);
     TEST(PrimalityTest);
     TEST(PrimalityTestFast);
     TEST(PrimalityTestInt32);
     TEST(PrimalityTestInt64);
+    TEST(PrimalityTestBatch);
     TEST(PrimeFactorInt64);
     TEST(DiscreteEquations);
     TEST(GarnerAlgorithm);
     TEST(FastModOp);
+    TEST(FastModInt);
     TEST(Int128);
     TEST(DiscreteLog);
     TEST(SubsetXOR);
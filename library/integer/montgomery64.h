@@ -0,0 +1,129 @@
+#pragma once
+
+#ifndef __GNUC__
+#include <intrin.h>
+#endif
+
+// Montgomery multiplication for an odd 64-bit modulus (R = 2^64)
+// - values in Montgomery form are fully reduced, [0, n)
+// - works for all odd n < 2^64
+struct Montgomery64 {
+    typedef unsigned long long u64;
+
+    u64 n;
+    u64 nInv;       // n^-1 mod 2^64
+    u64 r1;         // R mod n      (= 1 in Montgomery form)
+    u64 r2;         // R^2 mod n
+
+    Montgomery64() : n(0), nInv(0), r1(0), r2(0) {
+    }
+
+    explicit Montgomery64(u64 n) {
+        init(n);
+    }
+
+    // n must be odd
+    void init(u64 n) {
+        this->n = n;
+
+        u64 inv = n;                    // n * n == 1 (mod 8)
+        for (int i = 0; i < 5; i++)
+            inv *= 2 - n * inv;
+        nInv = inv;
+
+        r1 = (0 - n) % n;
+        u64 hi, lo = mul64(r1, r1, hi);
+        r2 = modulo(hi, lo, n);
+    }
+
+    u64 toMontgomery(u64 x) const {
+        return mul(x % n, r2);
+    }
+
+    u64 fromMontgomery(u64 x) const {
+        return reduce(0, x);
+    }
+
+    // a * b * R^-1 mod n
+    u64 mul(u64 a, u64 b) const {
+        u64 hi, lo = mul64(a, b, hi);
+        return reduce(hi, lo);
+    }
+
+    u64 add(u64 a, u64 b) const {
+        u64 s = a + b;
+        return (s < a || s >= n) ? s - n : s;
+    }
+
+    u64 sub(u64 a, u64 b) const {
+        return a >= b ? a - b : a - b + n;
+    }
+
+    // a^e in Montgomery form
+    u64 pow(u64 a, u64 e) const {
+        u64 res = r1;
+        while (e) {
+            if (e & 1)
+                res = mul(res, a);
+            a = mul(a, a);
+            e >>= 1;
+        }
+        return res;
+    }
+
+    // strong probable prime test to base a (a in normal form), n odd and n > 2
+    bool isSPRP(u64 a) const {
+        a %= n;
+        if (a == 0)
+            return true;
+
+        u64 d = n - 1;
+        int s = 0;
+        while (!(d & 1)) {
+            d >>= 1;
+            s++;
+        }
+
+        u64 minusOne = n - r1;
+        u64 x = pow(toMontgomery(a), d);
+        if (x == r1 || x == minusOne)
+            return true;
+        while (--s > 0) {
+            x = mul(x, x);
+            if (x == minusOne)
+                return true;
+        }
+        return false;
+    }
+
+    static u64 mul64(u64 a, u64 b, u64& hi) {
+#ifdef __GNUC__
+        unsigned __int128 t = (unsigned __int128)a * b;
+        hi = u64(t >> 64);
+        return u64(t);
+#else
+        return _umul128(a, b, &hi);
+#endif
+    }
+
+private:
+    // (hi * 2^64 + lo) * R^-1 mod n, hi < n
+    u64 reduce(u64 hi, u64 lo) const {
+        u64 m = lo * nInv;
+        u64 mnHi;
+        mul64(m, n, mnHi);
+        // lo == low(m * n), so the low words cancel
+        return hi >= mnHi ? hi - mnHi : hi - mnHi + n;
+    }
+
+    // (hi * 2^64 + lo) mod n, hi < n
+    static u64 modulo(u64 hi, u64 lo, u64 n) {
+#ifdef __GNUC__
+        return u64((((unsigned __int128)hi << 64) | lo) % n);
+#else
+        u64 rem;
+        _udiv128(hi, lo, n, &rem);
+        return rem;
+#endif
+    }
+};
@@ -0,0 +1,135 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+#include "multiplicativeSieve.h"
+#include "primeFactor.h"
+#include "primeFactorsSmallestLinearSieve.h"
+#include "mobius.h"
+#include "eulerPhi.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include <cstdio>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+
+static unsigned long long sigmaPrimePower(unsigned p, int, unsigned pe) {
+    return (1ull * pe * p - 1) / (p - 1);
+}
+
+static unsigned long long sigmaSlow(int x) {
+    unsigned long long res = 0;
+    for (int d = 1; 1ll * d * d <= x; d++) {
+        if (x % d == 0) {
+            res += d;
+            if (d != x / d)
+                res += x / d;
+        }
+    }
+    return res;
+}
+
+void testMultiplicativeSieve() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Multiplicative Function Sieve -----------------------" << endl;
+    {
+        for (int n : { 0, 1, 2, 3, 10, 1000, 65535, 65536, 65537, 3000000 }) {
+            SmallestPrimeFactorsWithLinearSieve gtSpf(max(n, 1));
+            vector<int> gtMu = mobiusSeive(max(n, 1));
+            vector<int> gtPhi = EulerPhi::phiAll(n);
+
+            for (int threadN : { 1, 3 }) {
+                MultiplicativeSieve sieve;
+                SieveTable<unsigned long long> sigma;
+                SieveTable<unsigned int> divisorCount;
+                sieve.build(n, MultiplicativeSieve::SPF | MultiplicativeSieve::MU | MultiplicativeSieve::PHI, threadN,
+                            makeMultiplicativeTable(sigma, sigmaPrimePower),
+                            makeMultiplicativeTable(divisorCount, [](unsigned, int e, unsigned) { return unsigned(e + 1); }));
+
+                assert(sieve.spf.size() == size_t(n) + 1);
+                for (int x = 0; x <= n; x++) {
+                    assert(int(sieve.spf[x]) == (x < 2 ? 0 : gtSpf.spf[x]));
+                    assert(sieve.mu[x] == (x == 0 ? 0 : gtMu[x]));
+                    assert(int(sieve.phi[x]) == gtPhi[x]);
+                }
+                for (int x = 0; x <= min(n, 100000); x++) {
+                    assert(sigma[x] == (x == 0 ? 0 : sigmaSlow(x)));
+                    if (x > 0) {
+                        unsigned cnt = 1;
+                        for (auto& it : gtSpf.getPrimeFactors(x))
+                            cnt *= it.second + 1;
+                        assert(divisorCount[x] == cnt);
+                    }
+                }
+            }
+        }
+    }
+    {
+        // save & memory-map
+        const char* path = "multiplicativeSieve_phi.bin";
+        MultiplicativeSieve sieve;
+        sieve.build(1000000, MultiplicativeSieve::PHI);
+        assert(sieve.phi.save(path));
+
+        SieveTable<unsigned int> phi;
+        assert(phi.load(path));
+        assert(phi.isMapped() && phi.size() == sieve.phi.size());
+        assert(memcmp(phi.data(), sieve.phi.data(), phi.size() * sizeof(unsigned int)) == 0);
+
+        SieveTable<signed char> wrongType;
+        assert(!wrongType.load(path));
+        phi.clear();
+        remove(path);
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        int N = 100000000;
+
+        cout << "spf / mu / phi, separate passes (N = " << N << ") : ";
+        PROFILE_HI_START(0);
+        {
+            SmallestPrimeFactors spf;
+            spf.build(N);
+            auto mu = mobiusSeive(N, spf);
+            auto phi = EulerPhi::phiAll(N);
+        }
+        PROFILE_HI_STOP(0);
+
+        for (int threadN : { 1, 2, 4 }) {
+            cout << "spf / mu / phi, MultiplicativeSieve, threads = " << threadN << " : ";
+            MultiplicativeSieve sieve;
+            PROFILE_HI_START(1);
+            sieve.build(N, MultiplicativeSieve::SPF | MultiplicativeSieve::MU | MultiplicativeSieve::PHI, threadN);
+            PROFILE_HI_STOP(1);
+        }
+
+        const char* path = "multiplicativeSieve_spf.bin";
+        {
+            MultiplicativeSieve sieve;
+            sieve.build(N, MultiplicativeSieve::SPF);
+            sieve.spf.save(path);
+        }
+        cout << "spf, memory-mapped : ";
+        PROFILE_HI_START(2);
+        SieveTable<unsigned int> spf;
+        spf.load(path);
+        PROFILE_HI_STOP(2);
+        spf.clear();
+        remove(path);
+    }
+}
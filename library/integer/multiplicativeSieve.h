@@ -0,0 +1,322 @@
+#pragma once
+
+#include "bit.h"
+#include "primeNumberLinearSieve.h"
+#include "../common/parallel.h"
+#include "../common/mappedFile.h"
+
+/*
+  Segmented, multithreaded sieve for multiplicative function tables of [0, n], n < 2^32
+
+  - smallest prime factors (uint32), the Mobius function (int8), Euler's phi (uint32) and any number of
+    user-defined multiplicative functions are filled in one pass
+  - each segment keeps the unfactored part of its numbers, a prime p <= sqrt(n) divides out p^e from its
+    multiples with exact division by p^-1 (mod 2^32) (no hardware division), what remains is 1 or a prime
+  - blocks of segments are shared by threads dynamically (Parallel::forEach)
+  - tables are not initialized twice (allocated uninitialized, written once by the sieve),
+    they can be saved to a file and memory-mapped later instead of being rebuilt (SieveTable::save / load)
+
+  <How to use>
+    MultiplicativeSieve sieve;
+    sieve.build(1'000'000'000, MultiplicativeSieve::SPF | MultiplicativeSieve::MU);
+    int mu = sieve.mu[12];
+
+    // sigma(x) = the sum of divisors of x, value(p, e, p^e) = sigma(p^e)
+    SieveTable<unsigned long long> sigma;
+    sieve.build(n, MultiplicativeSieve::PHI, 0, makeMultiplicativeTable(sigma, [](unsigned p, int e, unsigned pe) {
+        return (1ull * pe * p - 1) / (p - 1);
+    }));
+
+    sieve.phi.save("phi.bin");
+    ...
+    SieveTable<unsigned int> phi;
+    if (!phi.load("phi.bin"))       // memory-mapped, read-only
+        ...
+*/
+
+// a table of [0, n], owned or memory-mapped from a file (read-only)
+template <typename T>
+struct SieveTable {
+    SieveTable() : ptr(nullptr), n(0) {
+    }
+
+    size_t size() const {
+        return n;
+    }
+
+    const T* data() const {
+        return ptr;
+    }
+
+    const T& operator [](size_t i) const {
+        return ptr[i];
+    }
+
+    bool isMapped() const {
+        return file.isOpen();
+    }
+
+    // uninitialized
+    T* allocate(size_t size) {
+        clear();
+        owned.reset(new T[size]);
+        ptr = owned.get();
+        n = size;
+        return owned.get();
+    }
+
+    void clear() {
+        file.close();
+        owned.reset();
+        ptr = nullptr;
+        n = 0;
+    }
+
+    bool save(const char* path) const {
+        Header header = { MAGIC, sizeof(T), n, 0 };
+        ofstream out(path, ios_base::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(ptr), streamsize(n * sizeof(T)));
+        return bool(out);
+    }
+
+    // maps a file written by save()
+    bool load(const char* path) {
+        clear();
+        if (!file.open(path))
+            return false;
+
+        Header header;
+        if (file.size() >= sizeof(header))
+            memcpy(&header, file.data(), sizeof(header));
+        if (file.size() < sizeof(header) || header.magic != MAGIC || header.elementSize != sizeof(T)
+            || file.size() != sizeof(header) + header.count * sizeof(T)) {
+            file.close();
+            return false;
+        }
+
+        ptr = reinterpret_cast<const T*>(static_cast<const char*>(file.data()) + sizeof(header));
+        n = size_t(header.count);
+        return true;
+    }
+
+private:
+    static const unsigned long long MAGIC = 0x4C42544556454953ull;     // "SIEVETBL"
+
+    struct Header {
+        unsigned long long magic;
+        unsigned long long elementSize;
+        unsigned long long count;
+        unsigned long long reserved;        // the data starts at a 32-byte boundary
+    };
+
+    unique_ptr<T[]> owned;
+    MappedFile file;
+    const T* ptr;
+    size_t n;
+};
+
+// out[x] = f(x) for a multiplicative function f, value(p, e, p^e) = f(p^e)
+template <typename T, typename F>
+struct MultiplicativeTable {
+    typedef T value_type;
+    typedef F function_type;
+
+    SieveTable<T>* out;
+    F value;
+};
+
+template <typename T, typename F>
+inline MultiplicativeTable<T, F> makeMultiplicativeTable(SieveTable<T>& out, F value) {
+    return MultiplicativeTable<T, F>{ &out, value };
+}
+
+struct MultiplicativeSieve {
+    typedef unsigned int u32;
+    typedef unsigned long long u64;
+
+    enum TableType {
+        SPF = 1,
+        MU  = 2,
+        PHI = 4
+    };
+
+    static const int SEGMENT_SIZE = 1 << 16;
+    static const int BLOCK_SEGMENTS = 16;
+
+    SieveTable<u32> spf;            // smallest prime factors, spf[0] = spf[1] = 0
+    SieveTable<signed char> mu;     // the Mobius function, mu[0] = 0
+    SieveTable<u32> phi;            // Euler's phi function, phi[0] = 0
+
+    // types : SPF | MU | PHI, the other tables are left as they are
+    // tables : MultiplicativeTable objects, f(0) = 0, f(1) = 1
+    // threadN = 0 : all hardware threads
+    template <typename... Tables>
+    void build(u32 n, int types = SPF | MU | PHI, int threadN = 0, Tables... tables) {
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        size_t size = size_t(n) + 1;
+        Output out;
+        out.spf = (types & SPF) ? spf.allocate(size) : nullptr;
+        out.mu = (types & MU) ? mu.allocate(size) : nullptr;
+        out.phi = (types & PHI) ? phi.allocate(size) : nullptr;
+        run(n, threadN, out, Writer<typename Tables::value_type, typename Tables::function_type>{ tables.out->allocate(size), tables.value }...);
+    }
+
+private:
+    struct Output {
+        u32* spf;
+        signed char* mu;
+        u32* phi;
+    };
+
+    struct OddPrime {
+        u32 p;
+        u32 inv;        // p^-1 mod 2^32
+        u32 limit;      // x is a multiple of p if x * inv <= limit
+    };
+
+    template <typename T, typename F>
+    struct Writer {
+        T* data;
+        F value;
+
+        void init(u64 lo, u64 hi) {
+            for (u64 m = lo; m < hi; m++)
+                data[m] = T(1);
+        }
+
+        void apply(u64 m, u32 p, int e, u32 pe) {
+            data[m] *= value(p, e, pe);
+        }
+
+        void zero() {
+            data[0] = T(0);
+        }
+    };
+
+    template <typename... Writers>
+    static void run(u32 n, int threadN, Output out, Writers... writers) {
+        u32 root = u32(sqrt(double(n)));
+        while (u64(root) * root > n)
+            root--;
+        while (u64(root + 1) * (root + 1) <= n)
+            root++;
+
+        vector<OddPrime> primes;
+        for (int p : linearSieve(int(max(root, 2u)))) {
+            if (p == 2 || u32(p) > root)
+                continue;
+            u32 inv = u32(p);                   // p * p == 1 (mod 8)
+            for (int i = 0; i < 4; i++)
+                inv *= 2u - u32(p) * inv;
+            primes.push_back(OddPrime{ u32(p), inv, ~0u / u32(p) });
+        }
+
+        u64 total = u64(n) + 1;
+        u64 blockSize = u64(SEGMENT_SIZE) * BLOCK_SEGMENTS;
+        int blockN = int((total + blockSize - 1) / blockSize);
+        Parallel::forEach(blockN, threadN, [&](int b) {
+            vector<u32> rest(SEGMENT_SIZE);
+            vector<u64> next(primes.size());
+
+            u64 blockLo = u64(b) * blockSize;
+            u64 blockHi = min(total, blockLo + blockSize);
+            for (int j = 0; j < int(primes.size()); j++) {
+                u64 p = primes[j].p;
+                next[j] = max(p, (blockLo + p - 1) / p * p);
+            }
+            for (u64 lo = blockLo; lo < blockHi; lo += SEGMENT_SIZE)
+                sieveSegment(lo, min(blockHi, lo + SEGMENT_SIZE), primes, next.data(), rest.data(), out, writers...);
+        });
+    }
+
+    template <typename... Writers>
+    static void sieveSegment(u64 lo, u64 hi, const vector<OddPrime>& primes, u64* next, u32* rest,
+                             Output out, Writers&... writers) {
+        int len = int(hi - lo);
+        for (int i = 0; i < len; i++)
+            rest[i] = u32(lo + i);
+        if (out.mu)
+            fill(out.mu + lo, out.mu + hi, static_cast<signed char>(1));
+        if (out.phi)
+            fill(out.phi + lo, out.phi + hi, 1u);
+        int dummy0[] = { 0, (writers.init(lo, hi), 0)... };
+        (void)dummy0;
+
+        // p = 2
+        for (u64 m = max<u64>(2, lo + (lo & 1)); m < hi; m += 2) {
+            u32 r = rest[m - lo];
+            int e = ctz(r);
+            u32 pe = 1u << e;
+            rest[m - lo] = r >> e;
+            if (out.spf)
+                out.spf[m] = 2;
+            if (out.mu)
+                out.mu[m] = (e > 1) ? 0 : -1;
+            if (out.phi)
+                out.phi[m] = pe >> 1;
+            int dummy[] = { 0, (writers.apply(m, 2, e, pe), 0)... };
+            (void)dummy;
+        }
+
+        // odd primes <= sqrt(n)
+        for (int j = 0; j < int(primes.size()); j++) {
+            u32 p = primes[j].p, inv = primes[j].inv, limit = primes[j].limit;
+            u64 m = next[j];
+            for (; m < hi; m += p) {
+                u32 r = rest[m - lo];
+                u32 q = r * inv;
+                int e = 1;
+                u32 pe = p, pePrev = 1;
+                while (q * inv <= limit) {
+                    q *= inv;
+                    e++;
+                    pePrev = pe;
+                    pe *= p;
+                }
+                rest[m - lo] = q;
+                if (out.spf && r == u32(m))
+                    out.spf[m] = p;
+                if (out.mu)
+                    out.mu[m] = (e > 1) ? 0 : -out.mu[m];
+                if (out.phi)
+                    out.phi[m] *= pe - pePrev;
+                int dummy[] = { 0, (writers.apply(m, p, e, pe), 0)... };
+                (void)dummy;
+            }
+            next[j] = m;
+        }
+
+        // the remaining factor is 1 or a prime > sqrt(n)
+        for (int i = 0; i < len; i++) {
+            u32 r = rest[i];
+            if (r <= 1)
+                continue;
+            u64 m = lo + i;
+            if (out.spf && r == u32(m))
+                out.spf[m] = r;
+            if (out.mu)
+                out.mu[m] = -out.mu[m];
+            if (out.phi)
+                out.phi[m] *= r - 1;
+            int dummy[] = { 0, (writers.apply(m, r, 1, r), 0)... };
+            (void)dummy;
+        }
+
+        if (lo == 0) {
+            if (out.spf) {
+                out.spf[0] = 0;
+                if (hi > 1)
+                    out.spf[1] = 0;
+            }
+            if (out.mu)
+                out.mu[0] = 0;
+            if (out.phi)
+                out.phi[0] = 0;
+            int dummy[] = { 0, (writers.zero(), 0)... };
+            (void)dummy;
+        }
+    }
+};
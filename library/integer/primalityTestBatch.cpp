@@ -0,0 +1,137 @@
+#include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using namespace std;
+
+#include "primalityTestBatch.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+template <typename T, typename ScalarF>
+static void checkBatch(const vector<T>& in, ScalarF scalar) {
+    vector<unsigned char> out(in.size());
+    PrimalityTestBatch::isPrimeBatch(in.data(), int(in.size()), out.data());
+    for (int i = 0; i < int(in.size()); i++) {
+        if (out[i] != (scalar(in[i]) ? 1 : 0))
+            cout << "Mismatch in [" << in[i] << "] : " << int(out[i]) << ", " << scalar(in[i]) << endl;
+        assert(out[i] == (scalar(in[i]) ? 1 : 0));
+    }
+}
+
+void testPrimalityTestBatch() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    auto scalar32 = [](unsigned int x) { return PrimalityTestInt32::isPrimeNumber(x); };
+    auto scalar64 = [](unsigned long long x) { return PrimalityTestInt64::isPrimeNumber(x); };
+
+    cout << "--- Batch Primality Test -------------------" << endl;
+    {
+        vector<unsigned int> in;
+        for (unsigned int x = 0; x < 2000000; x++)
+            in.push_back(x);
+        for (unsigned int x = 4294967295u; x > 4294967295u - 1000000; x--)
+            in.push_back(x);
+        for (int i = 0; i < 1000000; i++)
+            in.push_back(RandInt32::get() | 1);
+        // strong pseudoprimes to small bases, Carmichael numbers
+        for (unsigned int x : { 2047u, 3277u, 4033u, 4681u, 8321u, 561u, 41041u, 825265u, 321197185u, 3215031751u, 4294967291u })
+            in.push_back(x);
+        checkBatch(in, scalar32);
+
+        // sizes not a multiple of the lane count
+        for (int n = 0; n < 20; n++)
+            checkBatch(vector<unsigned int>(in.end() - n - 100, in.end() - 100), scalar32);
+    }
+    {
+        vector<unsigned long long> in;
+        for (unsigned long long x = 0; x < 100000; x++)
+            in.push_back(x);
+        for (int bits = 33; bits <= 64; bits++) {
+            for (int i = 0; i < 20000; i++)
+                in.push_back(((unsigned long long)RandInt64::get() >> (64 - bits)) | 1);
+        }
+        for (unsigned long long x = ~0ull; x > ~0ull - 100000; x--)
+            in.push_back(x);
+        for (unsigned long long x : { 3215031751ull, 2152302898747ull, 3474749660383ull, 341550071728321ull, 3825123056546413051ull,
+                                      18446744073709551557ull, 4294967291ull * 4294967279ull, 4294967311ull })
+            in.push_back(x);
+        checkBatch(in, scalar64);
+
+        for (int n = 0; n < 20; n++)
+            checkBatch(vector<unsigned long long>(in.end() - n - 100, in.end() - 100), scalar64);
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        int T = 10000000;
+        vector<unsigned int> in(T);
+        for (int i = 0; i < T; i++)
+            in[i] = RandInt32::get() | 1;
+        vector<unsigned char> out(T);
+
+        cout << "32-bit, scalar : ";
+        int cnt1 = 0;
+        PROFILE_HI_START(0);
+        for (int i = 0; i < T; i++)
+            cnt1 += PrimalityTestInt32::isPrimeNumber(in[i]);
+        PROFILE_HI_STOP(0);
+
+        cout << "32-bit, batch : ";
+        PROFILE_HI_START(1);
+        PrimalityTestBatch::isPrimeBatch(in.data(), T, out.data());
+        PROFILE_HI_STOP(1);
+        int cnt2 = int(count(out.begin(), out.end(), 1));
+        assert(cnt1 == cnt2);
+    }
+    {
+        int T = 1000000;
+        vector<unsigned long long> in(T);
+        for (int i = 0; i < T; i++)
+            in[i] = (unsigned long long)RandInt64::get() | 1;
+        vector<unsigned char> out(T);
+
+        cout << "64-bit, scalar : ";
+        int cnt1 = 0;
+        PROFILE_HI_START(2);
+        for (int i = 0; i < T; i++)
+            cnt1 += PrimalityTestInt64::isPrimeNumber(in[i]);
+        PROFILE_HI_STOP(2);
+
+        cout << "64-bit, batch : ";
+        PROFILE_HI_START(3);
+        PrimalityTestBatch::isPrimeBatch(in.data(), T, out.data());
+        PROFILE_HI_STOP(3);
+        int cnt2 = int(count(out.begin(), out.end(), 1));
+        assert(cnt1 == cnt2);
+
+        // mostly primes (the worst case, all bases are tested)
+        vector<unsigned long long> primes;
+        for (int i = 0; primes.size() < 100000; i++) {
+            if (in[i] > (1ull << 32) && PrimalityTestInt64::isPrimeNumber(in[i]))
+                primes.push_back(in[i]);
+        }
+        cout << "64-bit primes, scalar : ";
+        cnt1 = 0;
+        PROFILE_HI_START(4);
+        for (auto x : primes)
+            cnt1 += PrimalityTestInt64::isPrimeNumber(x);
+        PROFILE_HI_STOP(4);
+
+        cout << "64-bit primes, batch : ";
+        PROFILE_HI_START(5);
+        PrimalityTestBatch::isPrimeBatch(primes.data(), int(primes.size()), out.data());
+        PROFILE_HI_STOP(5);
+        assert(cnt1 == int(count(out.begin(), out.begin() + primes.size(), 1)));
+    }
+}
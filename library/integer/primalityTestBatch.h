@@ -0,0 +1,317 @@
+#pragma once
+
+#include "../common/cpuFeature.h"
+#include "montgomery64.h"
+#include "primalityTestInt32.h"
+#include "primalityTestInt64.h"
+
+/*
+  Batch primality test, the same hashed-base Miller-Rabin tests as PrimalityTestInt32 / PrimalityTestInt64
+  (the results are the same as the scalar ones)
+
+  - small primes (<= 53) are trial-divided first, only the survivors are tested
+  - 32-bit : 8 numbers per AVX2 vector, Montgomery multiplication in 32-bit lanes (each lane has its own modulus)
+  - 64-bit : numbers < 2^32 go to the 32-bit path, the others run in groups of 4 interleaved Montgomery chains
+             (AVX2 has no 64 x 64 -> 128 bit multiplication, 4 independent scalar chains hide the latency instead)
+  - AVX2 is selected at runtime (CpuFeature::hasAVX2()), there is a scalar fallback
+
+  <How to use>
+    vector<unsigned int> in = ...;
+    vector<unsigned char> out(in.size());
+    PrimalityTestBatch::isPrimeBatch(in.data(), int(in.size()), out.data());
+*/
+struct PrimalityTestBatch {
+    typedef unsigned long long u64;
+
+    static const int LANES32 = 8;
+    static const int LANES64 = 4;
+
+    // out[i] = PrimalityTestInt32::isPrimeNumber(in[i])
+    static void isPrimeBatch(const unsigned int* in, int n, unsigned char* out) {
+        Pending32 pending;
+        for (int i = 0; i < n; i++) {
+            unsigned int x = in[i];
+            if (x < SMALL_LIMIT)
+                out[i] = PrimalityTestInt32::isPrimeNumber(x);
+            else if (hasSmallFactor(x))
+                out[i] = 0;
+            else
+                pending.push(x, out + i);
+        }
+        pending.flush();
+    }
+
+    // out[i] = PrimalityTestInt64::isPrimeNumber(in[i])
+    static void isPrimeBatch(const u64* in, int n, unsigned char* out) {
+        Pending32 pending32;
+        Pending64 pending64;
+        for (int i = 0; i < n; i++) {
+            u64 x = in[i];
+            if (x < SMALL_LIMIT)
+                out[i] = PrimalityTestInt64::isPrimeNumber(x);
+            else if (hasSmallFactor(x))
+                out[i] = 0;
+            else if (x >> 32 == 0)
+                pending32.push(static_cast<unsigned int>(x), out + i);
+            else
+                pending64.push(x, out + i);
+        }
+        pending32.flush();
+        pending64.flush();
+    }
+
+private:
+    static const unsigned SMALL_LIMIT = 59 * 59;    // no prime factor <= 53 and x < 59^2 : x is prime
+
+    template <typename T>
+    static bool hasSmallFactor(T x) {
+        return x % 2 == 0 || x % 3 == 0 || x % 5 == 0 || x % 7 == 0 || x % 11 == 0 || x % 13 == 0
+            || x % 17 == 0 || x % 19 == 0 || x % 23 == 0 || x % 29 == 0 || x % 31 == 0 || x % 37 == 0
+            || x % 41 == 0 || x % 43 == 0 || x % 47 == 0 || x % 53 == 0;
+    }
+
+    //--- 32-bit ---
+
+    struct Pending32 {
+        unsigned int x[LANES32];
+        unsigned char* out[LANES32];
+        int count = 0;
+
+        void push(unsigned int v, unsigned char* o) {
+            x[count] = v;
+            out[count] = o;
+            if (++count == LANES32)
+                flush();
+        }
+
+        void flush() {
+            if (count == 0)
+                return;
+            for (int i = count; i < LANES32; i++)
+                x[i] = x[0];
+
+            // odd n >= 59^2, the base of each lane is reduced to [0, n)
+            alignas(32) unsigned int n[LANES32], nInv[LANES32], r1[LANES32], r2[LANES32], a[LANES32], d[LANES32], s[LANES32];
+            for (int i = 0; i < LANES32; i++) {
+                unsigned int v = x[i];
+                n[i] = v;
+                unsigned int inv = v;
+                for (int j = 0; j < 4; j++)
+                    inv *= 2 - v * inv;
+                nInv[i] = inv;
+                r1[i] = (0u - v) % v;
+                r2[i] = static_cast<unsigned int>(1ull * r1[i] * r1[i] % v);
+                a[i] = PrimalityTestInt32::getBaseOf(v) % v;
+                d[i] = (v - 1) >> ctz32(v - 1);
+                s[i] = ctz32(v - 1);
+            }
+
+            alignas(32) unsigned int res[LANES32];
+            if (CpuFeature::hasAVX2())
+                sprpAVX2(n, nInv, r1, r2, a, d, s, res);
+            else {
+                for (int i = 0; i < LANES32; i++)
+                    res[i] = sprpScalar(n[i], nInv[i], r1[i], r2[i], a[i], d[i], s[i]);
+            }
+
+            for (int i = 0; i < count; i++)
+                *out[i] = res[i] ? 1 : 0;
+            count = 0;
+        }
+    };
+
+    static int ctz32(unsigned int x) {
+#ifndef __GNUC__
+        unsigned long idx;
+        _BitScanForward(&idx, x);
+        return int(idx);
+#else
+        return __builtin_ctz(x);
+#endif
+    }
+
+    // a * b * 2^-32 mod n, fully reduced
+    static unsigned int mulMont32(unsigned int a, unsigned int b, unsigned int n, unsigned int nInv) {
+        u64 t = 1ull * a * b;
+        unsigned int m = static_cast<unsigned int>(t) * nInv;
+        unsigned int hiT = static_cast<unsigned int>(t >> 32);
+        unsigned int hiMN = static_cast<unsigned int>((1ull * m * n) >> 32);
+        return hiT >= hiMN ? hiT - hiMN : hiT - hiMN + n;
+    }
+
+    static bool sprpScalar(unsigned int n, unsigned int nInv, unsigned int r1, unsigned int r2,
+                           unsigned int a, unsigned int d, unsigned int s) {
+        unsigned int base = mulMont32(a, r2, n, nInv);
+        unsigned int x = r1;
+        for (; d; d >>= 1) {
+            if (d & 1)
+                x = mulMont32(x, base, n, nInv);
+            base = mulMont32(base, base, n, nInv);
+        }
+
+        unsigned int minusOne = n - r1;
+        if (x == r1 || x == minusOne)
+            return true;
+        for (unsigned int r = 1; r < s; r++) {
+            x = mulMont32(x, x, n, nInv);
+            if (x == minusOne)
+                return true;
+        }
+        return false;
+    }
+
+    // 8 lanes, nO / nInvO : n and nInv of the odd lanes moved to the low halves
+    TARGET_AVX2
+    static __m256i mulMontAVX2(__m256i a, __m256i b, __m256i n, __m256i nInv, __m256i nO, __m256i nInvO) {
+        __m256i tE = _mm256_mul_epu32(a, b);
+        __m256i tO = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i mnE = _mm256_mul_epu32(_mm256_mul_epu32(tE, nInv), n);
+        __m256i mnO = _mm256_mul_epu32(_mm256_mul_epu32(tO, nInvO), nO);
+        __m256i hiT = _mm256_blend_epi32(_mm256_srli_epi64(tE, 32), tO, 0xAA);
+        __m256i hiMN = _mm256_blend_epi32(_mm256_srli_epi64(mnE, 32), mnO, 0xAA);
+        __m256i noBorrow = _mm256_cmpeq_epi32(_mm256_max_epu32(hiT, hiMN), hiT);
+        return _mm256_add_epi32(_mm256_sub_epi32(hiT, hiMN), _mm256_andnot_si256(noBorrow, n));
+    }
+
+    TARGET_AVX2
+    static void sprpAVX2(const unsigned int* nArr, const unsigned int* nInvArr, const unsigned int* r1Arr, const unsigned int* r2Arr,
+                         const unsigned int* aArr, const unsigned int* dArr, const unsigned int* sArr, unsigned int* res) {
+        __m256i n = _mm256_load_si256(reinterpret_cast<const __m256i*>(nArr));
+        __m256i nInv = _mm256_load_si256(reinterpret_cast<const __m256i*>(nInvArr));
+        __m256i nO = _mm256_srli_epi64(n, 32);
+        __m256i nInvO = _mm256_srli_epi64(nInv, 32);
+        __m256i r1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(r1Arr));
+        __m256i d = _mm256_load_si256(reinterpret_cast<const __m256i*>(dArr));
+        __m256i s = _mm256_load_si256(reinterpret_cast<const __m256i*>(sArr));
+        __m256i one = _mm256_set1_epi32(1);
+
+        __m256i base = mulMontAVX2(_mm256_load_si256(reinterpret_cast<const __m256i*>(aArr)),
+                                   _mm256_load_si256(reinterpret_cast<const __m256i*>(r2Arr)), n, nInv, nO, nInvO);
+
+        // x = a^d, right-to-left over the bits of each lane's exponent
+        __m256i x = r1;
+        while (!_mm256_testz_si256(d, d)) {
+            __m256i bit = _mm256_cmpeq_epi32(_mm256_and_si256(d, one), one);
+            x = _mm256_blendv_epi8(x, mulMontAVX2(x, base, n, nInv, nO, nInvO), bit);
+            base = mulMontAVX2(base, base, n, nInv, nO, nInvO);
+            d = _mm256_srli_epi32(d, 1);
+        }
+
+        __m256i minusOne = _mm256_sub_epi32(n, r1);
+        __m256i ok = _mm256_or_si256(_mm256_cmpeq_epi32(x, r1), _mm256_cmpeq_epi32(x, minusOne));
+        for (int r = 1; r < 32; r++) {
+            __m256i active = _mm256_cmpgt_epi32(s, _mm256_set1_epi32(r));
+            if (_mm256_testz_si256(active, _mm256_xor_si256(ok, _mm256_set1_epi32(-1))))
+                break;
+            x = mulMontAVX2(x, x, n, nInv, nO, nInvO);
+            ok = _mm256_or_si256(ok, _mm256_and_si256(active, _mm256_cmpeq_epi32(x, minusOne)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(res), ok);
+    }
+
+    //--- 64-bit ---
+
+    struct Pending64 {
+        u64 x[LANES64];
+        unsigned char* out[LANES64];
+        int count = 0;
+
+        void push(u64 v, unsigned char* o) {
+            x[count] = v;
+            out[count] = o;
+            if (++count == LANES64)
+                flush();
+        }
+
+        // PrimalityTestInt64 : base 2, then the two hashed bases
+        void flush() {
+            if (count == 0)
+                return;
+            for (int i = count; i < LANES64; i++)
+                x[i] = x[0];
+
+            Montgomery64 mont[LANES64];
+            u64 a[LANES64];
+            bool res[LANES64];
+            for (int i = 0; i < LANES64; i++) {
+                mont[i].init(x[i]);
+                a[i] = 2;
+            }
+            sprp64(mont, a, res);
+
+            bool any = false;
+            unsigned int b[LANES64];
+            for (int i = 0; i < LANES64; i++) {
+                b[i] = PrimalityTestInt64::getBasesOf(x[i]);
+                any |= res[i];
+            }
+            for (int k = 0; k < 2 && any; k++) {
+                bool res2[LANES64];
+                for (int i = 0; i < LANES64; i++)
+                    a[i] = (k == 0) ? (b[i] & 4095) : (b[i] >> 12);
+                sprp64(mont, a, res2);
+                any = false;
+                for (int i = 0; i < LANES64; i++) {
+                    res[i] = res[i] && res2[i];
+                    any |= res[i];
+                }
+            }
+
+            for (int i = 0; i < count; i++)
+                *out[i] = res[i] ? 1 : 0;
+            count = 0;
+        }
+    };
+
+    // PrimalityTestInt64::isSPRP() of 4 numbers in lockstep
+    static void sprp64(const Montgomery64* mont, const u64* a, bool* res) {
+        u64 d[LANES64], x[LANES64], base[LANES64], minusOne[LANES64];
+        int s[LANES64];
+        bool done[LANES64];
+
+        u64 dOr = 0;
+        int maxS = 0;
+        for (int i = 0; i < LANES64; i++) {
+            u64 n = mont[i].n;
+            done[i] = false;
+            if (n == a[i]) {
+                res[i] = done[i] = true;
+            } else if (n % a[i] == 0) {
+                res[i] = false;
+                done[i] = true;
+            }
+            s[i] = 0;
+            d[i] = n - 1;
+            while (!(d[i] & 1)) {
+                d[i] >>= 1;
+                s[i]++;
+            }
+            dOr |= d[i];
+            maxS = max(maxS, s[i]);
+            base[i] = mont[i].toMontgomery(a[i]);
+            x[i] = mont[i].r1;
+            minusOne[i] = n - mont[i].r1;
+        }
+
+        for (; dOr; dOr >>= 1) {
+            for (int i = 0; i < LANES64; i++) {
+                u64 t = mont[i].mul(x[i], base[i]);
+                x[i] = (d[i] & 1) ? t : x[i];
+                base[i] = mont[i].mul(base[i], base[i]);
+                d[i] >>= 1;
+            }
+        }
+
+        for (int i = 0; i < LANES64; i++) {
+            if (!done[i])
+                res[i] = (x[i] == mont[i].r1 || x[i] == minusOne[i]);
+        }
+        for (int r = 1; r < maxS; r++) {
+            for (int i = 0; i < LANES64; i++) {
+                x[i] = mont[i].mul(x[i], x[i]);
+                if (!done[i] && r < s[i] && x[i] == minusOne[i])
+                    res[i] = true;
+            }
+        }
+    }
+};
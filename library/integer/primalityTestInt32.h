@@ -10,11 +10,7 @@ struct PrimalityTestInt32 {
             return false;
         if (x < 121)
             return x > 1;
-        unsigned long long h = x;
-        h = ((h >> 16) ^ h) * 0x45d9f3b;
-        h = ((h >> 16) ^ h) * 0x45d9f3b;
-        h = ((h >> 16) ^ h) & 255;
-        return isSPRP(x, getBase(static_cast<unsigned int>(h)));
+        return isSPRP(x, getBaseOf(x));
     }
 
     static bool isPrimeNumber(int x) {
@@ -22,6 +18,17 @@ struct PrimalityTestInt32 {
     }
 
 private:
+    friend struct PrimalityTestBatch;
+
+    // the hashed single base of x
+    static unsigned int getBaseOf(unsigned int x) {
+        unsigned long long h = x;
+        h = ((h >> 16) ^ h) * 0x45d9f3b;
+        h = ((h >> 16) ^ h) * 0x45d9f3b;
+        h = ((h >> 16) ^ h) & 255;
+        return getBase(static_cast<unsigned int>(h));
+    }
+
     static unsigned int getBase(unsigned int h) {
         static unsigned short bases[] = {
             15591,2018,166,7429,8064,16045,10503,4399,1949,1295,2776,3620,560,3128,5212,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "montgomery64.h"
+
 // "Fast Primality Testing for Integers That Fit into a Machine Word"
 // https://people.ksp.sk/~misof/primes/FJ64_16k.cc
 struct PrimalityTestInt64 {
@@ -11,15 +13,16 @@ struct PrimalityTestInt64 {
         if (x < 121)
             return (x > 1);
 
-        if (!isSPRP(x, 2))
+        return isPrimeNumber(Montgomery64(x));
+    }
+
+    // with a Montgomery context shared with the caller (ex: Pollard's rho), n = mont.n is odd and n >= 121
+    static bool isPrimeNumber(const Montgomery64& mont) {
+        if (!isSPRP(mont, 2))
             return false;
 
-        unsigned long long h = x;
-        h = ((h >> 32) ^ h) * 0x45d9f3b3335b369ull;
-        h = ((h >> 32) ^ h) * 0x3335b36945d9f3bull;
-        h = ((h >> 32) ^ h);
-        unsigned int b = getBase(static_cast<unsigned int>(h & 16383));
-        return isSPRP(x, b & 4095) && isSPRP(x, b >> 12);
+        unsigned int b = getBasesOf(mont.n);
+        return isSPRP(mont, b & 4095) && isSPRP(mont, b >> 12);
     }
 
     static bool isPrimeNumber(long long x) {
@@ -27,6 +30,17 @@ struct PrimalityTestInt64 {
     }
 
 private:
+    friend struct PrimalityTestBatch;
+
+    // the hashed bases of x, (b & 4095) and (b >> 12)
+    static unsigned int getBasesOf(unsigned long long x) {
+        unsigned long long h = x;
+        h = ((h >> 32) ^ h) * 0x45d9f3b3335b369ull;
+        h = ((h >> 32) ^ h) * 0x3335b36945d9f3bull;
+        h = ((h >> 32) ^ h);
+        return getBase(static_cast<unsigned int>(h & 16383));
+    }
+
     static unsigned int getBase(unsigned int h) {
         static unsigned int bases[] = {
             2404423, 3027617, 3715179, 3264583, 1593555, 5853461, 1552463, 1896881, 2904107, 5600043,
@@ -1399,56 +1413,12 @@ private:
         return bases[h];
     }
 
-    static unsigned long long mulMod(unsigned long long a, unsigned long long b, unsigned long long M) {
-#ifndef __GNUC__
-        unsigned long long x = 0, y = a % M;
-        while (b > 0) {
-            if (b & 1)
-                x = (x + y) % M;
-
-            y = (y << 1) % M;
-            b >>= 1;
-        }
-        return x % M;
-#else
-        return static_cast<unsigned long long>(__uint128_t(a) * b % M);
-#endif
-    }
-
-    static unsigned long long power(unsigned long long a, unsigned long long x, unsigned long long p) {
-        unsigned long long res = 1;
-
-        a = a % p;
-        while (x > 0) {
-            if (x & 1)
-                res = mulMod(res, a, p);
-            x >>= 1;
-            a = mulMod(a, a, p);
-        }
-
-        return res;
-    }
-
     // given 2 <= n,a < 2^64, a prime, check whether n is a-SPRP
-    static bool isSPRP(unsigned long long n, unsigned long long a) {
-        if (n == a)
+    static bool isSPRP(const Montgomery64& mont, unsigned long long a) {
+        if (mont.n == a)
             return true;
-        if (n % a == 0)
+        if (mont.n % a == 0)
             return false;
-        unsigned long long d = n - 1;
-        int s = 0;
-        while (d % 2 == 0) {
-            s++;
-            d /= 2;
-        }
-        unsigned long long cur = power(a, d, n);
-        if (cur == 1)
-            return true;
-        for (int r = 0; r<s; r++) {
-            if (cur == n - 1)
-                return true;
-            cur = mulMod(cur, cur, n);
-        }
-        return false;
+        return mont.isSPRP(a);
     }
 };
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#include "primeCounting.h"
+#include "primeNumberSegmentedSieve.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+// f(x) = x^2, mod 2^64
+struct PrimeSquareSumPolicy {
+    typedef unsigned long long T;
+    static const bool COUNTING = false;
+
+    T prefix(long long x) const {
+        if (x < 2)
+            return 0;
+        // x(x+1)(2x+1)/6 - 1
+        unsigned long long a = x, b = x + 1, c = 2 * x + 1;
+        if (a % 2 == 0) a /= 2; else b /= 2;
+        if (a % 3 == 0) a /= 3; else if (b % 3 == 0) b /= 3; else c /= 3;
+        return a * b * c - 1;
+    }
+
+    T value(long long x) const {
+        return T(x) * T(x);
+    }
+};
+
+static double elapsedSec(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+}
+
+void testPrimeCounting() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Prime Counting (Lucy_Hedgehog + Fenwick) ------------------------" << endl;
+    {
+        const long long N = 3'000'000;
+        vector<long long> cnt(N + 1);
+        vector<unsigned long long> sum(N + 1), sum2(N + 1);
+        SegmentedPrimeSieve::forEachPrime(0, N, [&](unsigned long long p) {
+            cnt[p]++;
+            sum[p] += p;
+            sum2[p] += p * p;
+        });
+        for (int i = 1; i <= N; i++) {
+            cnt[i] += cnt[i - 1];
+            sum[i] += sum[i - 1];
+            sum2[i] += sum2[i - 1];
+        }
+
+        vector<long long> tests{ 0, 1, 2, 3, 4, 5, 8, 9, 10, 24, 25, 26, 100, 121, 1000, 65536, N };
+        for (int i = 0; i < 100; i++)
+            tests.push_back(RandInt32::get() % (N + 1));
+        for (long long n : tests) {
+            assert(primeCount(n) == cnt[n]);
+            assert(primeSum(n) == sum[n]);
+
+            for (int threadN : { 1, 3 }) {
+                PrimePrefixSum<PrimeSquareSumPolicy> lucy;
+                lucy.build(n, PrimeSquareSumPolicy(), threadN);
+                for (long long k = 1; k <= n; k = n / (n / k) + 1)
+                    assert(lucy.get(n / k) == sum2[n / k]);
+            }
+        }
+
+        // against the segmented sieve
+        for (long long n : { 123'456'789ll, 1'000'000'000ll }) {
+            unsigned long long s = 0;
+            SegmentedPrimeSieve::forEachPrime(0, n, [&s](unsigned long long p) { s += p; });
+            assert(primeCount(n, 2) == (long long)SegmentedPrimeSieve::countPrimes(0, n));
+            assert(primeSum(n, 2) == s);
+        }
+
+        assert(primeCount(1'000'000'000'000ll, 3) == 37607912018ll);    // the parallel paths
+    }
+    cout << "OK!" << endl;
+    {
+        cout << "*** Speed test: pi(n) ***" << endl;
+
+        for (long long n : { 10'000'000'000ll, 1'000'000'000'000ll, 10'000'000'000'000ll }) {
+            for (int threadN = 1; threadN <= Parallel::threadCount(); threadN *= 2) {
+                auto start = chrono::high_resolution_clock::now();
+                long long cnt = primeCount(n, threadN);
+                double t1 = elapsedSec(start);
+
+                start = chrono::high_resolution_clock::now();
+                unsigned long long sum = primeSum(n, threadN);
+                double t2 = elapsedSec(start);
+
+                cout << "  n = " << n << ", threads = " << threadN << " : pi(n) = " << cnt << " (" << t1 << " sec)"
+                     << ", sum mod 2^64 = " << sum << " (" << t2 << " sec)" << endl;
+            }
+        }
+    }
+}
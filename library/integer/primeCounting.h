@@ -0,0 +1,295 @@
+#pragma once
+
+#include "bit.h"
+#include "../common/parallel.h"
+
+/*
+  Sublinear prime counting / prime sums (Lucy_Hedgehog with a Fenwick tree over a partial sieve)
+
+    S(v) = SUM f(p), for all primes p <= v, where f is completely multiplicative
+
+  - the values n / k are split at y ~ n^(2/3)
+    1) 'large' table : S(n / k) for n / k > y, updated by the Lucy recurrence for each prime p <= sqrt(n)
+    2) 'small' table : an odd-only bitset of [1, y] partially sieved by the primes processed so far,
+                       with a Fenwick tree over 64-bit words, S(x <= y) is a prefix query
+  - time complexity : O(n^(2/3) * (log n)^(1/3))-class, memory : O(n^(2/3) / 64) words + O(n^(1/3))
+  - on multiple threads : the large-table updates of each prime whose reads land in the small table,
+                          and the partial sieving of dense primes (bit clearing and Fenwick rebuild)
+
+  <Policy>
+    struct Policy {
+        typedef ... T;
+        static const bool COUNTING = false;     // true : f(x) = 1, word sums are popcounts
+        T prefix(long long x) const;            // SUM_{i=2..x} f(i)
+        T value(long long x) const;             // f(x)
+    };
+
+  <How to use>
+    long long cnt = primeCount(10'000'000'000'000ll);
+    unsigned long long sum = primeSum(n);               // mod 2^64
+
+    PrimePrefixSum<PrimeSumPolicy<ModInt>> lucy;        // all S(n / k) values
+    lucy.build(n, PrimeSumPolicy<ModInt>(), 0);
+    auto s = lucy.get(n / 3);
+*/
+
+// f(x) = 1
+struct PrimeCountPolicy {
+    typedef long long T;
+    static const bool COUNTING = true;
+
+    T prefix(long long x) const {
+        return x >= 2 ? x - 1 : 0;
+    }
+
+    T value(long long) const {
+        return 1;
+    }
+};
+
+// f(x) = x, in T (mod 2^64 with unsigned long long, or any modular type)
+template <typename ValueT = unsigned long long>
+struct PrimeSumPolicy {
+    typedef ValueT T;
+    static const bool COUNTING = false;
+
+    T prefix(long long x) const {
+        if (x < 2)
+            return T(0);
+        long long a = x, b = x + 1;
+        if (a & 1)
+            b >>= 1;
+        else
+            a >>= 1;
+        return T(a) * T(b) - T(1);
+    }
+
+    T value(long long x) const {
+        return T(x);
+    }
+};
+
+template <typename Policy>
+struct PrimePrefixSum {
+    typedef typename Policy::T T;
+    typedef unsigned long long u64;
+
+    Policy policy;
+    long long n;
+    long long y;                // the small table covers [1, y]
+    int L;                      // the large table covers n / k for k in [1, L]
+    vector<T> large;            // large[k] = S(n / k)
+    vector<long long> largeV;   // largeV[k] = n / k
+    vector<u64> bits;           // bit i = (2i + 1) survives
+    vector<T> tree;             // Fenwick tree over the words of 'bits'
+    T f2;                       // f(2)
+    int threadN;
+
+    // threadN = 0 : all hardware threads
+    void build(long long n, const Policy& policy = Policy(), int threadN = 1) {
+        this->policy = policy;
+        this->n = n;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+        this->threadN = threadN;
+
+        long long sq = isqrt(n);
+        y = max(sq, (long long)(SMALL_TABLE_FACTOR * cbrt(double(n) * n)));
+        y = min(y, n);
+        L = int(n / (y + 1));
+        f2 = policy.value(2);
+
+        // bits = odd numbers >= 3, the multiples of 2 are already sieved out
+        long long oddN = (y + 1) / 2;                   // bit count
+        int wordN = int((oddN + 63) / 64);
+        bits.assign(max(wordN, 1), ~0ull);
+        bits[0] &= ~1ull;
+        if (oddN % 64)
+            bits[wordN - 1] &= (1ull << (oddN % 64)) - 1;
+        if (oddN == 0)
+            bits[0] = 0;
+        rebuildTree();
+
+        large.assign(L + 1, T(0));
+        largeV.assign(L + 1, 0);
+        for (int k = 1; k <= L; k++) {
+            largeV[k] = n / k;
+            large[k] = policy.prefix(largeV[k]);
+        }
+
+        // p = 2 : S(v) -= f(2) * (S(v / 2) - S(1))
+        if (n >= 4) {
+            int kMax = int(min<long long>(L, n / 4));
+            int seqMax = min(kMax, L / 2);
+            for (int k = 1; k <= seqMax; k++)
+                large[k] -= f2 * large[2 * k];
+            Parallel::forRange(seqMax + 1, kMax + 1, rangeThreadN(kMax - seqMax, threadN), [this](int lo, int hi) {
+                for (int k = lo; k < hi; k++)
+                    large[k] -= f2 * this->policy.prefix(largeV[k] >> 1);
+            });
+        }
+
+        // odd primes p <= sqrt(n), taken from the partial sieve
+        T pre = f2;                                     // S(p - 1)
+        for (long long p = nextSurvivor(1); p > 0 && p <= sq; p = nextSurvivor(p)) {
+            T fp = policy.value(p);
+
+            int kMax = int(min<long long>(L, n / (p * p)));
+            int seqMax = int(min<long long>(kMax, L / p));
+            for (int k = 1; k <= seqMax; k++)
+                large[k] -= fp * (large[k * p] - pre);
+            double invP = 1.0 / p;
+            Parallel::forRange(seqMax + 1, kMax + 1, rangeThreadN(kMax - seqMax, threadN), [this, p, invP, fp, pre](int lo, int hi) {
+                for (int k = lo; k < hi; k++)
+                    large[k] -= fp * (querySmall(divide(largeV[k], p, invP)) - pre);
+            });
+
+            if (p * p <= y)
+                sieveSmall(p);
+            pre += fp;
+        }
+    }
+
+    // S(v), v = n / k for some k, or v <= y
+    T get(long long v) const {
+        if (v > y)
+            return large[n / v];
+        return querySmall(v);
+    }
+
+    // floor(sqrt(x))
+    static long long isqrt(long long x) {
+        long long r = (long long)sqrt(double(x));
+        while (r > 0 && r * r > x)
+            r--;
+        while ((r + 1) * (r + 1) <= x)
+            r++;
+        return r;
+    }
+
+private:
+    static constexpr double SMALL_TABLE_FACTOR = 0.5;   // y = SMALL_TABLE_FACTOR * n^(2/3)
+    static const int PARALLEL_THRESHOLD = 1 << 14;      // minimum updates per prime to use threads
+
+    static int rangeThreadN(int n, int threadN) {
+        return n >= PARALLEL_THRESHOLD ? threadN : 1;
+    }
+
+    // floor(a / p) without a 64-bit division, a / p < 2^52
+    static long long divide(long long a, long long p, double invP) {
+        long long q = (long long)(a * invP);
+        if (q * p > a)
+            q--;
+        else if ((q + 1) * p <= a)
+            q++;
+        return q;
+    }
+
+    // SUM f(x) over the set bits of 'word', bit b = firstOdd + 2b
+    T wordSum(u64 word, long long firstOdd) const {
+        if (Policy::COUNTING)
+            return T(popcount(word));
+        T res = T(0);
+        while (word) {
+            res += policy.value(firstOdd + 2 * ctz(word));
+            word &= word - 1;
+        }
+        return res;
+    }
+
+    static int wordCost() {
+        return Policy::COUNTING ? 1 : 8;
+    }
+
+    void rebuildTree() {
+        int wordN = int(bits.size());
+        tree.resize(wordN);
+        Parallel::forRange(0, wordN, rangeThreadN(wordN, threadN), [this](int lo, int hi) {
+            for (int i = lo; i < hi; i++)
+                tree[i] = wordSum(bits[i], 128ll * i + 1);
+        });
+        for (int i = 0; i < wordN; i++) {
+            int j = i | (i + 1);
+            if (j < wordN)
+                tree[j] += tree[i];
+        }
+    }
+
+    // S(x) with the primes processed so far, x <= y
+    T querySmall(long long x) const {
+        if (x < 2)
+            return T(0);
+
+        long long idx = (x - 1) >> 1;                   // the last odd number's bit
+        int w = int(idx >> 6);
+        T res = f2 + wordSum(bits[w] & (~0ull >> (63 - (idx & 63))), 128ll * w + 1);
+        for (int i = w - 1; i >= 0; i = (i & (i + 1)) - 1)
+            res += tree[i];
+        return res;
+    }
+
+    void sieveSmall(long long p) {
+        int wordN = int(bits.size());
+        long long oddN = (y + 1) / 2;
+        long long start = (p * p - 1) / 2;
+
+        // dense primes : clear the bits and rebuild the tree in O(y / 64)
+        long long removals = (oddN - start) / p;
+        if (removals * log2Int(unsigned(wordN) | 1) > (long long)wordN * wordCost()) {
+            Parallel::forRange(int(start >> 6), wordN, rangeThreadN(wordN - int(start >> 6), threadN), [this, p, start, oddN](int lo, int hi) {
+                long long i = max(start, 64ll * lo);
+                i += (p - (i - start) % p) % p;
+                for (long long end = min(oddN, 64ll * hi); i < end; i += p)
+                    bits[i >> 6] &= ~(1ull << (i & 63));
+            });
+            rebuildTree();
+            return;
+        }
+
+        for (long long i = start; i < oddN; i += p) {
+            u64 mask = 1ull << (i & 63);
+            int w = int(i >> 6);
+            if (bits[w] & mask) {
+                bits[w] &= ~mask;
+                T v = policy.value(2 * i + 1);
+                for (int j = w; j < wordN; j |= j + 1)
+                    tree[j] -= v;
+            }
+        }
+    }
+
+    // the next survivor after odd x, or 0
+    long long nextSurvivor(long long x) const {
+        long long i = (x - 1) / 2 + 1;
+        long long oddN = (y + 1) / 2;
+        if (i >= oddN)
+            return 0;
+        int w = int(i >> 6);
+        u64 word = bits[w] & (~0ull << (i & 63));
+        while (!word) {
+            if (++w >= int(bits.size()))
+                return 0;
+            word = bits[w];
+        }
+        return 2 * (64ll * w + ctz(word)) + 1;
+    }
+};
+
+// the number of primes <= n
+inline long long primeCount(long long n, int threadN = 1) {
+    if (n < 2)
+        return 0;
+    PrimePrefixSum<PrimeCountPolicy> lucy;
+    lucy.build(n, PrimeCountPolicy(), threadN);
+    return lucy.get(n);
+}
+
+// the sum of primes <= n, in T
+template <typename T = unsigned long long>
+inline T primeSum(long long n, int threadN = 1) {
+    if (n < 2)
+        return T(0);
+    PrimePrefixSum<PrimeSumPolicy<T>> lucy;
+    lucy.build(n, PrimeSumPolicy<T>(), threadN);
+    return lucy.get(n);
+}
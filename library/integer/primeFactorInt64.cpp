@@ -15,6 +15,7 @@ using namespace std;
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <chrono>
 #include "../common/iostreamhelper.h"
 #include "../common/profile.h"
 #include "../common/rand.h"
@@ -22,6 +23,189 @@ using namespace std;
 #include "primalityTest.h"
 #include "primeNumberBasic.h"
 
+// the previous implementation (bit-serial mulMod, a gcd on every step), for the speed test
+struct PrimeFactorizerInt64Old {
+    int N;
+    SmallestPrimeFactors spf;
+
+    void init(int n) {
+        N = n;
+        spf.build(N);
+    }
+
+    vector<pair<long long, int>> factorize(long long n) {
+        vector<pair<long long, int>> ans;
+
+        if (n <= 1)
+            return ans;
+
+        vector<long long> temp;
+        while (n % 2 == 0) {
+            temp.push_back(2);
+            n >>= 1;
+        }
+
+        int m = 0;
+        vector<long long> s(70);
+
+        pollardRho(n, m, s);
+        for (int i = 0; i < m; i++) {
+            temp.push_back(s[i]);
+        }
+        sort(temp.begin(), temp.end());
+
+        for (int i = 0; i < int(temp.size()); ++i) {
+            int j = i, e = 0;
+            while (j < int(temp.size()) && temp[j] == temp[i]) {
+                e += 1;
+                j += 1;
+            }
+            ans.push_back({ temp[i], e });
+            i = j - 1;
+        }
+        return ans;
+    }
+
+protected:
+    void pollardRho(long long n, int& m, vector<long long>& s) {
+        long long x;
+        if (n == 1)
+            return;
+
+        if (n <= N) {
+            while (n != 1) {
+                int p = spf.spf[int(n)];
+                while (n % p == 0) {
+                    n /= p;
+                    s[m++] = p;
+                }
+            }
+            return;
+        }
+
+        while (!millerRabin(n)) {
+            int c;
+            for (c = 1, x = n; x == n; c = 1 + randInt() % (n - 1)) {
+                x = go(n, c);
+            }
+            if (x < 0)
+                break;
+            n /= x;
+            pollardRho(x, m, s);
+        }
+        if (n > 1)
+            s[m++] = n;
+    }
+
+    bool millerRabin(long long n) {
+        if (n <= N)
+            return spf.spf[int(n)] == n;
+        return !witness(28087, n);
+    }
+
+    static long long func(long long x, long long n, int c) {
+        long long res = mulMod(x, x, n) + c;
+        return (res >= n ? res % n : res);
+    }
+
+    static long long go(long long n, int c) {
+        long long x, y, d = 1;
+        x = y = rand() & 0x7fff;
+        if (x >= n) {
+            x %= n;
+            y %= n;
+        }
+        while (d == 1) {
+            x = func(x, n, c);
+            y = func(func(y, n, c), n, c);
+            d = gcd(abs(y - x), n);
+        }
+        if (d != n)
+            return d;
+        return d;
+    }
+
+private:
+    static long long randLL() {
+        return (rand() & 0x7fff) * (1ll << 48)
+             + (rand() & 0x7fff) * (1ll << 32)
+             + (rand() & 0x7fff) * (1ll << 16)
+             + (rand() & 0x7fff);
+    }
+
+    static int randInt() {
+        return (rand() & 0x7fff) * (rand() & 0x7fff);
+    }
+
+    static long long gcd(long long p, long long q) {
+        return q == 0 ? p : gcd(q, p % q);
+    }
+
+    static long long mulMod(long long a, long long b, long long M) {
+        long long x = 0, y = a % M;
+        while (b > 0) {
+            if (b & 1)
+                x = (x + y) % M;
+
+            y = (y << 1) % M;
+            b >>= 1;
+        }
+        return x % M;
+    }
+
+    static long long power(long long a, long long x, long long M) {
+        long long res = 1;
+
+        a = a % M;
+        while (x > 0) {
+            if (x & 1)
+                res = static_cast<long long>(mulMod(res, a, M));
+
+            x >>= 1;
+            a = static_cast<long long>(mulMod(a, a, M));
+        }
+
+        return res;
+    }
+
+    static bool witness(long long a, long long n) {
+        long long x, y, u = n - 1, t = 0;
+        while (u % 2 == 0) {
+            u >>= 1;
+            t += 1;
+        }
+        x = power(a, u, n);
+        while (t--) {
+            y = x;
+            x = power(x, 2, n);
+            if (x == 1 && y != 1 && y != n - 1)
+                return 1;
+        }
+        return x != 1;
+    }
+};
+
+static unsigned long long getRandomPrime(int bits) {
+    while (true) {
+        unsigned long long x = ((unsigned long long)RandInt64::get() >> (64 - bits)) | (1ull << (bits - 1)) | 1;
+        if (PrimalityTestInt64::isPrimeNumber(x))
+            return x;
+    }
+}
+
+static bool checkFactorization(unsigned long long x, const vector<pair<unsigned long long, int>>& f) {
+    unsigned long long prod = 1;
+    for (int i = 0; i < int(f.size()); i++) {
+        if (!PrimalityTestInt64::isPrimeNumber(f[i].first) || f[i].second <= 0)
+            return false;
+        if (i > 0 && f[i - 1].first >= f[i].first)
+            return false;
+        for (int j = 0; j < f[i].second; j++)
+            prod *= f[i].first;
+    }
+    return prod == x;
+}
+
 static bool isPrimeNumber(long long x, const vector<long long>& primes) {
     int idx = 0;
     long long p = primes[0];
@@ -93,6 +277,66 @@ void testPrimeFactorInt64() {
             assert(gt == ans);
         }
     }
+    // Brent's rho + Montgomery : hard cases and the batch API
+    {
+        PrimeFactorizerInt64 pf;
+
+        vector<unsigned long long> in{
+            1, 2, 4, 97 * 97, 4294967291ull * 4294967279ull, 18446744073709551557ull,      // 2^64 - 59, prime
+            18446744073709551615ull, 999999999999999989ull, 1000000007ull * 1000000007ull,
+            3ull * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3 * 3,
+            2147483647ull * 2147483647ull * 3ull, 1099511627791ull * 16769023ull, 4611686018427387847ull * 3
+        };
+        for (int i = 0; i < 300; i++) {
+            int bits = 2 + RandInt32::get() % 31;
+            in.push_back(getRandomPrime(bits) * getRandomPrime(64 - bits));
+            in.push_back((unsigned long long)RandInt64::get());
+        }
+        for (int i = 0; i < 100; i++) {
+            unsigned long long p = getRandomPrime(21);
+            in.push_back(p * p * p);
+        }
+
+        auto gt = pf.factorize(in, 1);
+        for (int i = 0; i < int(in.size()); i++) {
+            if (in[i] >= 1 && !checkFactorization(in[i], gt[i]))
+                cout << "Invalid factorization : " << in[i] << endl;
+            assert(in[i] == 0 || checkFactorization(in[i], gt[i]));
+        }
+        for (int threadN : { 2, 3 })
+            assert(pf.factorize(in, threadN) == gt);
+    }
+    // speed test
+    {
+        cout << "-- Speed Test : 62-bit semiprimes (two 31-bit primes) ---" << endl;
+
+        int T = 100000;
+        vector<unsigned long long> in(T);
+        for (int i = 0; i < T; i++)
+            in[i] = getRandomPrime(31) * getRandomPrime(31);
+
+        PrimeFactorizerInt64 pf;
+        for (int threadN = 1; threadN <= Parallel::threadCount(); threadN *= 2) {
+            auto start = chrono::high_resolution_clock::now();
+            auto res = pf.factorize(in, threadN);
+            double sec = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+            for (int i = 0; i < T; i++)
+                assert(res[i].size() == 2 || (res[i].size() == 1 && res[i][0].second == 2));
+            cout << "  new, threads = " << threadN << " : " << T << " numbers in " << sec << " sec" << endl;
+        }
+
+        int oldT = 20;
+        PrimeFactorizerInt64Old pfOld;
+        pfOld.init(1000);
+        auto start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < oldT; i++) {
+            auto t = pfOld.factorize((long long)in[i]);
+            if (t.empty())
+                cout << "ERROR!" << endl;
+        }
+        double sec = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+        cout << "  old : " << oldT << " numbers in " << sec << " sec (" << sec * T / oldT << " sec for " << T << " numbers, estimated)" << endl;
+    }
     // speed test
     {
         cout << "-- Speed Test ---" << endl;
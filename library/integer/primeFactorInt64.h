@@ -1,9 +1,20 @@
 #pragma once
 
 #include "primeFactor.h"
-
+#include "montgomery64.h"
+#include "primalityTestInt64.h"
+#include "../common/parallel.h"
+
+// Prime factorization of 64-bit integers
+// - Pollard's rho with Brent's cycle detection, gcd of batched products (BATCH_SIZE steps per gcd)
+// - Montgomery multiplication, the Miller-Rabin test shares the Montgomery context (PrimalityTestInt64)
+// - init(n) is optional, numbers <= n are factorized with a smallest prime factor table
 struct PrimeFactorizerInt64 {
-    int N;
+    typedef unsigned long long u64;
+
+    static const int BATCH_SIZE = 128;
+
+    int N = 0;
     SmallestPrimeFactors spf;
 
     void init(int n) {
@@ -11,154 +22,154 @@ struct PrimeFactorizerInt64 {
         spf.build(N);
     }
 
-    vector<pair<long long, int>> factorize(long long n) {
+    // { (prime, exponent), ... } in increasing order
+    vector<pair<long long, int>> factorize(long long n) const {
         vector<pair<long long, int>> ans;
-
         if (n <= 1)
             return ans;
 
-        vector<long long> temp;
-        while (n % 2 == 0) {
-            temp.push_back(2);
-            n >>= 1;
-        }
-
-        int m = 0;
-        vector<long long> s(70);
+        for (auto& it : factorize(u64(n)))
+            ans.emplace_back((long long)it.first, it.second);
+        return ans;
+    }
 
-        pollardRho(n, m, s);
-        for (int i = 0; i < m; i++) {
-            temp.push_back(s[i]);
-        }
+    vector<pair<u64, int>> factorize(u64 n) const {
+        vector<u64> temp;
+        if (n > 1)
+            collect(n, temp);
         sort(temp.begin(), temp.end());
 
-        for (int i = 0; i < int(temp.size()); ++i) {
-            int j = i, e = 0;
-            while (j < int(temp.size()) && temp[j] == temp[i]) {
-                e += 1;
-                j += 1;
-            }
-            ans.push_back({ temp[i], e });
-            i = j - 1;
+        vector<pair<u64, int>> ans;
+        for (auto p : temp) {
+            if (!ans.empty() && ans.back().first == p)
+                ans.back().second++;
+            else
+                ans.emplace_back(p, 1);
         }
         return ans;
     }
 
-protected:
-    void pollardRho(long long n, int& m, vector<long long>& s) {
-        long long x;
-        if (n == 1)
-            return;
+    // factorizes all numbers, threadN = 0 : all hardware threads
+    vector<vector<pair<u64, int>>> factorize(const vector<u64>& in, int threadN = 1) const {
+        const int CHUNK_SIZE = 64;
+
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
 
-        if (n <= N) {
+        int n = int(in.size());
+        vector<vector<pair<u64, int>>> res(n);
+        Parallel::forEach((n + CHUNK_SIZE - 1) / CHUNK_SIZE, threadN, [&](int chunk) {
+            for (int i = chunk * CHUNK_SIZE, end = min(n, i + CHUNK_SIZE); i < end; i++)
+                res[i] = factorize(in[i]);
+        });
+        return res;
+    }
+
+private:
+    void collect(u64 n, vector<u64>& out) const {
+        static const int SMALL_PRIMES[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61 };
+        for (int p : SMALL_PRIMES) {
+            while (n % p == 0) {
+                out.push_back(p);
+                n /= p;
+            }
+        }
+        // no prime factor < 67
+        if (n > 1)
+            collectLarge(n, out);
+    }
+
+    void collectLarge(u64 n, vector<u64>& out) const {
+        if (n <= u64(N)) {
             while (n != 1) {
                 int p = spf.spf[int(n)];
                 while (n % p == 0) {
                     n /= p;
-                    s[m++] = p;
+                    out.push_back(p);
                 }
             }
             return;
         }
-
-        while (!millerRabin(n)) {
-            int c;
-            for (c = 1, x = n; x == n; c = 1 + randInt() % (n - 1)) {
-                x = go(n, c);
-            }
-            if (x < 0)
-                break;
-            n /= x;
-            pollardRho(x, m, s);
+        if (n < 67 * 67) {
+            out.push_back(n);
+            return;
         }
-        if (n > 1)
-            s[m++] = n;
-    }
-
-    bool millerRabin(long long n) {
-        if (n <= N)
-            return spf.spf[int(n)] == n;
-        return !witness(28087, n);
-    }
 
-    static long long func(long long x, long long n, int c) {
-        long long res = mulMod(x, x, n) + c;
-        return (res >= n ? res % n : res);
-    }
-
-    static long long go(long long n, int c) {
-        long long x, y, d = 1;
-        x = y = rand() & 0x7fff;
-        if (x >= n) {
-            x %= n;
-            y %= n;
-        }
-        while (d == 1) {
-            x = func(x, n, c);
-            y = func(func(y, n, c), n, c);
-            d = gcd(abs(y - x), n);
+        Montgomery64 mont(n);
+        if (PrimalityTestInt64::isPrimeNumber(mont)) {
+            out.push_back(n);
+            return;
         }
-        if (d != n)
-            return d;
-        return d;
-    }
-
-private:
-    static long long randLL() {
-        return (rand() & 0x7fff) * (1ll << 48)
-             + (rand() & 0x7fff) * (1ll << 32)
-             + (rand() & 0x7fff) * (1ll << 16)
-             + (rand() & 0x7fff);
-    }
 
-    static int randInt() {
-        return (rand() & 0x7fff) * (rand() & 0x7fff);
+        u64 d = rho(mont);
+        collectLarge(d, out);
+        collectLarge(n / d, out);
     }
 
-    static long long gcd(long long p, long long q) {
-        return q == 0 ? p : gcd(q, p % q);
-    }
-
-    static long long mulMod(long long a, long long b, long long M) {
-        long long x = 0, y = a % M;
-        while (b > 0) {
-            if (b & 1)
-                x = (x + y) % M;
-
-            y = (y << 1) % M;
-            b >>= 1;
+    // a nontrivial factor of composite odd n
+    static u64 rho(const Montgomery64& mont) {
+        u64 n = mont.n;
+        for (u64 c = mont.r1, x0 = 2; ; c = mont.add(c, mont.r1), x0++) {
+            u64 d = brent(mont, c, mont.toMontgomery(x0));
+            if (d != 1 && d != n)
+                return d;
         }
-        return x % M;
     }
 
-    static long long power(long long a, long long x, long long M) {
-        long long res = 1;
-
-        a = a % M;
-        while (x > 0) {
-            if (x & 1)
-                res = static_cast<long long>(mulMod(res, a, M));
+    // x -> x^2 + c, returns a divisor of n (1 or n on failure)
+    static u64 brent(const Montgomery64& mont, u64 c, u64 y) {
+        u64 n = mont.n;
+        u64 x = y, ys = y, q = mont.r1;
+        u64 g = 1;
+        for (u64 r = 1; g == 1; r <<= 1) {
+            x = y;
+            for (u64 i = 0; i < r; i++)
+                y = mont.add(mont.mul(y, y), c);
+            for (u64 k = 0; k < r && g == 1; k += BATCH_SIZE) {
+                ys = y;
+                for (u64 i = 0, m = min<u64>(BATCH_SIZE, r - k); i < m; i++) {
+                    y = mont.add(mont.mul(y, y), c);
+                    q = mont.mul(q, x > y ? x - y : y - x);
+                }
+                g = gcd(q, n);
+            }
+            if (r > (1ull << 40))       // no cycle found, try another c
+                return 1;
+        }
 
-            x >>= 1;
-            a = static_cast<long long>(mulMod(a, a, M));
+        // the batch hit 0 (mod n), backtrack one step at a time
+        if (g == n) {
+            do {
+                ys = mont.add(mont.mul(ys, ys), c);
+                g = gcd(x > ys ? x - ys : ys - x, n);
+            } while (g == 1);
         }
+        return g;
+    }
 
-        return res;
+    static u64 gcd(u64 a, u64 b) {
+        if (a == 0)
+            return b;
+        if (b == 0)
+            return a;
+        int shift = ctz(a | b);
+        a >>= ctz(a);
+        do {
+            b >>= ctz(b);
+            if (a > b)
+                swap(a, b);
+            b -= a;
+        } while (b);
+        return a << shift;
     }
 
-    static bool witness(long long a, long long n) {
-        long long x, y, u = n - 1, t = 0;
-        while (u % 2 == 0) {
-            u >>= 1;
-            t += 1;
-        }
-        x = power(a, u, n);
-        while (t--) {
-            y = x;
-            x = power(x, 2, n);
-            if (x == 1 && y != 1 && y != n - 1)
-                return 1;
-        }
-        return x != 1;
+    static int ctz(u64 x) {
+#ifndef __GNUC__
+        unsigned long idx;
+        _BitScanForward64(&idx, x);
+        return int(idx);
+#else
+        return __builtin_ctzll(x);
+#endif
     }
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "primeNumberSegmentedSieve.h"
+
 // get all prime numbers in [0, n], inclusive
 // O(N loglogN)
 inline vector<bool> eratosthenes(int n) {
@@ -40,46 +42,25 @@ inline vector<int> eratosthenes2(int n) {
 
 
 // get all prime numbers
-// inclusive, O(N loglogN)
-inline vector<bool> eratosthenes(int left, int right) {
-    int n = right - left + 1;
-    vector<bool> res(n, true);
-
-    if (left <= 0 && 0 <= right)
-        res[0] = false;
-    if (left <= 1 && 1 <= right)
-        res[1 - left] = false;
-
-    int root = int(sqrt(right));
-    vector<bool> p(root + 1, true);
-
-    if (root >= 4) {
-        for (int j = 4; j <= root; j += 2)
-            p[j] = false;
-        for (int j = max(4, left + (left & 1)); j <= right; j += 2)
-            res[j - left] = false;
+// inclusive, O(N loglogN), on top of SegmentedPrimeSieve
+inline vector<bool> eratosthenes(int left, int right, int threadN = 1) {
+    vector<bool> res(right - left + 1, false);
+    if (right >= 2) {
+        SegmentedPrimeSieve::forEachPrime(max(left, 0), right, [&res, left](unsigned long long p) {
+            res[int(p) - left] = true;
+        }, threadN);
     }
-    for (int i = 3; i <= root; i += 2) {
-        if (p[i]) {
-            for (int j = i * i; j >= 0 && j <= root; j += i)
-                p[j] = false;
-            for (int j = max(i * i, ((left + i - 1) / i) * i); j >= 0 && j <= right; j += i)
-                res[j - left] = false;
-        }
-    }
-
     return res;
 }
 
 // get all prime numbers
 // inclusive, O(N loglogN)
-inline vector<int> eratosthenes2(int left, int right) {
-    vector<bool> p = eratosthenes(left, right);
-
+inline vector<int> eratosthenes2(int left, int right, int threadN = 1) {
     vector<int> res;
-    for (int i = left; i <= right; i++)
-        if (p[i - left])
-            res.push_back(i);
-
+    if (right >= 2) {
+        SegmentedPrimeSieve::forEachPrime(max(left, 0), right, [&res](unsigned long long p) {
+            res.push_back(int(p));
+        }, threadN);
+    }
     return res;
 }
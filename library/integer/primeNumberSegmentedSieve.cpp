@@ -0,0 +1,110 @@
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#include "primeNumberSegmentedSieve.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+static vector<bool> sieveSlow(int n) {
+    vector<bool> res(n + 1, true);
+    res[0] = false;
+    if (n >= 1)
+        res[1] = false;
+    for (int i = 2; i * i <= n; i++) {
+        if (res[i]) {
+            for (int j = i * i; j <= n; j += i)
+                res[j] = false;
+        }
+    }
+    return res;
+}
+
+static vector<unsigned long long> collectPrimes(unsigned long long lo, unsigned long long hi, int threadN) {
+    vector<unsigned long long> res;
+    SegmentedPrimeSieve::forEachPrime(lo, hi, [&res](unsigned long long p) {
+        res.push_back(p);
+    }, threadN);
+    return res;
+}
+
+static double elapsedSec(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+}
+
+void testPrimeNumberSegmentedSieve() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Segmented Sieve ------------------------" << endl;
+    {
+        const int N = 20'000'000;
+        auto isPrime = sieveSlow(N);
+
+        vector<pair<int, int>> ranges{
+            { 0, 0 }, { 0, 1 }, { 0, 2 }, { 2, 2 }, { 3, 3 }, { 0, 100 }, { 4, 4 }, { 13, 17 }, { 14, 16 },
+            { 0, SegmentedPrimeSieve::SEGMENT_BITS * 2 + 1 }, { 0, N }, { N / 2, N }, { 1000, N }
+        };
+        for (int i = 0; i < 30; i++) {
+            int lo = RandInt32::get() % N;
+            int hi = lo + RandInt32::get() % (N - lo + 1);
+            ranges.emplace_back(lo, hi);
+        }
+
+        for (auto& r : ranges) {
+            vector<unsigned long long> gt;
+            for (int i = r.first; i <= r.second; i++) {
+                if (isPrime[i])
+                    gt.push_back(i);
+            }
+            for (int threadN : { 1, 2, 3, 8 }) {
+                auto primes = collectPrimes(r.first, r.second, threadN);
+                if (primes != gt)
+                    cout << "Mismatched forEachPrime() : [" << r.first << ", " << r.second << "], threadN = " << threadN << endl;
+                assert(primes == gt);
+                assert(SegmentedPrimeSieve::countPrimes(r.first, r.second, threadN) == gt.size());
+            }
+
+            vector<unsigned long long> primes;
+            SegmentedPrimeSieve::Iterator it(r.first, r.second);
+            for (auto p = it.next(); p; p = it.next())
+                primes.push_back(p);
+            assert(primes == gt);
+        }
+
+        // known counts
+        assert(SegmentedPrimeSieve::countPrimes(1, 1'000'000'000) == 50847534);
+        assert(SegmentedPrimeSieve::countPrimes(1'000'000'000'000ull, 1'000'000'000'000ull + 1'000'000) == 36249);
+    }
+    cout << "OK!" << endl;
+    {
+        cout << "*** Speed test: primes up to 10^10 ***" << endl;
+
+        unsigned long long n = 10'000'000'000ull;
+        for (int threadN = 1; threadN <= Parallel::threadCount(); threadN *= 2) {
+            auto start = chrono::high_resolution_clock::now();
+            auto cnt = SegmentedPrimeSieve::countPrimes(1, n, threadN);
+            double t1 = elapsedSec(start);
+            assert(cnt == 455052511);
+
+            start = chrono::high_resolution_clock::now();
+            unsigned long long sum = 0;
+            SegmentedPrimeSieve::forEachPrime(1, n, [&sum](unsigned long long p) {
+                sum += p;
+            }, threadN);
+            double t2 = elapsedSec(start);
+
+            cout << "  threads = " << threadN << " : count = " << t1 << " sec, forEachPrime = " << t2 << " sec (sum = " << sum << ")" << endl;
+        }
+    }
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include "bit.h"
+#include "../common/parallel.h"
+
+/*
+  Segmented sieve of Eratosthenes
+
+  - odd numbers only, 1 bit per odd number
+  - 3, 5, 7, 11 and 13 are pre-sieved by copying a wheel pattern (period = 3*5*7*11*13 odd numbers)
+  - segments of SEGMENT_BITS bits (32KB, L1-sized), the sieving offsets are kept across segments
+  - blocks of segments run on multiple threads, primes are still streamed in increasing order
+  - the range is [lo, hi] in unsigned 64-bit integers (hi <= ~10^15 in practice, the base primes are <= sqrt(hi))
+
+  <How to use>
+    SegmentedPrimeSieve::forEachPrime(lo, hi, [](unsigned long long p) { ... });       // in increasing order
+    SegmentedPrimeSieve::forEachPrime(lo, hi, f, 0);                                   // with all threads
+    auto cnt = SegmentedPrimeSieve::countPrimes(1, 10'000'000'000ull);
+
+    SegmentedPrimeSieve::Iterator it(lo, hi);
+    for (auto p = it.next(); p; p = it.next()) { ... }
+*/
+struct SegmentedPrimeSieve {
+    typedef unsigned long long u64;
+
+    static const int SEGMENT_BITS = 1 << 18;        // odd numbers in a segment (32KB)
+    static const int SEGMENT_WORDS = SEGMENT_BITS / 64;
+    static const int BLOCK_SEGMENTS = 16;           // segments per thread task
+    static const int WHEEL_PERIOD = 3 * 5 * 7 * 11 * 13;
+    static const unsigned FIRST_SIEVING_PRIME = 17;
+
+    // calls f(p) for all primes p in [lo, hi], in increasing order
+    // - threadN = 0 : all hardware threads
+    template <typename Func>
+    static void forEachPrime(u64 lo, u64 hi, Func f, int threadN = 1) {
+        if (lo <= 2 && 2 <= hi)
+            f(2ull);
+
+        u64 first = max(lo, 3ull) | 1ull;
+        if (first > hi)
+            return;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        vector<unsigned> primes = basePrimes(isqrt(hi));
+        u64 totalBits = (hi - first) / 2 + 1;
+        u64 blockBits = u64(SEGMENT_BITS) * BLOCK_SEGMENTS;
+        u64 blockN = (totalBits + blockBits - 1) / blockBits;
+        if (u64(threadN) > blockN)
+            threadN = int(blockN);
+
+        if (threadN <= 1) {
+            Sieve sieve(primes);
+            sieve.init(first);
+            vector<u64> words(SEGMENT_WORDS);
+            for (u64 done = 0; done < totalBits; ) {
+                int bits = int(min<u64>(SEGMENT_BITS, totalBits - done));
+                u64 base = sieve.base;
+                sieve.sieve(words.data(), bits);
+                emit(words.data(), bits, base, f);
+                done += bits;
+            }
+            return;
+        }
+
+        // rounds of threadN blocks, the blocks are emitted in order by this thread
+        vector<Sieve> sieves(threadN, Sieve(primes));
+        vector<vector<u64>> buffers(threadN, vector<u64>(size_t(SEGMENT_WORDS) * BLOCK_SEGMENTS));
+        for (u64 block = 0; block < blockN; block += threadN) {
+            int taskN = int(min<u64>(threadN, blockN - block));
+            Parallel::forEach(taskN, taskN, [&](int t) {
+                u64 start = (block + t) * blockBits;
+                u64 bits = min(blockBits, totalBits - start);
+                sieves[t].init(first + 2 * start);
+                for (u64 done = 0; done < bits; done += SEGMENT_BITS)
+                    sieves[t].sieve(buffers[t].data() + done / 64, int(min<u64>(SEGMENT_BITS, bits - done)));
+            });
+            for (int t = 0; t < taskN; t++) {
+                u64 start = (block + t) * blockBits;
+                u64 bits = min(blockBits, totalBits - start);
+                emit(buffers[t].data(), int(bits), first + 2 * start, f);
+            }
+        }
+    }
+
+    // the number of primes in [lo, hi]
+    static u64 countPrimes(u64 lo, u64 hi, int threadN = 0) {
+        u64 res = (lo <= 2 && 2 <= hi) ? 1 : 0;
+
+        u64 first = max(lo, 3ull) | 1ull;
+        if (first > hi)
+            return res;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        vector<unsigned> primes = basePrimes(isqrt(hi));
+        u64 totalBits = (hi - first) / 2 + 1;
+        u64 segN = (totalBits + SEGMENT_BITS - 1) / SEGMENT_BITS;
+        if (u64(threadN) > segN)
+            threadN = int(segN);
+
+        // contiguous segments per thread, the offsets are initialized once per thread
+        vector<u64> counts(threadN);
+        Parallel::forEach(threadN, threadN, [&](int t) {
+            u64 segLo = segN * t / threadN, segHi = segN * (t + 1) / threadN;
+            Sieve sieve(primes);
+            sieve.init(first + 2 * segLo * SEGMENT_BITS);
+            vector<u64> words(SEGMENT_WORDS);
+            u64 cnt = 0;
+            for (u64 s = segLo; s < segHi; s++) {
+                int bits = int(min<u64>(SEGMENT_BITS, totalBits - s * SEGMENT_BITS));
+                sieve.sieve(words.data(), bits);
+                int wordN = (bits + 63) / 64;
+                for (int i = 0; i + 1 < wordN; i++)
+                    cnt += popcount(words[i]);
+                cnt += popcount(words[wordN - 1] & lowMask(bits - 64 * (wordN - 1)));
+            }
+            counts[t] = cnt;
+        });
+        for (auto c : counts)
+            res += c;
+        return res;
+    }
+
+    // floor(sqrt(x))
+    static u64 isqrt(u64 x) {
+        u64 r = u64(sqrt(double(x)));
+        while (r > 0 && r * r > x)
+            r--;
+        while ((r + 1) * (r + 1) <= x)
+            r++;
+        return r;
+    }
+
+private:
+    // 'bits' low bits (1 <= bits <= 64)
+    static u64 lowMask(int bits) {
+        return bits >= 64 ? ~0ull : (1ull << bits) - 1;
+    }
+
+    template <typename Func>
+    static void emit(const u64* words, int bits, u64 base, Func& f) {
+        int wordN = (bits + 63) / 64;
+        for (int i = 0; i < wordN; i++) {
+            u64 x = words[i];
+            if (i == wordN - 1)
+                x &= lowMask(bits - 64 * i);
+            while (x) {
+                int b = ctz(x);
+                x &= x - 1;
+                f(base + 2 * (u64(i) * 64 + b));
+            }
+        }
+    }
+
+    // odd primes <= n
+    static vector<unsigned> basePrimes(u64 n) {
+        vector<unsigned> res;
+        if (n < 3)
+            return res;
+
+        vector<char> composite(n / 2 + 1);
+        for (u64 i = 3; i * i <= n; i += 2) {
+            if (!composite[i / 2]) {
+                for (u64 j = i * i; j <= n; j += 2 * i)
+                    composite[j / 2] = 1;
+            }
+        }
+        for (u64 i = 3; i <= n; i += 2) {
+            if (!composite[i / 2])
+                res.push_back(unsigned(i));
+        }
+        return res;
+    }
+
+    // bit t = 1 if 2t+1 has no factor in { 3, 5, 7, 11, 13 }, extended for 64-bit reads at any t < WHEEL_PERIOD
+    static vector<u64> buildWheelPattern() {
+        vector<u64> res((WHEEL_PERIOD + 128) / 64 + 1);
+        for (int t = 0; t < int(res.size()) * 64; t++) {
+            int x = (2 * t + 1) % (2 * WHEEL_PERIOD);
+            if (x % 3 && x % 5 && x % 7 && x % 11 && x % 13)
+                res[t >> 6] |= 1ull << (t & 63);
+        }
+        return res;
+    }
+
+    static const vector<u64>& wheelPattern() {
+        static const vector<u64> pattern = buildWheelPattern();
+        return pattern;
+    }
+
+    struct Sieve {
+        const vector<unsigned>* primes;
+        vector<u64> next;           // bit offsets of the next multiples p * k (k coprime to 30), relative to 'base'
+        vector<unsigned char> wheel;// index of k mod 30 in WHEEL30
+        int active;                 // primes[0..active) are used (p * p <= the current segment end)
+        int firstIndex;             // primes[firstIndex] >= FIRST_SIEVING_PRIME
+        u64 base;                   // the first odd number of the next segment
+
+        explicit Sieve(const vector<unsigned>& primes) : primes(&primes), active(0), base(3) {
+            firstIndex = int(lower_bound(primes.begin(), primes.end(), FIRST_SIEVING_PRIME) - primes.begin());
+            wheelPattern();
+        }
+
+        void init(u64 oddBase) {
+            base = oddBase;
+            active = firstIndex;
+            next.assign(primes->size(), 0);
+            wheel.assign(primes->size(), 0);
+        }
+
+        // sieves the odd numbers [base, base + 2 * bits), bits <= SEGMENT_BITS
+        void sieve(u64* words, int bits) {
+            const vector<u64>& pattern = wheelPattern();
+            int wordN = (bits + 63) / 64;
+
+            u64 pos = ((base - 1) / 2) % WHEEL_PERIOD;
+            for (int i = 0; i < wordN; i++) {
+                int w = int(pos >> 6), s = int(pos & 63);
+                words[i] = s ? (pattern[w] >> s) | (pattern[w + 1] << (64 - s)) : pattern[w];
+                pos += 64;
+                if (pos >= WHEEL_PERIOD)
+                    pos -= WHEEL_PERIOD;
+            }
+
+            // the wheel primes themselves
+            for (u64 p : { 3ull, 5ull, 7ull, 11ull, 13ull }) {
+                if (base <= p && p < base + 2ull * bits) {
+                    u64 t = (p - base) / 2;
+                    words[t >> 6] |= 1ull << (t & 63);
+                }
+            }
+
+            u64 last = base + 2ull * (bits - 1);
+            const vector<unsigned>& P = *primes;
+            // multiples p * k with k divisible by 2, 3 or 5 are skipped (mod 30 wheel, in bit units of p)
+            static const int WHEEL30[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+            static const int INDEX30[30] = { 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 4, 4, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7 };
+            static const int GAP[8] = { 3, 2, 1, 2, 1, 2, 3, 1 };
+
+            while (active < int(P.size()) && u64(P[active]) * P[active] <= last) {
+                u64 p = P[active];
+                u64 k = max(p, (base + p - 1) / p);
+                int w = INDEX30[k % 30];
+                k += WHEEL30[w] - int(k % 30);      // the next k coprime to 30
+                wheel[active] = (unsigned char)w;
+                next[active++] = (p * k - base) / 2;
+            }
+
+            for (int i = firstIndex; i < active; i++) {
+                u64 p = P[i];
+                u64 j = next[i];
+                int w = wheel[i];
+                if (j + p * 15 < u64(bits)) {
+                    // whole wheel cycles (15p bits), offsets from the current wheel index
+                    u64 d[8];
+                    for (int t = 0, acc = 0; t < 8; t++) {
+                        d[t] = p * acc;
+                        acc += GAP[(w + t) & 7];
+                    }
+                    for (u64 end = bits - p * 15; j < end; j += p * 15) {
+                        for (int t = 0; t < 8; t++)
+                            words[(j + d[t]) >> 6] &= ~(1ull << ((j + d[t]) & 63));
+                    }
+                }
+                while (j < u64(bits)) {
+                    words[j >> 6] &= ~(1ull << (j & 63));
+                    j += p * GAP[w];
+                    w = (w + 1) & 7;
+                }
+                next[i] = j - bits;
+                wheel[i] = (unsigned char)w;
+            }
+
+            base += 2ull * bits;
+        }
+    };
+
+public:
+    // streams the primes in [lo, hi] one by one (single thread)
+    struct Iterator {
+        Iterator(u64 lo, u64 hi) : primes(basePrimes(isqrt(hi))), sieve(primes), words(SEGMENT_WORDS) {
+            emitTwo = (lo <= 2 && 2 <= hi);
+            u64 first = max(lo, 3ull) | 1ull;
+            remain = (first > hi) ? 0 : (hi - first) / 2 + 1;
+            sieve.init(first);
+            segBase = first;
+            wordIndex = wordN = 0;
+            cur = 0;
+        }
+
+        // returns 0 at the end
+        u64 next() {
+            if (emitTwo) {
+                emitTwo = false;
+                return 2;
+            }
+            while (cur == 0) {
+                if (++wordIndex >= wordN) {
+                    if (remain == 0)
+                        return 0;
+                    int bits = int(min<u64>(SEGMENT_BITS, remain));
+                    segBase = sieve.base;
+                    sieve.sieve(words.data(), bits);
+                    remain -= bits;
+                    wordN = (bits + 63) / 64;
+                    words[wordN - 1] &= lowMask(bits - 64 * (wordN - 1));
+                    wordIndex = 0;
+                }
+                cur = words[wordIndex];
+            }
+            int b = ctz(cur);
+            cur &= cur - 1;
+            return segBase + 2 * (u64(wordIndex) * 64 + b);
+        }
+
+    private:
+        vector<unsigned> primes;
+        Sieve sieve;
+        vector<u64> words;
+        u64 segBase;
+        u64 remain;
+        int wordIndex, wordN;
+        u64 cur;
+        bool emitTwo;
+    };
+};
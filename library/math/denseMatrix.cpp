@@ -0,0 +1,237 @@
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+
+using namespace std;
+
+#include "denseMatrix.h"
+#include "matrix.h"
+#include "matrixMod.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+template <int mod>
+static DenseMatrixMod<mod> makeRandomMatrixMod(int rows, int cols) {
+    DenseMatrixMod<mod> res(rows, cols);
+    for (auto& x : res.data)
+        x = RandInt32::get() % mod;
+    return res;
+}
+
+template <int mod>
+static DenseMatrixMod<mod> multiplySlow(const DenseMatrixMod<mod>& A, const DenseMatrixMod<mod>& B) {
+    DenseMatrixMod<mod> res(A.rows, B.cols);
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = 0; j < B.cols; j++) {
+            long long sum = 0;
+            for (int k = 0; k < A.cols; k++)
+                sum = (sum + 1ll * A[i][k] * B[k][j]) % mod;
+            res[i][j] = int(sum);
+        }
+    }
+    return res;
+}
+
+// Freivalds' check : A * (B * x) == C * x
+template <int mod>
+static bool checkProduct(const DenseMatrixMod<mod>& A, const DenseMatrixMod<mod>& B, const DenseMatrixMod<mod>& C) {
+    auto mulVec = [](const DenseMatrixMod<mod>& M, const vector<long long>& x) {
+        vector<long long> res(M.rows);
+        for (int i = 0; i < M.rows; i++) {
+            long long sum = 0;
+            for (int j = 0; j < M.cols; j++)
+                sum = (sum + M[i][j] * x[j]) % mod;
+            res[i] = sum;
+        }
+        return res;
+    };
+    vector<long long> x(B.cols);
+    for (auto& v : x)
+        v = RandInt32::get() % mod;
+    return mulVec(A, mulVec(B, x)) == mulVec(C, x);
+}
+
+template <int mod>
+static void testDenseMatrixMod() {
+    for (int iter = 0; iter < 30; iter++) {
+        int n = RandInt32::get() % 70 + 1, K = RandInt32::get() % 70 + 1, m = RandInt32::get() % 70 + 1;
+        auto A = makeRandomMatrixMod<mod>(n, K);
+        auto B = makeRandomMatrixMod<mod>(K, m);
+        auto gt = multiplySlow(A, B);
+        for (int threadN : { 1, 3 }) {
+            DenseMatrixMod<mod> C;
+            DenseMatrixMod<mod>::multiply(C, A, B, threadN);
+            assert(C == gt);
+        }
+    }
+    {
+        // K > KC, sizes above the parallel threshold
+        auto A = makeRandomMatrixMod<mod>(300, 613);
+        auto B = makeRandomMatrixMod<mod>(613, 259);
+        auto gt = multiplySlow(A, B);
+        for (int threadN : { 1, 3 }) {
+            DenseMatrixMod<mod> C;
+            DenseMatrixMod<mod>::multiply(C, A, B, threadN);
+            assert(C == gt);
+        }
+    }
+    {
+        // Strassen with odd sizes (zero padding)
+        for (int n : { 37, 100, 129 }) {
+            auto A = makeRandomMatrixMod<mod>(n, n);
+            auto B = makeRandomMatrixMod<mod>(n, n);
+            DenseMatrixMod<mod> C;
+            DenseMatrixMod<mod>::multiply(C, A, B, 1, 16);
+            assert(C == multiplySlow(A, B));
+        }
+        auto A = makeRandomMatrixMod<mod>(1100, 1100);
+        auto B = makeRandomMatrixMod<mod>(1100, 1100);
+        assert(checkProduct(A, B, A * B));
+    }
+}
+
+void testDenseMatrix() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Dense Matrix -------------------------" << endl;
+    {
+        testDenseMatrixMod<1'000'000'007>();
+        testDenseMatrixMod<998'244'353>();
+        testDenseMatrixMod<1'073'741'789>();      // close to 2^30
+        testDenseMatrixMod<7>();
+    }
+    {
+        for (int n : { 1, 5, 63, 64, 100, 300 }) {
+            DenseMatrix<double> A(n, n), B(n, n);
+            DenseMatrix<long long> AL(n, n), BL(n, n);
+            for (int i = 0; i < n * n; i++) {
+                A.data[i] = double(AL.data[i] = RandInt32::get() % 1000 - 500);
+                B.data[i] = double(BL.data[i] = RandInt32::get() % 1000 - 500);
+            }
+            auto C = A * B;
+            auto CL = AL * BL;
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    long long sum = 0;
+                    for (int k = 0; k < n; k++)
+                        sum += AL[i][k] * BL[k][j];
+                    assert(CL[i][j] == sum && C[i][j] == double(sum));
+                }
+            }
+        }
+    }
+    {
+        // Matrix / MatrixMod conversion
+        const int MOD = 1'000'000'007;
+        int N = 150;
+        auto A = makeRandomMatrixMod<MOD>(N, N);
+        auto B = makeRandomMatrixMod<MOD>(N, N);
+        vector<vector<int>> a, b;
+        A.copyTo(a);
+        B.copyTo(b);
+        auto gt = multiplySlow(A, B);
+
+        MatrixMod<MOD> ma(a), mb(b);
+        auto mc = ma * mb;
+        assert(DenseMatrixMod<MOD>(mc.mat) == gt);
+
+        Matrix<long long> la(N), lb(N);
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                la[i][j] = a[i][j] % 1000;
+                lb[i][j] = b[i][j] % 1000;
+            }
+        }
+        auto lc = la * lb;
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                long long sum = 0;
+                for (int k = 0; k < N; k++)
+                    sum += la[i][k] * lb[k][j];
+                assert(lc[i][j] == sum);
+            }
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        const int MOD = 1'000'000'007;
+        for (int N : { 256, 512, 1024 }) {
+            auto A = makeRandomMatrixMod<MOD>(N, N);
+            auto B = makeRandomMatrixMod<MOD>(N, N);
+            vector<vector<int>> a, b;
+            A.copyTo(a);
+            B.copyTo(b);
+
+            MatrixMod<MOD> mc(N);
+            if (N <= 512) {
+                cout << "N = " << N << ", naive (%) : ";
+                PROFILE_HI_START(0);
+                for (int r = 0; r < N; r++) {
+                    for (int c = 0; c < N; c++) {
+                        long long sum = 0;
+                        for (int k = 0; k < N; k++)
+                            sum = (sum + 1ll * a[r][k] * b[k][c]) % MOD;
+                        mc[r][c] = int(sum);
+                    }
+                }
+                PROFILE_HI_STOP(0);
+            }
+
+            for (int threadN : { 1, 4 }) {
+                cout << "DenseMatrixMod, N = " << N << ", threads = " << threadN << " : ";
+                DenseMatrixMod<MOD> C;
+                PROFILE_HI_START(1);
+                DenseMatrixMod<MOD>::multiply(C, A, B, threadN);
+                PROFILE_HI_STOP(1);
+            }
+        }
+        for (int N : { 1024, 2048 }) {
+            auto A = makeRandomMatrixMod<MOD>(N, N);
+            auto B = makeRandomMatrixMod<MOD>(N, N);
+            for (int threshold : { N + 1, 1024, 512 }) {
+                cout << "DenseMatrixMod, N = " << N << ", Strassen threshold = " << threshold << " : ";
+                DenseMatrixMod<MOD> C;
+                PROFILE_HI_START(2);
+                DenseMatrixMod<MOD>::multiply(C, A, B, 1, threshold);
+                PROFILE_HI_STOP(2);
+            }
+        }
+    }
+    {
+        int N = 512;
+        Matrix<double> A(N), B(N), C(N);
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                A[i][j] = RandInt32::get() % 1000 / 100.0;
+                B[i][j] = RandInt32::get() % 1000 / 100.0;
+            }
+        }
+        cout << "Matrix<double>, N = " << N << ", naive : ";
+        PROFILE_HI_START(3);
+        for (int r = 0; r < N; r++) {
+            for (int c = 0; c < N; c++) {
+                C[r][c] = 0;
+                for (int k = 0; k < N; k++)
+                    C[r][c] += A[r][k] * B[k][c];
+            }
+        }
+        PROFILE_HI_STOP(3);
+
+        cout << "Matrix<double>, N = " << N << ", DenseMatrix : ";
+        PROFILE_HI_START(4);
+        Matrix<double>::multiply(C, A, B);
+        PROFILE_HI_STOP(4);
+    }
+}
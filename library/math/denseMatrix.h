@@ -0,0 +1,418 @@
+#pragma once
+
+#include "../common/cpuFeature.h"
+#include "../common/parallel.h"
+
+/*
+  Contiguous row-major matrices with cache-blocked multiplication
+
+  1) DenseMatrix<T>
+     - blocks of BLOCK_K x BLOCK_J of the right matrix stay in the cache while rows of the left matrix stream over them
+     - the inner loop is out[i][j..] += a[i][k] * b[k][j..] (AVX2 for double, when the CPU supports it)
+  2) DenseMatrixMod<mod>, mod < 2^30
+     - the right matrix is packed into panels of 8 columns, the left one into tiles of 4 rows (k-major, 64-bit lanes)
+     - a 4 x 8 AVX2 kernel accumulates 64-bit products and reduces them only every LAZY_STEPS terms
+       (a multiple of mod near 2^63 is subtracted when the sign bit is set), '%' is applied once per element at the end
+     - Strassen's algorithm for N >= STRASSEN_THRESHOLD (square matrices)
+  - rows are split across threads for N >= PARALLEL_THRESHOLD (threadN = 0 : all hardware threads)
+  - Matrix / MatrixMod convert to these types for large multiplications
+
+  <How to use>
+    DenseMatrixMod<MOD> A(mat), B(mat2);        // from vector<vector<int>>
+    auto C = A * B;
+    C.copyTo(mat3);
+*/
+
+template <typename T>
+struct DenseMatrix {
+    static const int BLOCK_K = 128;
+    static const int BLOCK_J = 256;
+    static const int PARALLEL_THRESHOLD = 256;
+
+    int rows, cols;
+    vector<T> data;
+
+    DenseMatrix() : rows(0), cols(0) {
+    }
+
+    DenseMatrix(int rows, int cols) : rows(rows), cols(cols), data(size_t(rows) * cols) {
+    }
+
+    explicit DenseMatrix(const vector<vector<T>>& m)
+        : rows(int(m.size())), cols(m.empty() ? 0 : int(m[0].size())), data(size_t(rows) * cols) {
+        for (int i = 0; i < rows; i++)
+            copy(m[i].begin(), m[i].begin() + cols, (*this)[i]);
+    }
+
+    void copyTo(vector<vector<T>>& m) const {
+        m.resize(rows);
+        for (int i = 0; i < rows; i++)
+            m[i].assign((*this)[i], (*this)[i] + cols);
+    }
+
+    T* operator [](int row) {
+        return data.data() + size_t(row) * cols;
+    }
+
+    const T* operator [](int row) const {
+        return data.data() + size_t(row) * cols;
+    }
+
+    DenseMatrix operator *(const DenseMatrix& rhs) const {
+        DenseMatrix res;
+        multiply(res, *this, rhs);
+        return res;
+    }
+
+    // out = left * right, out can be left or right
+    static void multiply(DenseMatrix& out, const DenseMatrix& left, const DenseMatrix& right, int threadN = 0) {
+        int n = left.rows, m = right.cols, K = left.cols;
+        DenseMatrix res(n, m);
+        threadN = (max(n, m) >= PARALLEL_THRESHOLD) ? (threadN <= 0 ? Parallel::threadCount() : threadN) : 1;
+
+        bool avx2 = CpuFeature::hasAVX2();
+        Parallel::forRange(0, n, threadN, [&](int lo, int hi) {
+            for (int jb = 0; jb < m; jb += BLOCK_J) {
+                int jn = min(BLOCK_J, m - jb);
+                for (int kb = 0; kb < K; kb += BLOCK_K) {
+                    int kEnd = min(K, kb + BLOCK_K);
+                    for (int i = lo; i < hi; i++) {
+                        T* out = res[i] + jb;
+                        for (int k = kb; k < kEnd; k++) {
+                            if (avx2)
+                                addScaledAVX2(out, left[i][k], right[k] + jb, jn);
+                            else
+                                addScaled(out, left[i][k], right[k] + jb, jn);
+                        }
+                    }
+                }
+            }
+        });
+        out = move(res);
+    }
+
+    // y[0..n) += a * x[0..n)
+    static void addScaledRow(T* y, T a, const T* x, int n) {
+        if (CpuFeature::hasAVX2())
+            addScaledAVX2(y, a, x, n);
+        else
+            addScaled(y, a, x, n);
+    }
+
+private:
+    static void addScaled(T* y, T a, const T* x, int n) {
+        for (int j = 0; j < n; j++)
+            y[j] += a * x[j];
+    }
+
+    template <typename U = T>
+    static typename enable_if<!is_same<U, double>::value>::type addScaledAVX2(T* y, T a, const T* x, int n) {
+        addScaled(y, a, x, n);
+    }
+
+    template <typename U = T>
+    TARGET_AVX2
+    static typename enable_if<is_same<U, double>::value>::type addScaledAVX2(T* y, T a, const T* x, int n) {
+        __m256d va = _mm256_set1_pd(a);
+        int j = 0;
+        for (; j + 4 <= n; j += 4)
+            _mm256_storeu_pd(y + j, _mm256_add_pd(_mm256_loadu_pd(y + j), _mm256_mul_pd(va, _mm256_loadu_pd(x + j))));
+        for (; j < n; j++)
+            y[j] += a * x[j];
+    }
+};
+
+
+template <int mod = 1'000'000'007>
+struct DenseMatrixMod {
+    typedef unsigned long long u64;
+
+    static_assert(mod > 0 && mod < (1 << 30), "mod must be less than 2^30");
+
+    static const int MR = 4;                        // rows of a tile
+    static const int NR = 8;                        // columns of a panel
+    static const int KC = 256;                      // k-block
+    static const int PARALLEL_THRESHOLD = 256;
+    static const int STRASSEN_THRESHOLD = 1024;
+
+    int rows, cols;
+    vector<int> data;                               // [0, mod)
+
+    DenseMatrixMod() : rows(0), cols(0) {
+    }
+
+    DenseMatrixMod(int rows, int cols) : rows(rows), cols(cols), data(size_t(rows) * cols) {
+    }
+
+    explicit DenseMatrixMod(const vector<vector<int>>& m)
+        : rows(int(m.size())), cols(m.empty() ? 0 : int(m[0].size())), data(size_t(rows) * cols) {
+        for (int i = 0; i < rows; i++)
+            copy(m[i].begin(), m[i].begin() + cols, (*this)[i]);
+    }
+
+    void copyTo(vector<vector<int>>& m) const {
+        m.resize(rows);
+        for (int i = 0; i < rows; i++)
+            m[i].assign((*this)[i], (*this)[i] + cols);
+    }
+
+    int* operator [](int row) {
+        return data.data() + size_t(row) * cols;
+    }
+
+    const int* operator [](int row) const {
+        return data.data() + size_t(row) * cols;
+    }
+
+    bool operator ==(const DenseMatrixMod& rhs) const {
+        return rows == rhs.rows && cols == rhs.cols && data == rhs.data;
+    }
+
+    DenseMatrixMod& operator +=(const DenseMatrixMod& rhs) {
+        for (size_t i = 0; i < data.size(); i++) {
+            unsigned x = unsigned(data[i]) + unsigned(rhs.data[i]);
+            data[i] = int(min(x, x - unsigned(mod)));
+        }
+        return *this;
+    }
+
+    DenseMatrixMod& operator -=(const DenseMatrixMod& rhs) {
+        for (size_t i = 0; i < data.size(); i++) {
+            unsigned x = unsigned(data[i]) - unsigned(rhs.data[i]);
+            data[i] = int(min(x, x + unsigned(mod)));
+        }
+        return *this;
+    }
+
+    DenseMatrixMod operator +(const DenseMatrixMod& rhs) const {
+        return DenseMatrixMod(*this) += rhs;
+    }
+
+    DenseMatrixMod operator -(const DenseMatrixMod& rhs) const {
+        return DenseMatrixMod(*this) -= rhs;
+    }
+
+    DenseMatrixMod operator *(const DenseMatrixMod& rhs) const {
+        DenseMatrixMod res;
+        multiply(res, *this, rhs);
+        return res;
+    }
+
+    // out = left * right, out can be left or right
+    // - Strassen's algorithm is used for square matrices of size >= strassenThreshold
+    static void multiply(DenseMatrixMod& out, const DenseMatrixMod& left, const DenseMatrixMod& right, int threadN = 0,
+                         int strassenThreshold = STRASSEN_THRESHOLD) {
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+        if (left.rows == left.cols && left.cols == right.rows && right.rows == right.cols && left.rows >= strassenThreshold)
+            out = strassen(left, right, threadN, strassenThreshold);
+        else
+            out = multiplyBlocked(left, right, threadN);
+    }
+
+private:
+    static const u64 MOD2 = u64(mod - 1) * u64(mod - 1) + 1;           // > any product
+    // the number of products added before a reduction (at most 2^62 in total)
+    static const int LAZY_STEPS = int(min<u64>((1ull << 62) / MOD2, u64(KC)));
+    // the largest multiple of mod <= 2^63, subtracted when an accumulator reaches 2^63
+    static const u64 BIG = (1ull << 63) / u64(mod) * u64(mod);
+
+    static DenseMatrixMod multiplyBlocked(const DenseMatrixMod& left, const DenseMatrixMod& right, int threadN) {
+        int n = left.rows, m = right.cols, K = left.cols;
+        int rowTiles = (n + MR - 1) / MR, panels = (m + NR - 1) / NR;
+        if (max(n, m) < PARALLEL_THRESHOLD)
+            threadN = 1;
+
+        // accumulators < 2^63
+        vector<u64> acc(size_t(rowTiles) * MR * panels * NR);
+        size_t ldc = size_t(panels) * NR;
+        vector<u64> packedB(size_t(panels) * KC * NR);
+
+        bool avx2 = CpuFeature::hasAVX2();
+        for (int kb = 0; kb < K; kb += KC) {
+            int kc = min(KC, K - kb);
+            packRight(packedB.data(), right, kb, kc, panels);
+
+            Parallel::forRange(0, rowTiles, threadN, [&](int lo, int hi) {
+                vector<u64> packedA(size_t(KC) * MR);
+                for (int t = lo; t < hi; t++) {
+                    packLeft(packedA.data(), left, t * MR, kb, kc);
+                    u64* c = acc.data() + size_t(t) * MR * ldc;
+                    for (int p = 0; p < panels; p++) {
+                        if (avx2)
+                            kernelAVX2(packedA.data(), packedB.data() + size_t(p) * KC * NR, kc, c + p * NR, ldc);
+                        else
+                            kernel(packedA.data(), packedB.data() + size_t(p) * KC * NR, kc, c + p * NR, ldc);
+                    }
+                }
+            });
+        }
+
+        DenseMatrixMod res(n, m);
+        Parallel::forRange(0, n, threadN, [&](int lo, int hi) {
+            for (int i = lo; i < hi; i++) {
+                const u64* c = acc.data() + size_t(i) * ldc;
+                int* out = res[i];
+                for (int j = 0; j < m; j++)
+                    out[j] = int(c[j] % unsigned(mod));
+            }
+        });
+        return res;
+    }
+
+    // panel p : packed[p][k][0..NR), zero-padded
+    static void packRight(u64* packed, const DenseMatrixMod& right, int kb, int kc, int panels) {
+        int m = right.cols;
+        for (int p = 0; p < panels; p++) {
+            u64* dst = packed + size_t(p) * KC * NR;
+            int j0 = p * NR, jn = min(NR, m - j0);
+            for (int k = 0; k < kc; k++) {
+                const int* src = right[kb + k] + j0;
+                for (int j = 0; j < jn; j++)
+                    dst[k * NR + j] = unsigned(src[j]);
+                for (int j = jn; j < NR; j++)
+                    dst[k * NR + j] = 0;
+            }
+        }
+    }
+
+    // packed[k][0..MR), zero-padded
+    static void packLeft(u64* packed, const DenseMatrixMod& left, int i0, int kb, int kc) {
+        int in = min(MR, left.rows - i0);
+        for (int r = 0; r < MR; r++) {
+            if (r < in) {
+                const int* src = left[i0 + r] + kb;
+                for (int k = 0; k < kc; k++)
+                    packed[k * MR + r] = unsigned(src[k]);
+            } else {
+                for (int k = 0; k < kc; k++)
+                    packed[k * MR + r] = 0;
+            }
+        }
+    }
+
+    // c[r][j] += SUM a[k][r] * b[k][j]
+    static void kernel(const u64* a, const u64* b, int kc, u64* c, size_t ldc) {
+        u64 sum[MR][NR];
+        for (int r = 0; r < MR; r++)
+            for (int j = 0; j < NR; j++)
+                sum[r][j] = c[r * ldc + j];
+
+        for (int k0 = 0; k0 < kc; k0 += LAZY_STEPS) {
+            int kEnd = min(kc, k0 + LAZY_STEPS);
+            for (int k = k0; k < kEnd; k++) {
+                for (int r = 0; r < MR; r++)
+                    for (int j = 0; j < NR; j++)
+                        sum[r][j] += a[k * MR + r] * b[k * NR + j];
+            }
+            for (int r = 0; r < MR; r++)
+                for (int j = 0; j < NR; j++)
+                    sum[r][j] -= BIG & (0 - (sum[r][j] >> 63));
+        }
+
+        for (int r = 0; r < MR; r++)
+            for (int j = 0; j < NR; j++)
+                c[r * ldc + j] = sum[r][j];
+    }
+
+    TARGET_AVX2
+    static void kernelAVX2(const u64* a, const u64* b, int kc, u64* c, size_t ldc) {
+        __m256i c00 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c));
+        __m256i c01 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 4));
+        __m256i c10 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + ldc));
+        __m256i c11 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + ldc + 4));
+        __m256i c20 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 2 * ldc));
+        __m256i c21 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 2 * ldc + 4));
+        __m256i c30 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 3 * ldc));
+        __m256i c31 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 3 * ldc + 4));
+
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i big = _mm256_set1_epi64x((long long)BIG);
+        for (int k0 = 0; k0 < kc; k0 += LAZY_STEPS) {
+            int kEnd = min(kc, k0 + LAZY_STEPS);
+            for (int k = k0; k < kEnd; k++) {
+                __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k * NR));
+                __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k * NR + 4));
+                __m256i a0 = _mm256_set1_epi64x((long long)a[k * MR]);
+                __m256i a1 = _mm256_set1_epi64x((long long)a[k * MR + 1]);
+                __m256i a2 = _mm256_set1_epi64x((long long)a[k * MR + 2]);
+                __m256i a3 = _mm256_set1_epi64x((long long)a[k * MR + 3]);
+                c00 = _mm256_add_epi64(c00, _mm256_mul_epu32(a0, b0));
+                c01 = _mm256_add_epi64(c01, _mm256_mul_epu32(a0, b1));
+                c10 = _mm256_add_epi64(c10, _mm256_mul_epu32(a1, b0));
+                c11 = _mm256_add_epi64(c11, _mm256_mul_epu32(a1, b1));
+                c20 = _mm256_add_epi64(c20, _mm256_mul_epu32(a2, b0));
+                c21 = _mm256_add_epi64(c21, _mm256_mul_epu32(a2, b1));
+                c30 = _mm256_add_epi64(c30, _mm256_mul_epu32(a3, b0));
+                c31 = _mm256_add_epi64(c31, _mm256_mul_epu32(a3, b1));
+            }
+            c00 = reduceAVX2(c00, zero, big);
+            c01 = reduceAVX2(c01, zero, big);
+            c10 = reduceAVX2(c10, zero, big);
+            c11 = reduceAVX2(c11, zero, big);
+            c20 = reduceAVX2(c20, zero, big);
+            c21 = reduceAVX2(c21, zero, big);
+            c30 = reduceAVX2(c30, zero, big);
+            c31 = reduceAVX2(c31, zero, big);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c), c00);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + 4), c01);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + ldc), c10);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + ldc + 4), c11);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + 2 * ldc), c20);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + 2 * ldc + 4), c21);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + 3 * ldc), c30);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + 3 * ldc + 4), c31);
+    }
+
+    // x - BIG if x >= 2^63
+    TARGET_AVX2
+    static __m256i reduceAVX2(__m256i x, __m256i zero, __m256i big) {
+        return _mm256_sub_epi64(x, _mm256_and_si256(_mm256_cmpgt_epi64(zero, x), big));
+    }
+
+    //--- Strassen's algorithm
+
+    static DenseMatrixMod strassen(const DenseMatrixMod& A, const DenseMatrixMod& B, int threadN, int threshold) {
+        int n = A.rows;
+        if (n < threshold)
+            return multiplyBlocked(A, B, threadN);
+
+        int h = (n + 1) / 2;
+        DenseMatrixMod A11 = quadrant(A, 0, 0, h), A12 = quadrant(A, 0, h, h), A21 = quadrant(A, h, 0, h), A22 = quadrant(A, h, h, h);
+        DenseMatrixMod B11 = quadrant(B, 0, 0, h), B12 = quadrant(B, 0, h, h), B21 = quadrant(B, h, 0, h), B22 = quadrant(B, h, h, h);
+
+        DenseMatrixMod M1 = strassen(A11 + A22, B11 + B22, threadN, threshold);
+        DenseMatrixMod M2 = strassen(A21 + A22, B11, threadN, threshold);
+        DenseMatrixMod M3 = strassen(A11, B12 - B22, threadN, threshold);
+        DenseMatrixMod M4 = strassen(A22, B21 - B11, threadN, threshold);
+        DenseMatrixMod M5 = strassen(A11 + A12, B22, threadN, threshold);
+        DenseMatrixMod M6 = strassen(A21 - A11, B11 + B12, threadN, threshold);
+        DenseMatrixMod M7 = strassen(A12 - A22, B21 + B22, threadN, threshold);
+
+        DenseMatrixMod res(n, n);
+        setQuadrant(res, 0, 0, M1 + M4 - M5 + M7);
+        setQuadrant(res, 0, h, M3 + M5);
+        setQuadrant(res, h, 0, M2 + M4);
+        setQuadrant(res, h, h, M1 - M2 + M3 + M6);
+        return res;
+    }
+
+    // h x h block at (r0, c0), zero-padded
+    static DenseMatrixMod quadrant(const DenseMatrixMod& m, int r0, int c0, int h) {
+        DenseMatrixMod res(h, h);
+        for (int i = 0; i < h && r0 + i < m.rows; i++) {
+            int cn = min(h, m.cols - c0);
+            copy(m[r0 + i] + c0, m[r0 + i] + c0 + cn, res[i]);
+        }
+        return res;
+    }
+
+    static void setQuadrant(DenseMatrixMod& m, int r0, int c0, const DenseMatrixMod& q) {
+        for (int i = 0; i < q.rows && r0 + i < m.rows; i++) {
+            int cn = min(q.cols, m.cols - c0);
+            copy(q[i], q[i] + cn, m[r0 + i] + c0);
+        }
+    }
+};
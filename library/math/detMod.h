@@ -1,5 +1,6 @@
 #pragma once
 
+#include "luDecomposition.h"
 
 // Determinant modulo with gaussian elimination method
 // N is the determinant size, calculate |mat| % MOD
@@ -34,4 +35,15 @@ struct DetMod {
 
         return T(res);
     }
+
+    // O(N^3), mod must be a prime number, elements must be in [0, mod)
+    // - the factorization can be reused to solve linear systems (LUDecompositionMod::solve)
+    static T det(const vector<vector<int>>& mat, LUDecompositionMod<mod>& lu, int threadN = 0) {
+        lu.factorize(mat, threadN);
+        return T(lu.det());
+    }
+
+    static T det(const LUDecompositionMod<mod>& lu) {
+        return T(lu.det());
+    }
 };
@@ -8,6 +8,7 @@ using namespace std;
 
 #include "gaussianElimination.h"
 #include "gaussianEliminationMod.h"
+#include "detMod.h"
 
 
 /////////// For Testing ///////////////////////////////////////////////////////
@@ -17,9 +18,119 @@ using namespace std;
 #include <string>
 #include <iostream>
 #include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
 
 const int MOD = 1'000'000'007;
 
+// unblocked elimination with partial pivoting
+static vector<double> gaussSlow(vector<vector<double>> a, vector<double> b) {
+    int N = int(a.size());
+    for (int col = 0; col < N; col++) {
+        int best = col;
+        for (int i = col + 1; i < N; i++) {
+            if (abs(a[best][col]) < abs(a[i][col]))
+                best = i;
+        }
+        swap(a[col], a[best]);
+        swap(b[col], b[best]);
+        for (int i = col + 1; i < N; i++) {
+            double x = a[i][col] / a[col][col];
+            for (int j = col; j < N; j++)
+                a[i][j] -= x * a[col][j];
+            b[i] -= x * b[col];
+        }
+    }
+    vector<double> x(N);
+    for (int i = N - 1; i >= 0; i--) {
+        double sum = b[i];
+        for (int j = i + 1; j < N; j++)
+            sum -= a[i][j] * x[j];
+        x[i] = sum / a[i][i];
+    }
+    return x;
+}
+
+static vector<vector<double>> makeRandomMatrix(int N) {
+    vector<vector<double>> a(N, vector<double>(N));
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            a[i][j] = RandInt32::get() % 2001 / 1000.0 - 1.0;
+    return a;
+}
+
+static vector<vector<int>> makeRandomMatrixMod(int N) {
+    vector<vector<int>> a(N, vector<int>(N));
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            a[i][j] = RandInt32::get() % MOD;
+    return a;
+}
+
+static vector<int> multiplyMod(const vector<vector<int>>& a, const vector<int>& x) {
+    int N = int(a.size());
+    vector<int> res(N);
+    for (int i = 0; i < N; i++) {
+        long long sum = 0;
+        for (int j = 0; j < N; j++)
+            sum = (sum + 1ll * a[i][j] * x[j]) % MOD;
+        res[i] = int(sum);
+    }
+    return res;
+}
+
+// rank over GF(2) with one row at a time
+static int rankMod2Slow(vector<vector<unsigned long long>> a, int M) {
+    int N = int(a.size()), rank = 0;
+    for (int col = 0; col < M && rank < N; col++) {
+        int w = col >> 6;
+        unsigned long long bit = 1ull << (col & 63);
+        int p = rank;
+        while (p < N && !(a[p][w] & bit))
+            p++;
+        if (p >= N)
+            continue;
+        swap(a[p], a[rank]);
+        for (int i = 0; i < N; i++) {
+            if (i != rank && (a[i][w] & bit)) {
+                for (int j = w; j < int(a[i].size()); j++)
+                    a[i][j] ^= a[rank][j];
+            }
+        }
+        rank++;
+    }
+    return rank;
+}
+
+static vector<bool> multiplyMod2(const MatrixGF2& a, const vector<bool>& x) {
+    vector<bool> res(a.rows);
+    for (int i = 0; i < a.rows; i++) {
+        bool sum = false;
+        for (int j = 0; j < a.cols; j++)
+            sum ^= a.get(i, j) && x[j];
+        res[i] = sum;
+    }
+    return res;
+}
+
+static MatrixGF2 makeRandomMatrixGF2(int N, int M, int rank) {
+    // (N x rank) * (rank x M)
+    MatrixGF2 L(N, rank), R(rank, M), res(N, M);
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < rank; j++)
+            L.set(i, j, RandInt32::get() & 1);
+    for (int i = 0; i < rank; i++)
+        for (int j = 0; j < M; j++)
+            R.set(i, j, RandInt32::get() & 1);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < rank; j++) {
+            if (L.get(i, j))
+                MatrixGF2::xorWords(res[i], R[j], res.stride);
+        }
+    }
+    return res;
+}
+
 void testGaussianElimination() {
     //return; //TODO: if you want to test, make this line a comment.
 
@@ -102,5 +213,209 @@ void testGaussianElimination() {
         assert(int(ans[0]) == 1);
         assert(int(ans[1]) == 0);
     }
+    {
+        // M4RI
+        for (int iter = 0; iter < 200; iter++) {
+            int N = RandInt32::get() % 150 + 1, M = RandInt32::get() % 150 + 1;
+            int r = RandInt32::get() % (min(N, M) + 1);
+            MatrixGF2 a = makeRandomMatrixGF2(N, M, r);
+            vector<vector<unsigned long long>> rows(N);
+            for (int i = 0; i < N; i++)
+                rows[i].assign(a[i], a[i] + a.stride);
+            int gtRank = rankMod2Slow(rows, M);
+
+            // a solvable system
+            vector<bool> x0(M), x;
+            for (int j = 0; j < M; j++)
+                x0[j] = RandInt32::get() & 1;
+            vector<bool> b = multiplyMod2(a, x0);
+
+            MatrixGF2 ns;
+            int rank = SLAE::gaussMod2(a, b, x, &ns, 1 + iter % 3);
+            assert(rank == gtRank);
+            assert(multiplyMod2(a, x) == b);
+            assert(ns.rows == M - rank && ns.cols == M);
+            for (int i = 0; i < ns.rows; i++) {
+                vector<bool> v(M);
+                for (int j = 0; j < M; j++)
+                    v[j] = ns.get(i, j);
+                assert(multiplyMod2(a, v) == vector<bool>(N));
+            }
+            vector<vector<unsigned long long>> nsRows(ns.rows);
+            for (int i = 0; i < ns.rows; i++)
+                nsRows[i].assign(ns[i], ns[i] + ns.stride);
+            assert(rankMod2Slow(nsRows, M) == ns.rows);
+
+            // b outside of the column space
+            if (rank < N) {
+                vector<bool> b2;
+                for (int t = 0; t < 10; t++) {
+                    b2.assign(N, false);
+                    for (int i = 0; i < N; i++)
+                        b2[i] = RandInt32::get() & 1;
+                    vector<bool> y;
+                    int res = SLAE::gaussMod2(a, b2, y);
+                    if (res >= 0)
+                        assert(multiplyMod2(a, y) == b2);
+                    else
+                        assert(res == -1);
+                }
+            }
+        }
+    }
+    {
+        // blocked LU
+        for (int N : { 1, 2, 7, 63, 64, 65, 200, 300 }) {
+            auto a = makeRandomMatrix(N);
+            for (int threadN : { 1, 3 }) {
+                LUDecomposition lu;
+                assert(SLAE::factorize(lu, Matrix<double>(a), threadN));
+                for (int t = 0; t < 3; t++) {
+                    vector<double> b(N);
+                    for (auto& v : b)
+                        v = RandInt32::get() % 2001 / 1000.0 - 1.0;
+                    auto x = SLAE::solve(lu, b);
+                    for (int i = 0; i < N; i++) {
+                        double sum = 0;
+                        for (int j = 0; j < N; j++)
+                            sum += a[i][j] * x[j];
+                        assert(abs(sum - b[i]) < 1e-6);
+                    }
+                }
+                if (N <= 7)
+                    assert(abs(lu.det() - Matrix<double>(a).det()) < 1e-6);
+            }
+        }
+        {
+            LUDecomposition lu;
+            assert(!lu.factorize(vector<vector<double>>{ { 1, 2 }, { 2, 4 } }));
+            assert(lu.det() == 0.0);
+        }
+    }
+    {
+        // blocked LU (mod)
+        for (int N : { 1, 2, 7, 63, 64, 65, 200, 300 }) {
+            auto a = makeRandomMatrixMod(N);
+            for (int threadN : { 1, 3 }) {
+                LUDecompositionMod<MOD> lu;
+                int det = DetMod<int, MOD>::det(a, lu, threadN);
+                assert(det == (DetMod<int, MOD>::det(N, a)));
+                assert(det == (DetMod<int, MOD>::det(lu)));
+                assert(!lu.singular);
+                for (int t = 0; t < 3; t++) {
+                    vector<int> b(N);
+                    for (auto& v : b)
+                        v = RandInt32::get() % MOD;
+                    assert(multiplyMod(a, SLAEMod<MOD>::solve(lu, b)) == b);
+                    assert(multiplyMod(a, SLAEMod<MOD>::gauss(MatrixMod<MOD>(a), b)) == b);
+                }
+            }
+        }
+        {
+            // mod >= 2^30 : the previous elimination
+            const int BIG_MOD = 2147483647;
+            const int N = 70;
+            vector<vector<int>> a(N, vector<int>(N));
+            vector<int> b(N);
+            for (int i = 0; i < N; i++) {
+                for (int j = 0; j < N; j++)
+                    a[i][j] = RandInt32::get() % BIG_MOD;
+                b[i] = RandInt32::get() % BIG_MOD;
+            }
+            auto x = SLAEMod<BIG_MOD>::gauss(MatrixMod<BIG_MOD>(a), b);
+            for (int i = 0; i < N; i++) {
+                long long sum = 0;
+                for (int j = 0; j < N; j++)
+                    sum = (sum + 1ll * a[i][j] * x[j]) % BIG_MOD;
+                assert(sum == b[i]);
+            }
+        }
+        {
+            // singular
+            auto a = makeRandomMatrixMod(100);
+            a[70] = a[3];
+            LUDecompositionMod<MOD> lu;
+            assert((DetMod<int, MOD>::det(a, lu)) == 0 && lu.singular);
+        }
+    }
     cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        for (int N : { 2048, 4096 }) {
+            MatrixGF2 a = makeRandomMatrixGF2(N, N, N - 10);
+            vector<vector<unsigned long long>> rows(N);
+            for (int i = 0; i < N; i++)
+                rows[i].assign(a[i], a[i] + a.stride);
+
+            cout << "GF(2) rank, N = " << N << ", one row at a time : ";
+            PROFILE_HI_START(0);
+            int rank1 = rankMod2Slow(rows, N);
+            PROFILE_HI_STOP(0);
+
+            cout << "GF(2) rank, N = " << N << ", M4RI : ";
+            PROFILE_HI_START(1);
+            int rank2 = a.eliminate();
+            PROFILE_HI_STOP(1);
+
+            assert(rank1 == rank2);
+        }
+    }
+    {
+        for (int N : { 1000, 2000 }) {
+            auto a = makeRandomMatrix(N);
+            vector<double> b(N, 1.0);
+
+            cout << "Ax = b, N = " << N << ", unblocked elimination : ";
+            PROFILE_HI_START(2);
+            auto x1 = gaussSlow(a, b);
+            PROFILE_HI_STOP(2);
+
+            cout << "Ax = b, N = " << N << ", blocked LU : ";
+            PROFILE_HI_START(3);
+            auto x2 = SLAE::gauss(Matrix<double>(a), b);
+            PROFILE_HI_STOP(3);
+
+            for (int i = 0; i < N; i++)
+                assert(abs(x1[i] - x2[i]) < 1e-6 * max(1.0, abs(x1[i])));
+        }
+        {
+            int N = 4000;
+            auto a = makeRandomMatrix(N);
+            cout << "LU factorization, N = " << N << " : ";
+            LUDecomposition lu;
+            PROFILE_HI_START(4);
+            lu.factorize(a);
+            PROFILE_HI_STOP(4);
+
+            double sum = 0;
+            cout << "100 right-hand sides, N = " << N << " : ";
+            PROFILE_HI_START(5);
+            for (int t = 0; t < 100; t++)
+                sum += lu.solve(vector<double>(N, double(t)))[0];
+            PROFILE_HI_STOP(5);
+            cout << "    sum of x[0] = " << sum << endl;
+        }
+        {
+            int N = 1000;
+            auto a = makeRandomMatrixMod(N);
+
+            vector<vector<long long>> t(N, vector<long long>(N));
+            for (int i = 0; i < N; i++)
+                copy(a[i].begin(), a[i].end(), t[i].begin());
+
+            cout << "det mod p, N = " << N << ", DetMod : ";
+            PROFILE_HI_START(6);
+            long long det1 = DetMod<long long, MOD>::det(N, t);
+            PROFILE_HI_STOP(6);
+
+            cout << "det mod p, N = " << N << ", blocked LU : ";
+            LUDecompositionMod<MOD> lu;
+            PROFILE_HI_START(7);
+            long long det2 = DetMod<long long, MOD>::det(a, lu);
+            PROFILE_HI_STOP(7);
+
+            assert(det1 == det2);
+        }
+    }
 }
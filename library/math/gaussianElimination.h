@@ -1,14 +1,23 @@
 #pragma once
 
 #include "matrix.h"
+#include "matrixGF2.h"
+#include "luDecomposition.h"
 
 // SLAE = System of n linear algebraic equations
 // - A*x = b
 struct SLAE {
     // O(N^3), 'a' is a N x N matrix
-    static vector<double> gauss(Matrix<double> a, vector<double> b) {
+    // - a nonsingular 'a' is solved with the blocked LU factorization
+    static vector<double> gauss(const Matrix<double>& A, const vector<double>& B, int threadN = 1) {
+        LUDecomposition lu;
+        if (lu.factorize(A.mat, threadN))
+            return lu.solve(B);
+
         const double EPS = 1e-9;
 
+        Matrix<double> a(A);
+        vector<double> b(B);
         int N = a.N;
         for (int row = 0, col = 0; col < N && row < N; col++) {
             int best = row;
@@ -44,6 +53,17 @@ struct SLAE {
         return b;
     }
 
+    // O(N^3), returns false if 'a' is singular
+    // - the factorization is reused for many right-hand sides with solve()
+    static bool factorize(LUDecomposition& lu, const Matrix<double>& a, int threadN = 0) {
+        return lu.factorize(a.mat, threadN);
+    }
+
+    // O(N^2)
+    static vector<double> solve(const LUDecomposition& lu, const vector<double>& b) {
+        return lu.solve(b);
+    }
+
     static const int INF = 0x3f3f3f3f;
 
     // O(N^3), 'a' is a N x M matrix.
@@ -111,50 +131,72 @@ struct SLAE {
 
     //---
 
-    template <size_t SZ>
-    static long long gaussMod2(vector<bitset<SZ>> a, bitset<SZ> b, int N, int M, bitset<SZ>& ans) {
-        vector<int> where(M, -1);
-        for (int col = 0, row = 0; col < M && row < N; col++) {
-            for (int i = row; i < N; i++) {
-                if (a[i][col]) {
-                    swap(a[i], a[row]);
-                    break;
-                }
-            }
-            if (!a[row][col])
-                continue;
+    // M4RI, 'a' is a N x M matrix over GF(2), returns the rank of 'a' or -1 if A*x = b has no solution
+    // - x : a solution (M bits)
+    // - nullspace : a basis of { x | A*x = 0 }, a (M - rank) x M matrix
+    static int gaussMod2(const MatrixGF2& a, const vector<bool>& b, vector<bool>& x, MatrixGF2* nullspace = nullptr,
+                         int threadN = 0) {
+        int N = a.rows, M = a.cols;
 
-            where[col] = row;
-            for (int i = 0; i < N; i++) {
-                if (i != row && a[i][col]) {
-                    a[i] ^= a[row];
-                    b[i] = b[i] ^ b[row];
+        // [ A | b ]
+        MatrixGF2 ab(N, M + 1);
+        for (int i = 0; i < N; i++) {
+            copy(a[i], a[i] + a.stride, ab[i]);
+            ab.set(i, M, b[i]);
+        }
+
+        vector<int> pivots;
+        int rank = ab.eliminate(M, threadN, &pivots);
+
+        x.assign(M, false);
+        for (int i = rank; i < N; i++) {
+            if (ab.get(i, M))
+                return -1;
+        }
+        for (int i = 0; i < rank; i++)
+            x[pivots[i]] = ab.get(i, M);
+
+        if (nullspace) {
+            vector<bool> isPivot(M);
+            for (int c : pivots)
+                isPivot[c] = true;
+
+            *nullspace = MatrixGF2(M - rank, M);
+            for (int f = 0, k = 0; f < M; f++) {
+                if (isPivot[f])
+                    continue;
+                nullspace->set(k, f, true);
+                for (int i = 0; i < rank; i++) {
+                    if (ab.get(i, f))
+                        nullspace->set(k, pivots[i], true);
                 }
+                k++;
             }
-
-            row++;
         }
 
-        ans.reset();
-        for (int i = 0; i < M; i++) {
-            if (where[i] >= 0)
-                ans[i] = b[where[i]];
-        }
+        return rank;
+    }
 
+    // returns the number of solutions (0 : no solution)
+    template <size_t SZ>
+    static long long gaussMod2(const vector<bitset<SZ>>& a, const bitset<SZ>& b, int N, int M, bitset<SZ>& ans) {
+        MatrixGF2 A(N, M);
+        vector<bool> B(N), x;
         for (int i = 0; i < N; i++) {
-            int sum = 0;
-            for (int j = 0; j < M; j++)
-                sum ^= int(ans[j]) & int(a[i][j]);
-            if (sum != int(b[i]))
-                return 0ll;
+            for (int j = 0; j < M; j++) {
+                if (a[i][j])
+                    A.set(i, j, true);
+            }
+            B[i] = b[i];
         }
 
-        long long res = 1ll;
-        for (int i = 0; i < M; i++) {
-            if (where[i] == -1)
-                res <<= 1;
-        }
+        int rank = gaussMod2(A, B, x, nullptr, 1);
+        ans.reset();
+        if (rank < 0)
+            return 0ll;
 
-        return res;
+        for (int i = 0; i < M; i++)
+            ans[i] = x[i];
+        return 1ll << (M - rank);
     }
 };
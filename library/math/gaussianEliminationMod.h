@@ -1,13 +1,21 @@
 #pragma once
 
 #include "matrixMod.h"
+#include "luDecomposition.h"
 
 // SLAE = System of n linear algebraic equations
 // - A*x = b
 template <int mod = 1'000'000'007>
 struct SLAEMod {
-    // O(N^3), 'a' is a N x N matrix
-    static vector<int> gauss(MatrixMod<mod> A, vector<int> b) {
+    // O(N^3), 'a' is a N x N matrix, mod must be a prime number
+    // - a nonsingular 'a' is solved with the blocked LU factorization if mod < 2^30
+    static vector<int> gauss(const MatrixMod<mod>& a, const vector<int>& B, int threadN = 1) {
+        vector<int> x;
+        if (solveLU(x, a, B, threadN, integral_constant<bool, (mod < (1 << 30))>()))
+            return x;
+
+        MatrixMod<mod> A(a);
+        vector<int> b(B);
         int N = A.N;
         for (int row = 0, col = 0; col < N && row < N; col++) {
             int best = -1;
@@ -44,7 +52,31 @@ struct SLAEMod {
         return b;
     }
 
+    // O(N^3), returns false if 'a' is singular
+    // - the factorization is reused for many right-hand sides with solve()
+    static bool factorize(LUDecompositionMod<mod>& lu, const MatrixMod<mod>& a, int threadN = 0) {
+        return lu.factorize(a.mat, threadN);
+    }
+
+    // O(N^2)
+    static vector<int> solve(const LUDecompositionMod<mod>& lu, const vector<int>& b) {
+        return lu.solve(b);
+    }
+
 private:
+    static bool solveLU(vector<int>& x, const MatrixMod<mod>& a, const vector<int>& b, int threadN, true_type) {
+        LUDecompositionMod<mod> lu;
+        if (!lu.factorize(a.mat, threadN))
+            return false;
+        x = lu.solve(b);
+        return true;
+    }
+
+    // LUDecompositionMod needs mod < 2^30
+    static bool solveLU(vector<int>&, const MatrixMod<mod>&, const vector<int>&, int, false_type) {
+        return false;
+    }
+
     static int modPow(int x, int n) {
         if (n == 0)
             return 1;
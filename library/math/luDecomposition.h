@@ -0,0 +1,331 @@
+#pragma once
+
+#include <numeric>
+#include "denseMatrix.h"
+
+/*
+  Right-looking blocked LU factorization with partial pivoting, P*A = L*U
+
+  - for each panel of PANEL columns
+    1) the panel (N x PANEL) is factorized column by column, pivot rows are swapped in whole
+    2) U12 = L11^-1 * A12
+    3) A22 -= L21 * U12, the trailing matrix update holds almost all of the work and is split across threads
+       (LUDecomposition : rows of A22 per thread, LUDecompositionMod : DenseMatrixMod::multiply)
+  - a factorization is reused for any number of right-hand sides, solve() is O(N^2)
+
+  <How to use>
+    LUDecomposition lu;
+    if (lu.factorize(A)) {
+        auto x1 = lu.solve(b1);
+        auto x2 = lu.solve(b2);
+    }
+*/
+
+struct LUDecomposition {
+    static const int PANEL = 64;
+    static const int BLOCK_J = 512;
+    static const int PARALLEL_THRESHOLD = 256;
+
+    int N;
+    DenseMatrix<double> lu;             // L (unit lower, without the diagonal) and U
+    vector<int> perm;                   // row i of P*A = row perm[i] of A
+    int sign;                           // the sign of P
+    bool singular;
+
+    LUDecomposition() : N(0), sign(1), singular(true) {
+    }
+
+    // O(N^3), returns false if 'a' is singular
+    bool factorize(const vector<vector<double>>& a, int threadN = 0) {
+        lu = DenseMatrix<double>(a);
+        return factorize(threadN);
+    }
+
+    bool factorize(const DenseMatrix<double>& a, int threadN = 0) {
+        lu = a;
+        return factorize(threadN);
+    }
+
+    // O(N^2), PRECONDITION: !singular
+    vector<double> solve(const vector<double>& b) const {
+        vector<double> x(N);
+        for (int i = 0; i < N; i++)
+            x[i] = b[perm[i]];
+
+        for (int i = 0; i < N; i++) {
+            const double* row = lu[i];
+            double sum = x[i];
+            for (int j = 0; j < i; j++)
+                sum -= row[j] * x[j];
+            x[i] = sum;
+        }
+        for (int i = N - 1; i >= 0; i--) {
+            const double* row = lu[i];
+            double sum = x[i];
+            for (int j = i + 1; j < N; j++)
+                sum -= row[j] * x[j];
+            x[i] = sum / row[i];
+        }
+        return x;
+    }
+
+    double det() const {
+        if (singular)
+            return 0.0;
+        double res = sign;
+        for (int i = 0; i < N; i++)
+            res *= lu[i][i];
+        return res;
+    }
+
+private:
+    bool factorize(int threadN) {
+        const double EPS = 1e-9;
+
+        N = lu.rows;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+        perm.resize(N);
+        iota(perm.begin(), perm.end(), 0);
+        sign = 1;
+        singular = false;
+
+        for (int kb = 0; kb < N; kb += PANEL) {
+            int kEnd = min(N, kb + PANEL);
+
+            // 1) panel
+            for (int k = kb; k < kEnd; k++) {
+                int best = k;
+                for (int i = k + 1; i < N; i++) {
+                    if (abs(lu[best][k]) < abs(lu[i][k]))
+                        best = i;
+                }
+                if (abs(lu[best][k]) < EPS) {
+                    singular = true;
+                    return false;
+                }
+                if (best != k) {
+                    swap_ranges(lu[k], lu[k] + N, lu[best]);
+                    swap(perm[k], perm[best]);
+                    sign = -sign;
+                }
+
+                double inv = 1.0 / lu[k][k];
+                const double* pivotRow = lu[k];
+                for (int i = k + 1; i < N; i++) {
+                    double* row = lu[i];
+                    double x = (row[k] *= inv);
+                    for (int j = k + 1; j < kEnd; j++)
+                        row[j] -= x * pivotRow[j];
+                }
+            }
+            if (kEnd >= N)
+                break;
+
+            // 2) U12 = L11^-1 * A12
+            for (int k = kb; k < kEnd; k++) {
+                for (int i = k + 1; i < kEnd; i++)
+                    DenseMatrix<double>::addScaledRow(lu[i] + kEnd, -lu[i][k], lu[k] + kEnd, N - kEnd);
+            }
+
+            // 3) A22 -= L21 * U12
+            int tn = (N - kEnd >= PARALLEL_THRESHOLD) ? threadN : 1;
+            Parallel::forRange(kEnd, N, tn, [&](int lo, int hi) {
+                for (int jb = kEnd; jb < N; jb += BLOCK_J) {
+                    int jn = min(BLOCK_J, N - jb);
+                    for (int i = lo; i < hi; i++) {
+                        double* row = lu[i];
+                        int k = kb;
+                        for (; k + 4 <= kEnd; k += 4)
+                            subtract4(row + jb, row + k, lu[k] + jb, N, jn);
+                        for (; k < kEnd; k++)
+                            DenseMatrix<double>::addScaledRow(row + jb, -row[k], lu[k] + jb, jn);
+                    }
+                }
+            });
+        }
+        return true;
+    }
+
+    // y[0..n) -= SUM_{t=0..3} a[t] * x[t * stride + 0..n)
+    static void subtract4(double* y, const double* a, const double* x, int stride, int n) {
+        if (CpuFeature::hasAVX2()) {
+            subtract4AVX2(y, a, x, stride, n);
+            return;
+        }
+        const double* x1 = x + stride;
+        const double* x2 = x1 + stride;
+        const double* x3 = x2 + stride;
+        for (int j = 0; j < n; j++)
+            y[j] -= a[0] * x[j] + a[1] * x1[j] + a[2] * x2[j] + a[3] * x3[j];
+    }
+
+    TARGET_AVX2
+    static void subtract4AVX2(double* y, const double* a, const double* x, int stride, int n) {
+        const double* x1 = x + stride;
+        const double* x2 = x1 + stride;
+        const double* x3 = x2 + stride;
+        __m256d a0 = _mm256_set1_pd(a[0]), a1 = _mm256_set1_pd(a[1]);
+        __m256d a2 = _mm256_set1_pd(a[2]), a3 = _mm256_set1_pd(a[3]);
+        int j = 0;
+        for (; j + 4 <= n; j += 4) {
+            __m256d s = _mm256_add_pd(_mm256_mul_pd(a0, _mm256_loadu_pd(x + j)), _mm256_mul_pd(a1, _mm256_loadu_pd(x1 + j)));
+            __m256d t = _mm256_add_pd(_mm256_mul_pd(a2, _mm256_loadu_pd(x2 + j)), _mm256_mul_pd(a3, _mm256_loadu_pd(x3 + j)));
+            _mm256_storeu_pd(y + j, _mm256_sub_pd(_mm256_loadu_pd(y + j), _mm256_add_pd(s, t)));
+        }
+        for (; j < n; j++)
+            y[j] -= a[0] * x[j] + a[1] * x1[j] + a[2] * x2[j] + a[3] * x3[j];
+    }
+};
+
+
+// P*A = L*U over the integers modulo a prime number 'mod'
+template <int mod = 1'000'000'007>
+struct LUDecompositionMod {
+    static const int PANEL = 64;
+
+    int N;
+    DenseMatrixMod<mod> lu;             // L (unit lower, without the diagonal) and U
+    vector<int> perm;                   // row i of P*A = row perm[i] of A
+    int sign;                           // the sign of P
+    bool singular;
+
+    LUDecompositionMod() : N(0), sign(1), singular(true) {
+    }
+
+    // O(N^3), returns false if 'a' is singular, elements must be in [0, mod)
+    bool factorize(const vector<vector<int>>& a, int threadN = 0) {
+        lu = DenseMatrixMod<mod>(a);
+        return factorize(threadN);
+    }
+
+    bool factorize(const DenseMatrixMod<mod>& a, int threadN = 0) {
+        lu = a;
+        return factorize(threadN);
+    }
+
+    // O(N^2), PRECONDITION: !singular
+    vector<int> solve(const vector<int>& b) const {
+        vector<int> x(N);
+        for (int i = 0; i < N; i++)
+            x[i] = b[perm[i]];
+
+        for (int i = 0; i < N; i++)
+            x[i] = int((x[i] + mod - dot(lu[i], x.data(), 0, i)) % mod);
+        for (int i = N - 1; i >= 0; i--) {
+            long long t = (x[i] + mod - dot(lu[i], x.data(), i + 1, N)) % mod;
+            x[i] = int(t * modInv(lu[i][i]) % mod);
+        }
+        return x;
+    }
+
+    int det() const {
+        if (singular)
+            return 0;
+        long long res = (sign > 0) ? 1 : mod - 1;
+        for (int i = 0; i < N; i++)
+            res = res * lu[i][i] % mod;
+        return int(res);
+    }
+
+private:
+    bool factorize(int threadN) {
+        N = lu.rows;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+        perm.resize(N);
+        iota(perm.begin(), perm.end(), 0);
+        sign = 1;
+        singular = false;
+
+        for (int kb = 0; kb < N; kb += PANEL) {
+            int kEnd = min(N, kb + PANEL);
+
+            // 1) panel
+            for (int k = kb; k < kEnd; k++) {
+                int best = k;
+                while (best < N && lu[best][k] == 0)
+                    best++;
+                if (best >= N) {
+                    singular = true;
+                    return false;
+                }
+                if (best != k) {
+                    swap_ranges(lu[k], lu[k] + N, lu[best]);
+                    swap(perm[k], perm[best]);
+                    sign = -sign;
+                }
+
+                long long inv = modInv(lu[k][k]);
+                const int* pivotRow = lu[k];
+                for (int i = k + 1; i < N; i++) {
+                    int* row = lu[i];
+                    if (row[k] == 0)
+                        continue;
+                    long long x = row[k] * inv % mod;
+                    row[k] = int(x);
+                    long long negX = mod - x;
+                    for (int j = k + 1; j < kEnd; j++)
+                        row[j] = int((row[j] + negX * pivotRow[j]) % mod);
+                }
+            }
+            if (kEnd >= N)
+                break;
+
+            // 2) U12 = L11^-1 * A12
+            for (int k = kb; k < kEnd; k++) {
+                const int* pivotRow = lu[k];
+                for (int i = k + 1; i < kEnd; i++) {
+                    int* row = lu[i];
+                    if (row[k] == 0)
+                        continue;
+                    long long negX = mod - row[k];
+                    for (int j = kEnd; j < N; j++)
+                        row[j] = int((row[j] + negX * pivotRow[j]) % mod);
+                }
+            }
+
+            // 3) A22 -= L21 * U12
+            int m = N - kEnd, nb = kEnd - kb;
+            DenseMatrixMod<mod> L21(m, nb), U12(nb, m), P;
+            for (int i = 0; i < m; i++)
+                copy(lu[kEnd + i] + kb, lu[kEnd + i] + kEnd, L21[i]);
+            for (int k = 0; k < nb; k++)
+                copy(lu[kb + k] + kEnd, lu[kb + k] + N, U12[k]);
+            DenseMatrixMod<mod>::multiply(P, L21, U12, threadN);
+
+            Parallel::forRange(0, m, (m >= DenseMatrixMod<mod>::PARALLEL_THRESHOLD) ? threadN : 1, [&](int lo, int hi) {
+                for (int i = lo; i < hi; i++) {
+                    int* row = lu[kEnd + i] + kEnd;
+                    const int* p = P[i];
+                    for (int j = 0; j < m; j++) {
+                        int x = row[j] - p[j];
+                        row[j] = (x < 0) ? x + mod : x;
+                    }
+                }
+            });
+        }
+        return true;
+    }
+
+    // SUM_{j=lo..hi-1} row[j] * x[j] (mod mod)
+    static long long dot(const int* row, const int* x, int lo, int hi) {
+        unsigned long long sum = 0;
+        for (int j = lo; j < hi; j++) {
+            sum += 1ull * row[j] * unsigned(x[j]);
+            if (sum >= (1ull << 63))
+                sum %= mod;
+        }
+        return (long long)(sum % mod);
+    }
+
+    static long long modInv(long long x) {
+        long long res = 1, t = x % mod;
+        for (int n = mod - 2; n > 0; n >>= 1) {
+            if (n & 1)
+                res = res * t % mod;
+            t = t * t % mod;
+        }
+        return res;
+    }
+};
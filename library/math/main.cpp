@@ -7,6 +7,7 @@ using namespace std;
 
 int main(void) {
     TEST(Matrix);
+    TEST(DenseMatrix);
     TEST(Fibonacci);
     TEST(TernarySearch);
     TEST(TernarySearch3D);
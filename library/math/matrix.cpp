@@ -49,6 +49,29 @@ static long long fibonacciSlow(int n) {
     return b;
 }
 
+template <int mod>
+static void testMatrixModMultiply(int N) {
+    MatrixMod<mod> a(N), b(N);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            a[i][j] = static_cast<int>((1ll * i * 1000003 + j * 7919 + 12345) % mod);
+            b[i][j] = static_cast<int>((1ll * j * 999983 + i * 104729 + 54321) % mod);
+        }
+    }
+
+    auto c = a * b;
+    auto d = a * 3;
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            long long x = 0;
+            for (int k = 0; k < N; k++)
+                x = (x + 1ll * a[i][k] * b[k][j]) % mod;
+            assert(c[i][j] == x);
+            assert(d[i][j] == 3ll * a[i][j] % mod);
+        }
+    }
+}
+
 void testMatrix() {
     return; //TODO: if you want to test, make this line a comment.
 
@@ -93,6 +116,13 @@ void testMatrix() {
         }
     }
 
+    // mods that MontgomeryModInt and DenseMatrixMod do not take
+    for (int N : { 10, 70 }) {
+        testMatrixModMultiply<1 << 20>(N);
+        testMatrixModMultiply<2147483647>(N);
+        testMatrixModMultiply<1000000007>(N);
+    }
+
     PROFILE_START(0);
     for (int i = 0; i <= 1000; i++) {
         auto t = fibonacci<long long>(i);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "denseMatrix.h"
+
 //-----------------------------------------------------------------------------
 
 template <typename T>
@@ -271,8 +273,18 @@ struct Matrix {
     }
 
 
+    static const int DENSE_THRESHOLD = 64;
+
     static void multiply(Matrix& out, const Matrix& left, const Matrix& right) {
         int N = left.N;
+        if (N >= DENSE_THRESHOLD) {
+            DenseMatrix<T> res;
+            DenseMatrix<T>::multiply(res, DenseMatrix<T>(left.mat), DenseMatrix<T>(right.mat));
+            res.copyTo(out.mat);
+            out.N = N;
+            return;
+        }
+
         for (int r = 0; r < N; r++) {
             for (int c = 0; c < N; c++) {
                 out[r][c] = 0;
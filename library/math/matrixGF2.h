@@ -0,0 +1,197 @@
+#pragma once
+
+#include "../integer/bit.h"
+#include "../common/cpuFeature.h"
+#include "../common/parallel.h"
+
+/*
+  A runtime-sized matrix over GF(2) with 64-bit word rows
+
+  - eliminate() brings the matrix to reduced row echelon form with the Method of Four Russians (M4RI)
+    1) up to k pivots are found in the next k columns (only the bits of these columns are looked at)
+    2) all 2^k combinations of the k pivot rows are built in Gray code order (one row XOR each)
+    3) every other row is cleared in these columns with a single XOR of a table row
+    => O(N^2 * M / (64 * k)) word operations instead of O(N^2 * M / 64)
+  - row XORs use AVX2 when the CPU supports it, step 3) is split across threads for large matrices
+
+  <How to use>
+    MatrixGF2 A(N, M);
+    A.set(r, c, true);
+    vector<int> pivots;
+    int rank = A.eliminate(M, 0, &pivots);
+*/
+
+struct MatrixGF2 {
+    typedef unsigned long long u64;
+
+    static const int MAX_K = 10;
+    static const int PARALLEL_THRESHOLD = 1 << 20;  // words updated in one step
+
+    int rows, cols;
+    int stride;                                     // words per row, a multiple of 4
+    vector<u64> data;
+
+    MatrixGF2() : rows(0), cols(0), stride(0) {
+    }
+
+    MatrixGF2(int rows, int cols) : rows(rows), cols(cols), stride((cols + 255) / 256 * 4), data(size_t(rows) * stride) {
+    }
+
+    u64* operator [](int row) {
+        return data.data() + size_t(row) * stride;
+    }
+
+    const u64* operator [](int row) const {
+        return data.data() + size_t(row) * stride;
+    }
+
+    bool get(int row, int col) const {
+        return (((*this)[row][col >> 6] >> (col & 63)) & 1) != 0;
+    }
+
+    void set(int row, int col, bool value) {
+        u64& w = (*this)[row][col >> 6];
+        w = (w & ~(1ull << (col & 63))) | (u64(value) << (col & 63));
+    }
+
+    void flip(int row, int col) {
+        (*this)[row][col >> 6] ^= 1ull << (col & 63);
+    }
+
+    void swapRows(int r1, int r2) {
+        if (r1 != r2)
+            swap_ranges((*this)[r1], (*this)[r1] + stride, (*this)[r2]);
+    }
+
+    // dst[0..n) ^= src[0..n)
+    static void xorWords(u64* dst, const u64* src, int n) {
+        if (CpuFeature::hasAVX2())
+            xorWordsAVX2(dst, src, n);
+        else {
+            for (int i = 0; i < n; i++)
+                dst[i] ^= src[i];
+        }
+    }
+
+    // reduced row echelon form of the first 'colLimit' columns (-1 : all columns), returns the rank
+    // - pivots[i] = the pivot column of row i (i < rank)
+    // - threadN = 0 : all hardware threads
+    int eliminate(int colLimit = -1, int threadN = 0, vector<int>* pivots = nullptr) {
+        if (colLimit < 0 || colLimit > cols)
+            colLimit = cols;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        int K = max(1, min(MAX_K, log2Int(unsigned(max(2, min(rows, colLimit)))) * 3 / 4));
+        vector<u64> table(size_t(stride) << K);
+        vector<int> pivotCols;
+        vector<u64> pivotWindow;                    // bits of the pivot rows in the current window
+
+        if (pivots)
+            pivots->clear();
+
+        int r = 0;
+        for (int c = 0; c < colLimit && r < rows; ) {
+            int k = min(K, colLimit - c);
+            int w0 = c >> 6;
+            int words = stride - w0;
+
+            // 1) up to k pivots in columns [c, c + k)
+            pivotCols.clear();
+            pivotWindow.clear();
+            for (int col = 0; col < k && r + int(pivotCols.size()) < rows; col++) {
+                int kk = int(pivotCols.size());
+                int found = -1;
+                for (int i = r + kk; i < rows; i++) {
+                    u64 w = window(i, c, k);
+                    for (int j = 0; j < kk; j++) {
+                        if ((w >> pivotCols[j]) & 1)
+                            w ^= pivotWindow[j];
+                    }
+                    if ((w >> col) & 1) {
+                        found = i;
+                        break;
+                    }
+                }
+                if (found < 0)
+                    continue;
+
+                int p = r + kk;
+                swapRows(p, found);
+                for (int j = 0; j < kk; j++) {
+                    if (get(p, c + pivotCols[j]))
+                        xorWords((*this)[p] + w0, (*this)[r + j] + w0, words);
+                }
+                for (int j = 0; j < kk; j++) {
+                    if (get(r + j, c + col)) {
+                        xorWords((*this)[r + j] + w0, (*this)[p] + w0, words);
+                        pivotWindow[j] = window(r + j, c, k);
+                    }
+                }
+                pivotCols.push_back(col);
+                pivotWindow.push_back(window(p, c, k));
+            }
+
+            int kk = int(pivotCols.size());
+            if (kk > 0) {
+                // 2) table[g] = XOR of the pivot rows selected by g, in Gray code order
+                fill(table.begin(), table.begin() + words, 0ull);
+                for (int i = 1, prev = 0; i < (1 << kk); i++) {
+                    int g = i ^ (i >> 1);
+                    u64* dst = table.data() + size_t(g) * stride;
+                    const u64* src = table.data() + size_t(prev) * stride;
+                    const u64* row = (*this)[r + ctz(unsigned(i))] + w0;
+                    for (int j = 0; j < words; j++)
+                        dst[j] = src[j] ^ row[j];
+                    prev = g;
+                }
+
+                // 3) clear the pivot columns of the other rows
+                int tn = (size_t(rows) * words >= size_t(PARALLEL_THRESHOLD)) ? threadN : 1;
+                Parallel::forRange(0, rows, tn, [&](int lo, int hi) {
+                    for (int i = lo; i < hi; i++) {
+                        if (r <= i && i < r + kk)
+                            continue;
+                        u64 w = window(i, c, k);
+                        int g = 0;
+                        for (int j = 0; j < kk; j++)
+                            g |= int((w >> pivotCols[j]) & 1) << j;
+                        if (g)
+                            xorWords((*this)[i] + w0, table.data() + size_t(g) * stride, words);
+                    }
+                });
+
+                if (pivots) {
+                    for (int j = 0; j < kk; j++)
+                        pivots->push_back(c + pivotCols[j]);
+                }
+                r += kk;
+            }
+            c += k;
+        }
+        return r;
+    }
+
+private:
+    // bits [c, c + k) of a row, k <= 64
+    u64 window(int row, int c, int k) const {
+        const u64* p = (*this)[row];
+        int w = c >> 6, s = c & 63;
+        u64 res = p[w] >> s;
+        if (s + k > 64)
+            res |= p[w + 1] << (64 - s);
+        return (k < 64) ? (res & ((1ull << k) - 1)) : res;
+    }
+
+    TARGET_AVX2
+    static void xorWordsAVX2(u64* dst, const u64* src, int n) {
+        int i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, b));
+        }
+        for (; i < n; i++)
+            dst[i] ^= src[i];
+    }
+};
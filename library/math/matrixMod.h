@@ -1,5 +1,8 @@
 #pragma once
 
+#include "../integer/fastModInt.h"
+#include "denseMatrix.h"
+
 template <int mod>
 struct MatrixMod {
     int N;
@@ -122,17 +125,12 @@ struct MatrixMod {
     }
 
     MatrixMod<mod>& operator *=(int x) {
-        for (int i = 0; i < N; i++)
-            for (int j = 0; j < N; j++)
-                mat[i][j] = static_cast<int>(1ll * mat[i][j] * x % mod);
+        scale(x, integral_constant<bool, (mod & 1) != 0 && mod < (1 << 30)>());
         return *this;
     }
 
     MatrixMod<mod>& operator /=(int x) {
-        for (int i = 0; i < N; i++)
-            for (int j = 0; j < N; j++)
-                mat[i][j] = static_cast<int>(1ll * mat[i][j] * modInv(x) % mod);
-        return *this;
+        return operator *=(modInv(x));
     }
 
     MatrixMod<mod>& operator *=(const MatrixMod<mod>& rhs) {
@@ -251,6 +249,7 @@ struct MatrixMod {
     }
 
     int det2() const {
+        auto a = mat;
         long long res = 1;
         for (int i = 0; i < N; i++) {
             for (int j = i + 1; j < N; j++) {
@@ -277,9 +276,9 @@ struct MatrixMod {
             res[i][i] = 1;
 
         auto mat = this->mat;
-        for (int i = 0; i < n; i++) {
+        for (int i = 0; i < N; i++) {
             int selected = -1;
-            for (int j = i; j < n; j++) {
+            for (int j = i; j < N; j++) {
                 if (mat[j][i]) {
                     selected = j;
                     break;
@@ -323,17 +322,16 @@ struct MatrixMod {
     }
 
 
+    static const int DENSE_THRESHOLD = 64;
+
+    // out = left * right, elements must be in [0, mod)
+    // - N >= DENSE_THRESHOLD and mod < 2^30 : converted to DenseMatrixMod (cache-blocked, SIMD, threads, Strassen)
+    // - otherwise : Montgomery dot products if mod is odd and less than 2^30, '%' for the other mods
     static void multiply(MatrixMod<mod>& out, const MatrixMod<mod>& left, const MatrixMod<mod>& right) {
-        int N = left.N;
-        for (int r = 0; r < N; r++) {
-            for (int c = 0; c < N; c++) {
-                long long x = 0;
-                for (int k = 0; k < N; k++) {
-                    x = (x + 1ll * left[r][k] * right[k][c]) % mod;
-                }
-                out[r][c] = static_cast<int>(x);
-            }
-        }
+        if (left.N >= DENSE_THRESHOLD && multiplyDense(out, left, right, integral_constant<bool, (mod < (1 << 30))>()))
+            return;
+
+        multiplySmall(out, left, right, integral_constant<bool, (mod & 1) != 0 && mod < (1 << 30)>());
     }
 
     static const MatrixMod<mod>& getIdentity(int N) {
@@ -365,6 +363,73 @@ struct MatrixMod {
     }
 
 private:
+    static bool multiplyDense(MatrixMod<mod>& out, const MatrixMod<mod>& left, const MatrixMod<mod>& right, true_type) {
+        DenseMatrixMod<mod> res;
+        DenseMatrixMod<mod>::multiply(res, DenseMatrixMod<mod>(left.mat), DenseMatrixMod<mod>(right.mat));
+        res.copyTo(out.mat);
+        out.N = left.N;
+        return true;
+    }
+
+    // DenseMatrixMod needs mod < 2^30
+    static bool multiplyDense(MatrixMod<mod>&, const MatrixMod<mod>&, const MatrixMod<mod>&, false_type) {
+        return false;
+    }
+
+    // Montgomery dot products over the columns of 'right'
+    static void multiplySmall(MatrixMod<mod>& out, const MatrixMod<mod>& left, const MatrixMod<mod>& right, true_type) {
+        typedef MontgomeryModInt<mod> MInt;
+
+        int N = left.N;
+
+        // rows of 'left' and columns of 'right' in Montgomery form, out[r][c] = dot(row r, column c)
+        vector<MInt> L(size_t(N) * N), R(size_t(N) * N), RT(size_t(N) * N);
+        for (int i = 0; i < N; i++) {
+            MInt::fromInt(&L[size_t(i) * N], left[i].data(), N);
+            MInt::fromInt(&R[size_t(i) * N], right[i].data(), N);
+        }
+        for (int k = 0; k < N; k++)
+            for (int c = 0; c < N; c++)
+                RT[size_t(c) * N + k] = R[size_t(k) * N + c];
+
+        for (int r = 0; r < N; r++) {
+            const MInt* row = &L[size_t(r) * N];
+            for (int c = 0; c < N; c++)
+                out[r][c] = MInt::dot(row, &RT[size_t(c) * N], N).get();
+        }
+    }
+
+    static void multiplySmall(MatrixMod<mod>& out, const MatrixMod<mod>& left, const MatrixMod<mod>& right, false_type) {
+        int N = left.N;
+        for (int r = 0; r < N; r++) {
+            for (int c = 0; c < N; c++) {
+                long long x = 0;
+                for (int k = 0; k < N; k++) {
+                    x = (x + 1ll * left[r][k] * right[k][c]) % mod;
+                }
+                out[r][c] = static_cast<int>(x);
+            }
+        }
+    }
+
+    void scale(int x, true_type) {
+        typedef MontgomeryModInt<mod> MInt;
+
+        MInt y(x);
+        vector<MInt> row(N);
+        for (int i = 0; i < N; i++) {
+            MInt::fromInt(row.data(), mat[i].data(), N);
+            MInt::multiply(row.data(), row.data(), y, N);
+            MInt::toInt(mat[i].data(), row.data(), N);
+        }
+    }
+
+    void scale(int x, false_type) {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                mat[i][j] = static_cast<int>(1ll * mat[i][j] * x % mod);
+    }
+
     static int modPow(int x, int n) {
         if (n == 0)
             return 1;
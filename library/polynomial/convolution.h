@@ -71,4 +71,54 @@ struct Convolution {
 
         return res;
     }
+
+    //--- with a transform plan (no root recomputation, no scratch allocation)
+
+    // y[0..xN+hN-2] = x * h, plan.size() >= xN + hN - 1
+    static void convolute(const int* x, int xN, const int* h, int hN, int* y, FFTPlan& plan, bool reverseH = true) {
+        typedef FFTPlan::Complex Complex;
+
+        int sizeDst = xN + hN - 1;
+        int size = plan.size();
+        //assert(size >= sizeDst);
+
+        // x as the real part and h as the imaginary part, one forward transform
+        Complex* A = plan.buffer(0);
+        Complex* C = plan.buffer(1);
+        for (int i = 0; i < size; i++)
+            A[i] = Complex(i < xN ? double(x[i]) : 0.0, 0.0);
+        if (reverseH) {
+            for (int i = 0; i < hN; i++)
+                A[i].second = h[i];
+        } else {
+            for (int i = 0, j = hN - 1; j >= 0; i++, j--)
+                A[i].second = h[j];
+        }
+
+        plan.fft(A, C);
+
+        // X[k] = (Z[k] + conj(Z[-k])) / 2, H[k] = (Z[k] - conj(Z[-k])) / 2i, C = X * H
+        auto mul = [](const Complex& z, const Complex& zr) {
+            double xr = (z.first + zr.first) * 0.5, xi = (z.second - zr.second) * 0.5;
+            double hr = (z.second + zr.second) * 0.5, hi = (zr.first - z.first) * 0.5;
+            return Complex(xr * hr - xi * hi, xr * hi + xi * hr);
+        };
+        for (int i = 0; i <= (size >> 1); i++) {
+            int j = (size - i) & (size - 1);
+            Complex zi = C[i], zj = C[j];
+            C[i] = mul(zi, zj);
+            C[j] = mul(zj, zi);
+        }
+
+        plan.fft(C, A, true);
+
+        for (int i = 0; i < sizeDst; i++)
+            y[i] = int(floor(A[i].first + 0.5));
+    }
+
+    static vector<int> convolute(const vector<int>& x, const vector<int>& h, FFTPlan& plan, bool reverseH = true) {
+        vector<int> res(x.size() + h.size() - 1);
+        convolute(x.data(), int(x.size()), h.data(), int(h.size()), res.data(), plan, reverseH);
+        return res;
+    }
 };
@@ -4,6 +4,8 @@
 #define M_PI       3.14159265358979323846   // pi
 #endif
 
+#include "transformPlan.h"
+
 struct FFT {
     static bool fft(const vector<pair<double,double>>& in, vector<pair<double,double>>& out, bool inverse = false) {
         int size = int(in.size());
@@ -89,4 +91,13 @@ struct FFT {
 
         return true;
     }
+
+    // with a precomputed plan, data.size() == plan.size()
+    static bool fft(vector<pair<double,double>>& data, const FFTPlan& plan, bool inverse = false) {
+        if (int(data.size()) != plan.size())
+            return false;
+
+        plan.fft(data.data(), inverse);
+        return true;
+    }
 };
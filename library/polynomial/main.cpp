@@ -25,4 +25,7 @@ int main(void) {
     TEST(PolynomialSum);
     TEST(ModComplex);
     TEST(PolynomialProduct);
+    TEST(TransformPlan);
+    TEST(OnlineConvolution);
+    TEST(SubproductTree);
 }
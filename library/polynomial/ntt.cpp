@@ -1,11 +1,15 @@
 #include <vector>
 #include <algorithm>
+#include <iomanip>
 
 using namespace std;
 
 #include "ntt.h"
 #include "ntt_fast.h"
+#include "ntt_montgomery.h"
+#include "ntt_avx2.h"
 #include "polyNTT.h"
+#include "polyNTTParallel.h"
 #include "factorialNTT.h"
 
 /////////// For Testing ///////////////////////////////////////////////////////
@@ -280,6 +284,163 @@ void testNTT() {
             assert(out1 == out2);
         }
     }
+    {
+        for (int n = 1; n <= 5000; n = n * 3 + 1) {
+            for (int m = 1; m <= 5000; m = m * 5 + 2) {
+                vector<int> A(n);
+                vector<int> B(m);
+                for (int i = 0; i < n; i++)
+                    A[i] = RandInt32::get() % MOD;
+                for (int i = 0; i < m; i++)
+                    B[i] = RandInt32::get() % MOD;
+
+                vector<int> out1 = NTT<MOD, ROOT>::multiply(A, B);
+                vector<int> out2 = MontgomeryNTT<MOD, ROOT>::multiply(A, B);
+                vector<int> out3 = NTT<MOD, ROOT>::multiply(A, B, true);
+                vector<int> out4 = MontgomeryNTT<MOD, ROOT>::multiply(A, B, true);
+                vector<int> out5 = NTT<MOD, ROOT>::square(A);
+                vector<int> out6 = MontgomeryNTT<MOD, ROOT>::square(A);
+                if (out1 != out2 || out3 != out4 || out5 != out6)
+                    cout << "Mismatched at " << __LINE__ << " : n = " << n << ", m = " << m << endl;
+                assert(out1 == out2);
+                assert(out3 == out4);
+                assert(out5 == out6);
+            }
+        }
+    }
+    {
+        for (int n = 1; n <= 50000; n = n * 3 + 1) {
+            for (int m = 1; m <= 50000; m = m * 5 + 2) {
+                vector<int> A(n);
+                vector<int> B(m);
+                for (int i = 0; i < n; i++)
+                    A[i] = RandInt32::get() % MOD;
+                for (int i = 0; i < m; i++)
+                    B[i] = RandInt32::get() % MOD;
+
+                vector<int> out1 = FastNTT<MOD, ROOT>::multiply(A, B);
+                vector<int> out2 = AVX2NTT<MOD, ROOT>::multiply(A, B);
+                vector<int> out3 = MontgomeryNTT<MOD, ROOT>::square(A);
+                vector<int> out4 = AVX2NTT<MOD, ROOT>::square(A);
+
+                // FastNTT removes leading zeros
+                FastNTT<MOD, ROOT>::normalize(out2);
+                if (out1 != out2 || out3 != out4)
+                    cout << "Mismatched at " << __LINE__ << " : n = " << n << ", m = " << m << endl;
+                assert(out1 == out2);
+                assert(out3 == out4);
+            }
+        }
+    }
+    {
+        static const int M = MOD;
+        static const int R = ROOT;
+
+        cout << "*** Speed test : NTT vs FastNTT vs MontgomeryNTT vs AVX2NTT ***" << endl;
+        cout << "  AVX2 : " << (CpuFeature::hasAVX2() ? "enabled" : "disabled") << endl;
+        for (int n = (1 << 15); n <= (1 << 19); n <<= 1) {
+            vector<int> in1(n);
+            vector<int> in2(n);
+            for (int i = 0; i < n; i++) {
+                in1[i] = RandInt32::get() % M;
+                in2[i] = RandInt32::get() % M;
+            }
+
+            vector<int> out1, out2, out3, out4;
+
+            cout << "N = " << n << endl;
+
+            cout << "  NTT::multiply() : ";
+            PROFILE_START(0);
+            for (int i = 0; i < 10; i++)
+                out1 = NTT<M, R>::multiply(in1, in2);
+            PROFILE_STOP(0);
+
+            cout << "  FastNTT::multiply() : ";
+            PROFILE_START(1);
+            for (int i = 0; i < 10; i++)
+                out2 = FastNTT<M, R>::multiply(in1, in2);
+            PROFILE_STOP(1);
+
+            cout << "  MontgomeryNTT::multiply() : ";
+            PROFILE_START(2);
+            for (int i = 0; i < 10; i++)
+                out3 = MontgomeryNTT<M, R>::multiply(in1, in2);
+            PROFILE_STOP(2);
+
+            cout << "  AVX2NTT::multiply() : ";
+            PROFILE_START(3);
+            for (int i = 0; i < 10; i++)
+                out4 = AVX2NTT<M, R>::multiply(in1, in2);
+            PROFILE_STOP(3);
+
+            // FastNTT removes leading zeros
+            FastNTT<M, R>::normalize(out1);
+            FastNTT<M, R>::normalize(out3);
+            FastNTT<M, R>::normalize(out4);
+            if (out1 != out2 || out1 != out3 || out1 != out4)
+                cout << "ERROR at " << __LINE__ << endl;
+            assert(out1 == out2 && out1 == out3 && out1 == out4);
+        }
+    }
+    {
+        static const int M = 1000000007;
+        static const int R = 5;
+
+        for (int n = 100; n <= 100000; n *= 10) {
+            vector<int> A(n);
+            vector<int> B(n + 17);
+            for (int i = 0; i < int(A.size()); i++)
+                A[i] = RandInt32::get() % M;
+            for (int i = 0; i < int(B.size()); i++)
+                B[i] = RandInt32::get() % M;
+
+            vector<int> out1 = PolyNTT<M, R>::multiplyFast(A, B);
+            vector<int> out2 = PolyNTT<M, R>::multiplyFast(A, A);
+            for (int threadN = 1; threadN <= 8; threadN++) {
+                vector<int> out3 = ParallelPolyNTT<M>::multiply(A, B, threadN);
+                vector<int> out4 = ParallelPolyNTT<M>::square(A, threadN);
+                if (out1 != out3 || out2 != out4)
+                    cout << "Mismatched at " << __LINE__ << " : n = " << n << ", threads = " << threadN << endl;
+                assert(out1 == out3);
+                assert(out2 == out4);
+            }
+        }
+    }
+    {
+        static const int M = 1000000007;
+        static const int R = 5;
+
+        cout << "*** Speed test : PolyNTT vs ParallelPolyNTT ***" << endl;
+        for (int n = (1 << 19); n <= (1 << 21); n <<= 1) {   // result size = 2n
+            vector<int> in1(n);
+            vector<int> in2(n);
+            for (int i = 0; i < n; i++) {
+                in1[i] = RandInt32::get() % M;
+                in2[i] = RandInt32::get() % M;
+            }
+
+            cout << "N = " << n << endl;
+
+            vector<int> out1, out2;
+
+            cout << "  PolyNTT::multiplyFast() : ";
+            PROFILE_HI_START(0);
+            out1 = PolyNTT<M, R>::multiplyFast(in1, in2);
+            PROFILE_HI_STOP(0);
+
+            for (int threadN = 1; threadN <= 16; threadN <<= 1) {
+                cout << "  ParallelPolyNTT::multiply(), threads = " << threadN << " : ";
+                PROFILE_HI_START(1);
+                out2 = ParallelPolyNTT<M>::multiply(in1, in2, threadN);
+                PROFILE_HI_STOP(1);
+
+                if (out1 != out2)
+                    cout << "ERROR at " << __LINE__ << endl;
+                assert(out1 == out2);
+            }
+        }
+    }
     {
         //static const int M = 1000000007;
         static const int M = MOD;
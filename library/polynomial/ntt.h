@@ -1,5 +1,7 @@
 #pragma once
 
+#include "transformPlan.h"
+
 // Number Theoretic Transforms
 // M = 998244353 (119 * 2^23 + 1), primitive root = 3
 //
@@ -93,6 +95,73 @@ struct NTT {
         return multiply(x, h, reverseH);
     }
 
+    //--- with a transform plan (no root recomputation, no scratch allocation)
+
+    // out[0..na+nb-2] = a * b, plan.size() >= na + nb - 1
+    // - out can be a or b
+    static void multiply(const int* a, int na, const int* b, int nb, int* out, NTTPlan<mod, root>& plan, bool reverseB = false) {
+        int n = na + nb - 1;
+        int size = plan.size();
+        //assert(size >= n);
+
+        int* A = plan.buffer(0);
+        int* B = plan.buffer(1);
+        copy(a, a + na, A);
+        fill(A + na, A + size, 0);
+        if (!reverseB) {
+            copy(b, b + nb, B);
+            fill(B + nb, B + size, 0);
+        } else {
+            fill(B, B + size - nb, 0);
+            reverse_copy(b, b + nb, B + size - nb);
+        }
+
+        plan.ntt(A);
+        plan.ntt(B);
+        for (int i = 0; i < size; i++)
+            A[i] = int(1ll * A[i] * B[i] % mod);
+        plan.ntt(A, true);
+
+        copy(A, A + n, out);
+    }
+
+    static vector<int> multiply(const vector<int>& a, const vector<int>& b, NTTPlan<mod, root>& plan, bool reverseB = false) {
+        int n = int(a.size()) + int(b.size()) - 1;
+        if (n <= 128)
+            return multiplySlow(a, b);
+
+        vector<int> res(n);
+        multiply(a.data(), int(a.size()), b.data(), int(b.size()), res.data(), plan, reverseB);
+        return res;
+    }
+
+    // out[0..2*na-2] = a * a, plan.size() >= 2 * na - 1
+    static void square(const int* a, int na, int* out, NTTPlan<mod, root>& plan) {
+        int n = na * 2 - 1;
+        int size = plan.size();
+
+        int* A = plan.buffer(0);
+        copy(a, a + na, A);
+        fill(A + na, A + size, 0);
+
+        plan.ntt(A);
+        for (int i = 0; i < size; i++)
+            A[i] = int(1ll * A[i] * A[i] % mod);
+        plan.ntt(A, true);
+
+        copy(A, A + n, out);
+    }
+
+    static vector<int> square(const vector<int>& a, NTTPlan<mod, root>& plan) {
+        int n = int(a.size()) * 2 - 1;
+        if (n < 128)
+            return multiplySlow(a, a);
+
+        vector<int> res(n);
+        square(a.data(), int(a.size()), res.data(), plan);
+        return res;
+    }
+
     //--- extended operations
 
     static vector<int> square(const vector<int>& a) {
@@ -0,0 +1,341 @@
+#pragma once
+
+#include "../common/cpuFeature.h"
+#include "ntt_montgomery.h"
+
+// Number Theoretic Transforms with AVX2 Montgomery butterflies
+// M = 998244353 (119 * 2^23 + 1), primitive root = 3
+//
+// - 8 Montgomery multiplications per instruction
+// - the AVX2 path is selected at runtime (CPUID), MontgomeryNTT is used as the scalar fallback
+// - twiddle tables and the transform order are shared with MontgomeryNTT,
+//   so the results are exactly the same as MontgomeryNTT, NTT and FastNTT
+// - the last 3 levels (blocks of 8 elements) are transformed inside one register
+//
+// [CAUTION]
+// - mod < 2^30
+// - It's not working for below 'M's. Use PolyNTT for these
+//    - 10^9 + 7
+//    - 10^9 + 9
+// - threads : the scratch buffers of multiply() and square() are thread_local, the twiddle tables are
+//             MontgomeryNTT's. Call Base::prepare(maxSize) before calling it from several threads at once.
+template <int mod, int root>
+struct AVX2NTT {
+    typedef MontgomeryNTT<mod, root> Base;
+
+    static const int MIN_AVX2_SIZE = 64;
+
+    //--- 8-lane Montgomery arithmetic (every lane is in [0, 2 * mod))
+
+    TARGET_AVX2
+    static __m256i mul(__m256i a, __m256i b) {
+        const __m256i modV = _mm256_set1_epi32(mod);
+        const __m256i negInvV = _mm256_set1_epi32(int(Base::NEG_INV));
+
+        __m256i prodEven = _mm256_mul_epu32(a, b);
+        __m256i prodOdd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+        __m256i mEven = _mm256_mul_epu32(prodEven, negInvV);
+        __m256i mOdd = _mm256_mul_epu32(prodOdd, negInvV);
+
+        __m256i tEven = _mm256_add_epi64(prodEven, _mm256_mul_epu32(mEven, modV));
+        __m256i tOdd = _mm256_add_epi64(prodOdd, _mm256_mul_epu32(mOdd, modV));
+
+        return _mm256_blend_epi32(_mm256_srli_epi64(tEven, 32), tOdd, 0xAA);
+    }
+
+    TARGET_AVX2
+    static __m256i add(__m256i a, __m256i b) {
+        __m256i r = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(r, _mm256_sub_epi32(r, _mm256_set1_epi32(int(Base::MOD2))));
+    }
+
+    TARGET_AVX2
+    static __m256i sub(__m256i a, __m256i b) {
+        __m256i r = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(r, _mm256_add_epi32(r, _mm256_set1_epi32(int(Base::MOD2))));
+    }
+
+    TARGET_AVX2
+    static __m256i load(const unsigned* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    TARGET_AVX2
+    static void store(unsigned* p, __m256i x) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+    }
+
+    //--- in-place transforms (same input/output order as MontgomeryNTT)
+
+    // natural order -> bit-reversed order, a[i] in [0, 2 * mod) -> [0, 2 * mod)
+    static void ntt(unsigned* a, int n) {
+        if (n < MIN_AVX2_SIZE || !CpuFeature::hasAVX2())
+            Base::ntt(a, n);
+        else
+            nttAVX2(a, n);
+    }
+
+    // bit-reversed order -> natural order, a[i] in [0, 2 * mod) -> [0, 2 * mod)
+    // The result is NOT divided by n.
+    static void nttInv(unsigned* a, int n) {
+        if (n < MIN_AVX2_SIZE || !CpuFeature::hasAVX2())
+            Base::nttInv(a, n);
+        else
+            nttInvAVX2(a, n);
+    }
+
+    // c[i] = a[i] * b[i] / size, for the result of ntt() (normal form)
+    // - size : transform size (n if 0), for processing a part of the transform
+    static void multiplyPointwise(const unsigned* a, const unsigned* b, unsigned* c, int n, int size = 0) {
+        if (n < 8 || !CpuFeature::hasAVX2())
+            Base::multiplyPointwise(a, b, c, n, size);
+        else
+            multiplyPointwiseAVX2(a, b, c, n, size);
+    }
+
+    //--- polynomial operations
+
+    static vector<int> multiplySlow(const vector<int>& left, const vector<int>& right) {
+        return Base::multiplySlow(left, right);
+    }
+
+    static vector<int> multiply(const vector<int>& a, const vector<int>& b, bool reverseB = false) {
+        int n = int(a.size()) + int(b.size()) - 1;
+        if (n <= 128)
+            return multiplySlow(a, b);
+
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        static thread_local vector<unsigned> A, B;
+        if (int(A.size()) < size) {
+            A.resize(size);
+            B.resize(size);
+        }
+
+        copy(a.begin(), a.end(), A.begin());
+        fill(A.begin() + a.size(), A.begin() + size, 0u);
+        if (!reverseB) {
+            copy(b.begin(), b.end(), B.begin());
+            fill(B.begin() + b.size(), B.begin() + size, 0u);
+        } else {
+            // same layout as NTT::multiply()
+            fill(B.begin(), B.begin() + size - b.size(), 0u);
+            copy(b.rbegin(), b.rend(), B.begin() + size - b.size());
+        }
+
+        ntt(A.data(), size);
+        ntt(B.data(), size);
+        multiplyPointwise(A.data(), B.data(), A.data(), size);
+        nttInv(A.data(), size);
+
+        vector<int> res(n);
+        for (int i = 0; i < n; i++)
+            res[i] = int(Base::normalize(A[i]));
+
+        return res;
+    }
+
+    static vector<int> convolute(const vector<int>& x, const vector<int>& h, bool reverseH = true) {
+        return multiply(x, h, reverseH);
+    }
+
+    static vector<int> square(const vector<int>& a) {
+        int n = int(a.size()) * 2 - 1;
+        if (n < 128)
+            return multiplySlow(a, a);
+
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        static thread_local vector<unsigned> A;
+        if (int(A.size()) < size)
+            A.resize(size);
+
+        copy(a.begin(), a.end(), A.begin());
+        fill(A.begin() + a.size(), A.begin() + size, 0u);
+
+        ntt(A.data(), size);
+        multiplyPointwise(A.data(), A.data(), A.data(), size);
+        nttInv(A.data(), size);
+
+        vector<int> res(n);
+        for (int i = 0; i < n; i++)
+            res[i] = int(Base::normalize(A[i]));
+
+        return res;
+    }
+
+private:
+    // n >= 64
+    TARGET_AVX2
+    static void nttAVX2(unsigned* a, int n) {
+        Base::prepare(n);
+
+        int h = 0;
+        while ((1 << h) < n)
+            h++;
+
+        const __m256i imag = _mm256_set1_epi32(int(Base::imag));
+
+        // levels 0 ~ h-4 (p >= 8)
+        int len = 0;
+        while (len < h - 3) {
+            if (h - 3 - len == 1) {
+                int p = 1 << (h - len - 1);
+                for (int s = 0; s < (1 << len); s++) {
+                    __m256i rot = _mm256_set1_epi32(int(Base::tw[s]));
+                    unsigned* x = a + (s << (h - len));
+                    for (int i = 0; i < p; i += 8) {
+                        __m256i l = load(x + i);
+                        __m256i r = mul(load(x + i + p), rot);
+                        store(x + i, add(l, r));
+                        store(x + i + p, sub(l, r));
+                    }
+                }
+                len++;
+            } else {
+                int p = 1 << (h - len - 2);
+                for (int s = 0; s < (1 << len); s++) {
+                    __m256i rot1 = _mm256_set1_epi32(int(Base::rt4[3 * s]));
+                    __m256i rot2 = _mm256_set1_epi32(int(Base::rt4[3 * s + 1]));
+                    __m256i rot3 = _mm256_set1_epi32(int(Base::rt4[3 * s + 2]));
+                    unsigned* x = a + (s << (h - len));
+                    for (int i = 0; i < p; i += 8) {
+                        __m256i a0 = load(x + i);
+                        __m256i a1 = mul(load(x + i + p), rot1);
+                        __m256i a2 = mul(load(x + i + 2 * p), rot2);
+                        __m256i a3 = mul(load(x + i + 3 * p), rot3);
+
+                        __m256i s02 = add(a0, a2), d02 = sub(a0, a2);
+                        __m256i s13 = add(a1, a3), d13 = mul(sub(a1, a3), imag);
+
+                        store(x + i, add(s02, s13));
+                        store(x + i + p, sub(s02, s13));
+                        store(x + i + 2 * p, add(d02, d13));
+                        store(x + i + 3 * p, sub(d02, d13));
+                    }
+                }
+                len += 2;
+            }
+        }
+
+        // levels h-3 ~ h-1, inside one register
+        const __m256i dup2 = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        const __m256i dup4 = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const unsigned* tw = Base::tw.data();
+        for (int c = 0; c < (n >> 3); c++) {
+            __m256i x = load(a + 8 * c);
+            __m256i w, l, r;
+
+            w = _mm256_set1_epi32(int(tw[c]));
+            l = _mm256_permute2x128_si256(x, x, 0x00);
+            r = mul(_mm256_permute2x128_si256(x, x, 0x11), w);
+            x = _mm256_blend_epi32(add(l, r), sub(l, r), 0xF0);
+
+            w = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(tw + 2 * c))), dup2);
+            l = _mm256_shuffle_epi32(x, 0x44);      // (1, 0, 1, 0)
+            r = mul(_mm256_shuffle_epi32(x, 0xEE), w);  // (3, 2, 3, 2)
+            x = _mm256_blend_epi32(add(l, r), sub(l, r), 0xCC);
+
+            w = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tw + 4 * c))), dup4);
+            l = _mm256_shuffle_epi32(x, 0xA0);      // (2, 2, 0, 0)
+            r = mul(_mm256_shuffle_epi32(x, 0xF5), w);  // (3, 3, 1, 1)
+            x = _mm256_blend_epi32(add(l, r), sub(l, r), 0xAA);
+
+            store(a + 8 * c, x);
+        }
+    }
+
+    // n >= 64
+    TARGET_AVX2
+    static void nttInvAVX2(unsigned* a, int n) {
+        Base::prepare(n);
+
+        int h = 0;
+        while ((1 << h) < n)
+            h++;
+
+        // levels h-1 ~ h-3, inside one register
+        const __m256i dup2 = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        const __m256i dup4 = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const unsigned* itw = Base::itw.data();
+        for (int c = 0; c < (n >> 3); c++) {
+            __m256i x = load(a + 8 * c);
+            __m256i w, l, r;
+
+            w = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(itw + 4 * c))), dup4);
+            l = _mm256_shuffle_epi32(x, 0xA0);
+            r = _mm256_shuffle_epi32(x, 0xF5);
+            x = _mm256_blend_epi32(add(l, r), mul(sub(l, r), w), 0xAA);
+
+            w = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(itw + 2 * c))), dup2);
+            l = _mm256_shuffle_epi32(x, 0x44);
+            r = _mm256_shuffle_epi32(x, 0xEE);
+            x = _mm256_blend_epi32(add(l, r), mul(sub(l, r), w), 0xCC);
+
+            w = _mm256_set1_epi32(int(itw[c]));
+            l = _mm256_permute2x128_si256(x, x, 0x00);
+            r = _mm256_permute2x128_si256(x, x, 0x11);
+            x = _mm256_blend_epi32(add(l, r), mul(sub(l, r), w), 0xF0);
+
+            store(a + 8 * c, x);
+        }
+
+        const __m256i iimag = _mm256_set1_epi32(int(Base::iimag));
+
+        // levels h-4 ~ 0 (p >= 8)
+        int len = h - 3;
+        while (len > 0) {
+            if (len == 1) {
+                int p = 1 << (h - len);
+                __m256i irot = _mm256_set1_epi32(int(Base::itw[0]));
+                for (int i = 0; i < p; i += 8) {
+                    __m256i l = load(a + i);
+                    __m256i r = load(a + i + p);
+                    store(a + i, add(l, r));
+                    store(a + i + p, mul(sub(l, r), irot));
+                }
+                len--;
+            } else {
+                int p = 1 << (h - len);
+                for (int s = 0; s < (1 << (len - 2)); s++) {
+                    __m256i irot1 = _mm256_set1_epi32(int(Base::irt4[3 * s]));
+                    __m256i irot2 = _mm256_set1_epi32(int(Base::irt4[3 * s + 1]));
+                    __m256i irot3 = _mm256_set1_epi32(int(Base::irt4[3 * s + 2]));
+                    unsigned* x = a + (s << (h - len + 2));
+                    for (int i = 0; i < p; i += 8) {
+                        __m256i a0 = load(x + i);
+                        __m256i a1 = load(x + i + p);
+                        __m256i a2 = load(x + i + 2 * p);
+                        __m256i a3 = load(x + i + 3 * p);
+
+                        __m256i s01 = add(a0, a1), d01 = sub(a0, a1);
+                        __m256i s23 = add(a2, a3), d23 = mul(sub(a2, a3), iimag);
+
+                        store(x + i, add(s01, s23));
+                        store(x + i + p, mul(add(d01, d23), irot1));
+                        store(x + i + 2 * p, mul(sub(s01, s23), irot2));
+                        store(x + i + 3 * p, mul(sub(d01, d23), irot3));
+                    }
+                }
+                len -= 2;
+            }
+        }
+    }
+
+    TARGET_AVX2
+    static void multiplyPointwiseAVX2(const unsigned* a, const unsigned* b, unsigned* c, int n, int size) {
+        unsigned scale = Base::toMontgomery(Base::toMontgomery(Base::modInv(size ? size : n)));
+        __m256i scaleV = _mm256_set1_epi32(int(scale));
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            store(c + i, mul(mul(load(a + i), load(b + i)), scaleV));
+        for (; i < n; i++)
+            c[i] = Base::mul(Base::mul(a[i], b[i]), scale);
+    }
+};
@@ -31,6 +31,8 @@
 
       3) calculate Y
          auto Y = evalTree.evaluate(F.tree[1], X);
+
+      For large inputs, SubproductTree in subproductTree.h is faster (one arena, no polynomial division, multithreaded).
 */
 
 template <int mod, int root, int MaxBitSize = 20>
@@ -0,0 +1,372 @@
+#pragma once
+
+// Number Theoretic Transforms with Montgomery multiplication
+// M = 998244353 (119 * 2^23 + 1), primitive root = 3
+//
+// - Montgomery butterflies with lazy reduction (values are kept in [0, 2 * mod))
+// - twiddle tables are built once and grown on demand (tw[s] doesn't depend on the transform size)
+// - radix-4 passes
+// - no bit-reversal permutation
+//     forward : natural order -> bit-reversed order (DIF)
+//     inverse : bit-reversed order -> natural order (DIT)
+//   The pointwise product doesn't care about the order, so multiply() never reorders anything.
+//
+// [CAUTION]
+// - mod < 2^30
+// - It's not working for below 'M's. Use PolyNTT for these
+//    - 10^9 + 7
+//    - 10^9 + 9
+// - threads : the scratch buffers of multiply() and square() are thread_local, but the twiddle tables are shared
+//             and grown by prepare(). Call prepare(maxSize) before calling it from several threads at once
+//             (after that the tables are only read).
+template <int mod, int root>
+struct MontgomeryNTT {
+    static_assert(mod % 2 == 1 && mod < (1 << 30), "mod must be an odd number less than 2^30");
+
+    static const unsigned MOD = unsigned(mod);
+    static const unsigned MOD2 = unsigned(mod) * 2;
+
+    //--- Montgomery arithmetic (R = 2^32)
+
+    // -mod^-1 (mod 2^32)
+    static constexpr unsigned calcNegInv() {
+        unsigned inv = MOD;             // correct to 3 bits
+        for (int i = 0; i < 4; i++)
+            inv *= 2u - MOD * inv;      // Newton's method
+        return 0u - inv;
+    }
+
+    // R^2 (mod mod)
+    static constexpr unsigned calcR2() {
+        return unsigned((0ull - (unsigned long long)MOD) % MOD);    // 2^64 mod mod
+    }
+
+    static const unsigned NEG_INV = calcNegInv();
+    static const unsigned R2 = calcR2();
+
+    // x < mod * 2^32  ->  x * R^-1 (mod mod) in [0, 2 * mod)
+    static unsigned reduce(unsigned long long x) {
+        return unsigned((x + (unsigned long long)(unsigned(x) * NEG_INV) * MOD) >> 32);
+    }
+
+    // a * b * R^-1, a < 2 * mod, b < 2 * mod  ->  [0, 2 * mod)
+    static unsigned mul(unsigned a, unsigned b) {
+        return reduce((unsigned long long)a * b);
+    }
+
+    // [0, 2 * mod) + [0, 2 * mod) -> [0, 2 * mod)
+    static unsigned add(unsigned a, unsigned b) {
+        unsigned r = a + b;
+        return (r >= MOD2) ? r - MOD2 : r;
+    }
+
+    // [0, 2 * mod) - [0, 2 * mod) -> [0, 2 * mod)
+    static unsigned sub(unsigned a, unsigned b) {
+        unsigned r = a - b;
+        return (int(r) < 0) ? r + MOD2 : r;
+    }
+
+    static unsigned toMontgomery(unsigned x) {
+        return mul(x, R2);
+    }
+
+    // [0, 2 * mod) Montgomery form -> [0, mod) normal form
+    static unsigned fromMontgomery(unsigned x) {
+        unsigned r = reduce(x);
+        return (r >= MOD) ? r - MOD : r;
+    }
+
+    // [0, 2 * mod) -> [0, mod)
+    static unsigned normalize(unsigned x) {
+        return (x >= MOD) ? x - MOD : x;
+    }
+
+    //--- twiddle tables
+
+    // tw[s] = w_(2^K) ^ bitrev_(K-1)(s), itw[s] = tw[s]^-1  (Montgomery form, independent of K)
+    // rt4[3*s..3*s+2] = { q, q^2, q^3 } where q = tw[2*s], irt4 = inverse of rt4
+    static vector<unsigned> tw, itw;
+    static vector<unsigned> rt4, irt4;
+    static unsigned imag, iimag;    // w_4, w_4^-1
+
+    static int maxBitSize() {
+        int res = 0;
+        while (((mod - 1) >> res & 1) == 0)
+            res++;
+        return res;
+    }
+
+    // prepares twiddle tables for transforms of size n (power of 2), not thread-safe when the tables grow
+    static void prepare(int n) {
+        //assert(n <= (1 << maxBitSize()));
+        int half = max(1, n >> 1);
+        if (int(tw.size()) >= half)
+            return;
+
+        if (tw.empty()) {
+            tw.push_back(toMontgomery(1));
+            itw.push_back(toMontgomery(1));
+            imag = toMontgomery(modPow(root, (mod - 1) / 4));
+            iimag = toMontgomery(modInv(modPow(root, (mod - 1) / 4)));
+        }
+
+        int oldSize = int(tw.size());
+        tw.resize(half);
+        itw.resize(half);
+        for (int j = oldSize; j < half; j <<= 1) {
+            // tw[j + t] = tw[t] * w_(4j)
+            int w = modPow(root, (mod - 1) / (4 * j));
+            unsigned wm = toMontgomery(w);
+            unsigned iwm = toMontgomery(modInv(w));
+            for (int t = 0; t < j; t++) {
+                tw[j + t] = normalize(mul(tw[t], wm));
+                itw[j + t] = normalize(mul(itw[t], iwm));
+            }
+        }
+
+        int quarter = half >> 1;
+        int oldQuarter = int(rt4.size()) / 3;
+        rt4.resize(3 * quarter);
+        irt4.resize(3 * quarter);
+        for (int s = oldQuarter; s < quarter; s++) {
+            unsigned q = tw[2 * s], iq = itw[2 * s];
+            unsigned q2 = normalize(mul(q, q)), iq2 = normalize(mul(iq, iq));
+            rt4[3 * s] = q;
+            rt4[3 * s + 1] = q2;
+            rt4[3 * s + 2] = normalize(mul(q2, q));
+            irt4[3 * s] = iq;
+            irt4[3 * s + 1] = iq2;
+            irt4[3 * s + 2] = normalize(mul(iq2, iq));
+        }
+    }
+
+    //--- in-place transforms
+
+    // natural order -> bit-reversed order, a[i] in [0, 2 * mod) -> [0, 2 * mod)
+    // It doesn't multiply R, so a normal-form input gives a normal-form output.
+    static void ntt(unsigned* a, int n) {
+        prepare(n);
+
+        int h = 0;
+        while ((1 << h) < n)
+            h++;
+
+        int len = 0;
+        while (len < h) {
+            if (h - len == 1) {
+                int p = 1 << (h - len - 1);
+                for (int s = 0; s < (1 << len); s++) {
+                    unsigned rot = tw[s];
+                    unsigned* x = a + (s << (h - len));
+                    for (int i = 0; i < p; i++) {
+                        unsigned l = x[i];
+                        unsigned r = mul(x[i + p], rot);
+                        x[i] = add(l, r);
+                        x[i + p] = sub(l, r);
+                    }
+                }
+                len++;
+            } else {
+                int p = 1 << (h - len - 2);
+                for (int s = 0; s < (1 << len); s++) {
+                    unsigned rot1 = rt4[3 * s], rot2 = rt4[3 * s + 1], rot3 = rt4[3 * s + 2];
+                    unsigned* x = a + (s << (h - len));
+                    for (int i = 0; i < p; i++) {
+                        unsigned a0 = x[i];
+                        unsigned a1 = mul(x[i + p], rot1);
+                        unsigned a2 = mul(x[i + 2 * p], rot2);
+                        unsigned a3 = mul(x[i + 3 * p], rot3);
+
+                        unsigned s02 = add(a0, a2), d02 = sub(a0, a2);
+                        unsigned s13 = add(a1, a3), d13 = mul(sub(a1, a3), imag);
+
+                        x[i] = add(s02, s13);
+                        x[i + p] = sub(s02, s13);
+                        x[i + 2 * p] = add(d02, d13);
+                        x[i + 3 * p] = sub(d02, d13);
+                    }
+                }
+                len += 2;
+            }
+        }
+    }
+
+    // bit-reversed order -> natural order, a[i] in [0, 2 * mod) -> [0, 2 * mod)
+    // The result is NOT divided by n.
+    static void nttInv(unsigned* a, int n) {
+        prepare(n);
+
+        int h = 0;
+        while ((1 << h) < n)
+            h++;
+
+        int len = h;
+        while (len > 0) {
+            if (len == 1) {
+                int p = 1 << (h - len);
+                for (int s = 0; s < (1 << (len - 1)); s++) {
+                    unsigned irot = itw[s];
+                    unsigned* x = a + (s << (h - len + 1));
+                    for (int i = 0; i < p; i++) {
+                        unsigned l = x[i];
+                        unsigned r = x[i + p];
+                        x[i] = add(l, r);
+                        x[i + p] = mul(sub(l, r), irot);
+                    }
+                }
+                len--;
+            } else {
+                int p = 1 << (h - len);
+                for (int s = 0; s < (1 << (len - 2)); s++) {
+                    unsigned irot1 = irt4[3 * s], irot2 = irt4[3 * s + 1], irot3 = irt4[3 * s + 2];
+                    unsigned* x = a + (s << (h - len + 2));
+                    for (int i = 0; i < p; i++) {
+                        unsigned a0 = x[i];
+                        unsigned a1 = x[i + p];
+                        unsigned a2 = x[i + 2 * p];
+                        unsigned a3 = x[i + 3 * p];
+
+                        unsigned s01 = add(a0, a1), d01 = sub(a0, a1);
+                        unsigned s23 = add(a2, a3), d23 = mul(sub(a2, a3), iimag);
+
+                        x[i] = add(s01, s23);
+                        x[i + p] = mul(add(d01, d23), irot1);
+                        x[i + 2 * p] = mul(sub(s01, s23), irot2);
+                        x[i + 3 * p] = mul(sub(d01, d23), irot3);
+                    }
+                }
+                len -= 2;
+            }
+        }
+    }
+
+    // c[i] = a[i] * b[i] / size, for the result of ntt() (normal form)
+    // - size : transform size (n if 0), for processing a part of the transform
+    static void multiplyPointwise(const unsigned* a, const unsigned* b, unsigned* c, int n, int size = 0) {
+        // (a * b * R^-1) * (size^-1 * R^2) * R^-1 = a * b * size^-1
+        unsigned scale = toMontgomery(toMontgomery(modInv(size ? size : n)));
+        for (int i = 0; i < n; i++)
+            c[i] = mul(mul(a[i], b[i]), scale);
+    }
+
+    //--- polynomial operations
+
+    static vector<int> multiplySlow(const vector<int>& left, const vector<int>& right) {
+        vector<int> res(left.size() + right.size() - 1);
+
+        for (int i = 0; i < int(right.size()); i++) {
+            for (int j = 0; j < int(left.size()); j++) {
+                res[i + j] = int((res[i + j] + 1ll * left[j] * right[i]) % mod);
+            }
+        }
+
+        return res;
+    }
+
+    static vector<int> multiply(const vector<int>& a, const vector<int>& b, bool reverseB = false) {
+        int n = int(a.size()) + int(b.size()) - 1;
+        if (n <= 128)
+            return multiplySlow(a, b);
+
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        static thread_local vector<unsigned> A, B;
+        if (int(A.size()) < size) {
+            A.resize(size);
+            B.resize(size);
+        }
+
+        copy(a.begin(), a.end(), A.begin());
+        fill(A.begin() + a.size(), A.begin() + size, 0u);
+        if (!reverseB) {
+            copy(b.begin(), b.end(), B.begin());
+            fill(B.begin() + b.size(), B.begin() + size, 0u);
+        } else {
+            // same layout as NTT::multiply()
+            fill(B.begin(), B.begin() + size - b.size(), 0u);
+            copy(b.rbegin(), b.rend(), B.begin() + size - b.size());
+        }
+
+        ntt(A.data(), size);
+        ntt(B.data(), size);
+        multiplyPointwise(A.data(), B.data(), A.data(), size);
+        nttInv(A.data(), size);
+
+        vector<int> res(n);
+        for (int i = 0; i < n; i++)
+            res[i] = int(normalize(A[i]));
+
+        return res;
+    }
+
+    static vector<int> convolute(const vector<int>& x, const vector<int>& h, bool reverseH = true) {
+        return multiply(x, h, reverseH);
+    }
+
+    static vector<int> square(const vector<int>& a) {
+        int n = int(a.size()) * 2 - 1;
+        if (n < 128)
+            return multiplySlow(a, a);
+
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        static thread_local vector<unsigned> A;
+        if (int(A.size()) < size)
+            A.resize(size);
+
+        copy(a.begin(), a.end(), A.begin());
+        fill(A.begin() + a.size(), A.begin() + size, 0u);
+
+        ntt(A.data(), size);
+        multiplyPointwise(A.data(), A.data(), A.data(), size);
+        nttInv(A.data(), size);
+
+        vector<int> res(n);
+        for (int i = 0; i < n; i++)
+            res[i] = int(normalize(A[i]));
+
+        return res;
+    }
+
+//private:
+    template <typename T>
+    static int modPow(T x, int n) {
+        if (n == 0)
+            return 1;
+
+        long long t = x % mod;
+        long long res = 1;
+        for (; n > 0; n >>= 1) {
+            if (n & 1)
+                res = res * t % mod;
+            t = t * t % mod;
+        }
+        return int(res);
+    }
+
+    static int modInv(int a) {
+        return modPow(a, mod - 2);
+    }
+};
+
+template <int mod, int root>
+vector<unsigned> MontgomeryNTT<mod, root>::tw;
+
+template <int mod, int root>
+vector<unsigned> MontgomeryNTT<mod, root>::itw;
+
+template <int mod, int root>
+vector<unsigned> MontgomeryNTT<mod, root>::rt4;
+
+template <int mod, int root>
+vector<unsigned> MontgomeryNTT<mod, root>::irt4;
+
+template <int mod, int root>
+unsigned MontgomeryNTT<mod, root>::imag;
+
+template <int mod, int root>
+unsigned MontgomeryNTT<mod, root>::iimag;
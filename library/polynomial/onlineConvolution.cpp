@@ -0,0 +1,217 @@
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#include "onlineConvolution.h"
+#include "polyFFTMod.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+template <int mod>
+static vector<int> convoluteNaive(const vector<int>& f, const vector<int>& g, int n) {
+    vector<int> res(n);
+    for (int i = 0; i < n; i++) {
+        long long sum = 0;
+        for (int j = 0; j <= i; j++) {
+            if (j < int(f.size()) && i - j < int(g.size()))
+                sum = (sum + 1ll * f[j] * g[i - j]) % mod;
+        }
+        res[i] = int(sum);
+    }
+    return res;
+}
+
+template <int mod, typename OnlineConvT>
+static void testOnline(int n, int gN) {
+    vector<int> f(n), g(gN);
+    for (int i = 0; i < n; i++)
+        f[i] = RandInt32::get() % mod;
+    for (int i = 0; i < gN; i++)
+        g[i] = RandInt32::get() % mod;
+
+    auto gt = convoluteNaive<mod>(f, g, n);
+
+    OnlineConvT conv(g);
+    vector<int> out(n);
+    for (int i = 0; i < n; i++)
+        out[i] = conv.push(f[i]);
+
+    if (out != gt)
+        cout << "Mismatched : n = " << n << ", gN = " << gN << endl;
+    assert(out == gt);
+}
+
+template <int mod, typename RelaxedConvT>
+static void testRelaxed(int n) {
+    vector<int> f(n), g(n);
+    for (int i = 0; i < n; i++) {
+        f[i] = RandInt32::get() % mod;
+        g[i] = RandInt32::get() % mod;
+    }
+
+    auto gt = convoluteNaive<mod>(f, g, n);
+
+    RelaxedConvT conv;
+    vector<int> out(n);
+    for (int i = 0; i < n; i++)
+        out[i] = conv.push(f[i], g[i]);
+
+    if (out != gt)
+        cout << "Mismatched : n = " << n << endl;
+    assert(out == gt);
+}
+
+void testOnlineConvolution() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Online Convolution ------------------------" << endl;
+    {
+        const int MOD1 = 998244353;
+        const int MOD2 = 1000000007;
+
+        for (int n : { 1, 2, 3, 7, 8, 100, 1000, 3000 }) {
+            for (int gN : { 1, 2, n / 3 + 1, n, n + 5 }) {
+                testOnline<MOD1, OnlineConvolution<MOD1>>(n, gN);
+                testOnline<MOD1, OnlineConvolution<MOD1, NTT<MOD1, 3>, 4>>(n, gN);
+                testOnline<MOD2, OnlineConvolution<MOD2, PolyFFTMod<MOD2>, 8>>(n, gN);
+            }
+            testRelaxed<MOD1, RelaxedConvolution<MOD1>>(n);
+            testRelaxed<MOD1, RelaxedConvolution<MOD1, NTT<MOD1, 3>, 4>>(n);
+            testRelaxed<MOD2, RelaxedConvolution<MOD2, PolyFFTMod<MOD2>, 8>>(n);
+        }
+
+        // Catalan numbers, C[0] = 1, C[n + 1] = SUM_{i=0..n} C[i] * C[n - i]
+        {
+            int N = 2000;
+            vector<int> C(N);
+            C[0] = 1;
+            RelaxedConvolution<MOD1> conv;
+            for (int i = 0; i + 1 < N; i++)
+                C[i + 1] = conv.push(C[i], C[i]);
+
+            vector<int> gt(N);
+            gt[0] = 1;
+            for (int i = 0; i + 1 < N; i++) {
+                long long sum = 0;
+                for (int j = 0; j <= i; j++)
+                    sum = (sum + 1ll * gt[j] * gt[i - j]) % MOD1;
+                gt[i + 1] = int(sum);
+            }
+            assert(C == gt);
+        }
+
+        // f[0] = 1, f[n] = SUM_{j=0..n-1} f[j] * g[n - j]
+        {
+            int N = 2000;
+            vector<int> g(N);
+            for (int i = 0; i < N; i++)
+                g[i] = RandInt32::get() % MOD2;
+
+            vector<int> f(N);
+            f[0] = 1;
+            OnlineConvolution<MOD2, PolyFFTMod<MOD2>> conv(vector<int>(g.begin() + 1, g.end()));
+            for (int n = 1; n < N; n++)
+                f[n] = conv.push(f[n - 1]);
+
+            vector<int> gt(N);
+            gt[0] = 1;
+            for (int n = 1; n < N; n++) {
+                long long sum = 0;
+                for (int j = 0; j < n; j++)
+                    sum = (sum + 1ll * gt[j] * g[n - j]) % MOD2;
+                gt[n] = int(sum);
+            }
+            assert(f == gt);
+        }
+    }
+    cout << "OK!" << endl;
+    {
+        cout << "*** Speed test ***" << endl;
+
+        const int MOD = 998244353;
+        const int N = 1 << 17;
+
+        vector<int> f(N), g(N);
+        for (int i = 0; i < N; i++) {
+            f[i] = RandInt32::get() % MOD;
+            g[i] = RandInt32::get() % MOD;
+        }
+
+        cout << "N = " << N << endl;
+        {
+            cout << "  O(N^2)" << endl;
+            PROFILE_HI_START(0);
+            vector<unsigned long long> h(N);
+            for (int i = 0; i < N; i++) {
+                for (int j = 0; i + j < N; j++)
+                    h[i + j] = (h[i + j] + 1ull * f[i] * g[j]) % MOD;
+            }
+            PROFILE_HI_STOP(0);
+        }
+        {
+            cout << "  OnlineConvolution, naive block size = 8" << endl;
+            OnlineConvolution<MOD, NTT<MOD, 3>, 8> conv(g);
+            PROFILE_HI_START(1);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i]);
+            PROFILE_HI_STOP(1);
+        }
+        {
+            cout << "  OnlineConvolution, naive block size = 32" << endl;
+            OnlineConvolution<MOD, NTT<MOD, 3>, 32> conv(g);
+            PROFILE_HI_START(2);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i]);
+            PROFILE_HI_STOP(2);
+        }
+        {
+            cout << "  OnlineConvolution, naive block size = 128" << endl;
+            OnlineConvolution<MOD, NTT<MOD, 3>, 128> conv(g);
+            PROFILE_HI_START(3);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i]);
+            PROFILE_HI_STOP(3);
+        }
+        {
+            cout << "  OnlineConvolution with PolyFFTMod" << endl;
+            OnlineConvolution<MOD, PolyFFTMod<MOD>> conv(g);
+            PROFILE_HI_START(4);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i]);
+            PROFILE_HI_STOP(4);
+        }
+        {
+            cout << "  RelaxedConvolution, naive block size = 8" << endl;
+            RelaxedConvolution<MOD, NTT<MOD, 3>, 8> conv;
+            PROFILE_HI_START(5);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i], g[i]);
+            PROFILE_HI_STOP(5);
+        }
+        {
+            cout << "  RelaxedConvolution, naive block size = 32" << endl;
+            RelaxedConvolution<MOD, NTT<MOD, 3>, 32> conv;
+            PROFILE_HI_START(6);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i], g[i]);
+            PROFILE_HI_STOP(6);
+        }
+        {
+            cout << "  RelaxedConvolution, naive block size = 128" << endl;
+            RelaxedConvolution<MOD, NTT<MOD, 3>, 128> conv;
+            PROFILE_HI_START(7);
+            for (int i = 0; i < N; i++)
+                conv.push(f[i], g[i]);
+            PROFILE_HI_STOP(7);
+        }
+    }
+}
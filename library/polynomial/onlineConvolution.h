@@ -0,0 +1,185 @@
+#pragma once
+
+#include "ntt.h"
+
+/*
+  Online (relaxed) convolution
+
+  1) OnlineConvolution : g is known in advance, f is given one term at a time
+
+      h[n] = SUM_{j=0..n} f[j] * g[n - j]
+
+     h[n] is returned as soon as f[n] is given.
+
+  2) RelaxedConvolution : both f and g are given one term at a time
+
+      h[n] = SUM_{j=0..n} f[j] * g[n - j]
+
+     h[n] is returned as soon as f[n] and g[n] are given.
+
+  - amortized O(log^2 n) for each term
+  - the products are split into blocks of 2^k x 2^k, a block is multiplied as soon as all its terms are known
+  - small blocks (<= NaiveBlockSize) are multiplied directly, bigger blocks use PolyMul::multiply()
+  - PolyMul : NTT<mod, root>, PolyFFTMod<mod>, ... (anything with static vector<int> multiply(a, b))
+
+  <How to use>
+    f[0] = 1, f[n] = SUM_{j=0..n-1} f[j] * g[n - j]
+      => OnlineConvolution<MOD> conv(g1);       // g1[i] = g[i + 1]
+         for (int n = 1; n < N; n++)
+             f[n] = conv.push(f[n - 1]);        // h[n - 1] = SUM_{j=0..n-1} f[j] * g1[n - 1 - j]
+*/
+
+template <int mod, typename PolyMul = NTT<mod, 3>, int NaiveBlockSize = 32>
+struct OnlineConvolution {
+    vector<int> f, g, h;
+
+    OnlineConvolution() {
+    }
+
+    explicit OnlineConvolution(const vector<int>& g) {
+        init(g);
+    }
+
+    void init(const vector<int>& g) {
+        this->g = g;
+        f.clear();
+        h.clear();
+    }
+
+    int size() const {
+        return int(f.size());
+    }
+
+    // f[n] = x, returns h[n]
+    int push(int x) {
+        int n = int(f.size());
+        f.push_back(x);
+        if (g.empty())
+            return 0;
+
+        if (int(h.size()) <= n)
+            h.resize(n + 1);
+        int res = int((h[n] + 1ll * x * g[0]) % mod);
+
+        // f[n + 1 - s, n + 1) x g[s, 2s) -> h[n + 1, n + 2s)
+        for (int s = 1; (n + 1) % s == 0 && s < int(g.size()); s <<= 1) {
+            int gN = min(s, int(g.size()) - s);
+            if (int(h.size()) < n + s + gN)
+                h.resize(n + s + gN);
+            if (s <= NaiveBlockSize)
+                addNaive(&f[n + 1 - s], s, &g[s], gN, &h[n + 1]);
+            else {
+                vector<int> A(f.begin() + n + 1 - s, f.begin() + n + 1);
+                vector<int> B(g.begin() + s, g.begin() + s + gN);
+                addBlock(PolyMul::multiply(A, B), &h[n + 1]);
+            }
+        }
+
+        h[n] = res;
+        return res;
+    }
+
+    int operator [](int i) const {
+        return h[i];
+    }
+
+private:
+    // out[0..aN+bN-2] += a * b
+    static void addNaive(const int* a, int aN, const int* b, int bN, int* out) {
+        for (int t = 0; t < aN + bN - 1; t++) {
+            unsigned long long sum = 0;
+            int lo = max(0, t - bN + 1), hi = min(t, aN - 1);
+            for (int i = lo, cnt = 0; i <= hi; i++) {
+                sum += 1ull * a[i] * b[t - i];
+                if (++cnt == LAZY_TERMS) {
+                    sum %= mod;
+                    cnt = 0;
+                }
+            }
+            out[t] = int((out[t] + sum) % mod);
+        }
+    }
+
+    static void addBlock(const vector<int>& c, int* out) {
+        for (int i = 0; i < int(c.size()); i++) {
+            out[i] += c[i];
+            if (out[i] >= mod)
+                out[i] -= mod;
+        }
+    }
+
+    // the number of products that can be added without overflow
+    static const int LAZY_TERMS = int(min(~0ull / (1ull * (mod - 1) * (mod - 1)) - 1, 1ull << 30));
+};
+
+template <int mod, typename PolyMul = NTT<mod, 3>, int NaiveBlockSize = 32>
+struct RelaxedConvolution {
+    vector<int> f, g, h;
+
+    RelaxedConvolution() {
+    }
+
+    void clear() {
+        f.clear();
+        g.clear();
+        h.clear();
+    }
+
+    int size() const {
+        return int(f.size());
+    }
+
+    // f[n] = x, g[n] = y, returns h[n]
+    int push(int x, int y) {
+        int n = int(f.size());
+        f.push_back(x);
+        g.push_back(y);
+        if (int(h.size()) < 2 * n + 2)
+            h.resize(2 * n + 2);
+
+        for (int s = 1; (n + 2) % s == 0 && 2 * s <= n + 2; s <<= 1) {
+            if (n + 2 == 2 * s) {
+                // f[s - 1, 2s - 1) x g[s - 1, 2s - 1) -> h[2s - 2, 4s - 3)
+                multiplyAdd(&f[s - 1], &g[s - 1], s, &h[2 * s - 2]);
+            } else {
+                // f[s - 1, 2s - 1) x g[n + 1 - s, n + 1) + g[s - 1, 2s - 1) x f[n + 1 - s, n + 1) -> h[n, n + 2s - 1)
+                multiplyAdd(&f[s - 1], &g[n + 1 - s], s, &h[n]);
+                multiplyAdd(&g[s - 1], &f[n + 1 - s], s, &h[n]);
+            }
+        }
+
+        return h[n];
+    }
+
+    int operator [](int i) const {
+        return h[i];
+    }
+
+private:
+    // out[0..2n-2] += a[0..n-1] * b[0..n-1]
+    static void multiplyAdd(const int* a, const int* b, int n, int* out) {
+        if (n <= NaiveBlockSize) {
+            for (int t = 0; t < 2 * n - 1; t++) {
+                unsigned long long sum = 0;
+                int lo = max(0, t - n + 1), hi = min(t, n - 1);
+                for (int i = lo, cnt = 0; i <= hi; i++) {
+                    sum += 1ull * a[i] * b[t - i];
+                    if (++cnt == LAZY_TERMS) {
+                        sum %= mod;
+                        cnt = 0;
+                    }
+                }
+                out[t] = int((out[t] + sum) % mod);
+            }
+        } else {
+            vector<int> c = PolyMul::multiply(vector<int>(a, a + n), vector<int>(b, b + n));
+            for (int i = 0; i < int(c.size()); i++) {
+                out[i] += c[i];
+                if (out[i] >= mod)
+                    out[i] -= mod;
+            }
+        }
+    }
+
+    static const int LAZY_TERMS = int(min(~0ull / (1ull * (mod - 1) * (mod - 1)) - 1, 1ull << 30));
+};
@@ -0,0 +1,400 @@
+#pragma once
+
+#include "../common/parallel.h"
+#include "../integer/garnerAlgorithm.h"
+#include "ntt_avx2.h"
+
+// Multithreaded polynomial multiplication for arbitrary moduli (ex: 10^9 + 7)
+//
+// - 3 NTT primes (167772161, 469762049, 754974721), so the result size must be <= 2^24
+//   (n * mod^2 < P1 * P2 * P3 when n <= 2^24 and mod <= 2^31)
+// - the 3 prime transforms run on separate threads
+// - a large transform is split into 2^k independent sub-blocks
+//     1) the top k levels are done in parallel over i (mod m), m = n / 2^k
+//     2) sub-block j is "mod (x^m - c_j)", so it's an NTT of size m after twisting by zeta_j^i (zeta_j^m = c_j)
+// - the results are recombined with chunk-parallel Garner (GarnerMod3), vectorized with AVX2
+//   when 'mod' is an odd number less than 2^30
+template <int mod>
+struct ParallelPolyNTT {
+    static const int P1 = 167772161;    // 5 * 2^25 + 1, primitive root = 3
+    static const int P2 = 469762049;    // 7 * 2^26 + 1, primitive root = 3
+    static const int P3 = 754974721;    // 45 * 2^24 + 1, primitive root = 11
+    static const int MAX_SIZE = 1 << 24;
+
+    static const int PARALLEL_MIN_SIZE = 1 << 15;
+    static const int MIN_BLOCK_SIZE = 1 << 10;
+
+    static vector<int> multiplySlow(const vector<int>& left, const vector<int>& right) {
+        vector<int> res(left.size() + right.size() - 1);
+
+        for (int i = 0; i < int(right.size()); i++) {
+            for (int j = 0; j < int(left.size()); j++) {
+                res[i + j] = int((res[i + j] + 1ll * left[j] * right[i]) % mod);
+            }
+        }
+
+        return res;
+    }
+
+    // threadN = 0 : all hardware threads
+    static vector<int> multiply(const vector<int>& a, const vector<int>& b, int threadN = 0) {
+        int n = int(a.size()) + int(b.size()) - 1;
+        if (n <= 256)
+            return multiplySlow(a, b);
+
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+        //assert(size <= MAX_SIZE);
+
+        if (size < PARALLEL_MIN_SIZE)
+            threadN = 1;
+
+        vector<int> x(size), y(size), z(size);
+        if (threadN >= 3) {
+            int t1 = threadN / 3 + (threadN % 3 > 0);
+            int t2 = threadN / 3 + (threadN % 3 > 1);
+            int t3 = threadN / 3;
+            Parallel::invoke(
+                [&]() { multiplyPrime<P1, 3>(a, b, (unsigned*)x.data(), size, t1); },
+                [&]() {
+                    Parallel::invoke(
+                        [&]() { multiplyPrime<P2, 3>(a, b, (unsigned*)y.data(), size, t2); },
+                        [&]() { multiplyPrime<P3, 11>(a, b, (unsigned*)z.data(), size, t3); });
+                });
+        } else {
+            multiplyPrime<P1, 3>(a, b, (unsigned*)x.data(), size, threadN);
+            multiplyPrime<P2, 3>(a, b, (unsigned*)y.data(), size, threadN);
+            multiplyPrime<P3, 11>(a, b, (unsigned*)z.data(), size, threadN);
+        }
+
+        vector<int> res(n);
+        Parallel::forRange(0, n, threadN, [&](int lo, int hi) {
+            garner(x.data(), y.data(), z.data(), res.data(), lo, hi);
+        }, 8);
+
+        return res;
+    }
+
+    static vector<int> square(const vector<int>& a, int threadN = 0) {
+        return multiply(a, a, threadN);
+    }
+
+    //--- parallel in-place transforms (same input/output order as MontgomeryNTT)
+
+    template <int p, int g>
+    static void nttParallel(unsigned* a, int n, int threadN) {
+        typedef AVX2NTT<p, g> NTTp;
+
+        int k = blockLevel(n, threadN);
+        if (k == 0) {
+            NTTp::ntt(a, n);
+            return;
+        }
+        NTTp::Base::prepare(n);
+
+        int m = n >> k;
+        Parallel::forRange(0, m, threadN, [=](int lo, int hi) {
+            if (CpuFeature::hasAVX2())
+                topLevelsAVX2<p, g>(a, n, k, lo, hi);
+            else
+                topLevels<p, g>(a, n, k, lo, hi);
+        }, 8);
+        Parallel::forEach(1 << k, threadN, [=](int j) {
+            twist<p, g>(a + j * m, m, zeta<p, g>(n, k, j, false));
+            NTTp::ntt(a + j * m, m);
+        });
+    }
+
+    // The result is NOT divided by n.
+    template <int p, int g>
+    static void nttInvParallel(unsigned* a, int n, int threadN) {
+        typedef AVX2NTT<p, g> NTTp;
+
+        int k = blockLevel(n, threadN);
+        if (k == 0) {
+            NTTp::nttInv(a, n);
+            return;
+        }
+        NTTp::Base::prepare(n);
+
+        int m = n >> k;
+        Parallel::forEach(1 << k, threadN, [=](int j) {
+            NTTp::nttInv(a + j * m, m);
+            twist<p, g>(a + j * m, m, zeta<p, g>(n, k, j, true));
+        });
+        Parallel::forRange(0, m, threadN, [=](int lo, int hi) {
+            if (CpuFeature::hasAVX2())
+                topLevelsInvAVX2<p, g>(a, n, k, lo, hi);
+            else
+                topLevelsInv<p, g>(a, n, k, lo, hi);
+        }, 8);
+    }
+
+private:
+    // out[i] = (a * b)[i] mod p, i < size
+    template <int p, int g>
+    static void multiplyPrime(const vector<int>& a, const vector<int>& b, unsigned* out, int size, int threadN) {
+        typedef AVX2NTT<p, g> NTTp;
+        NTTp::Base::prepare(size);
+
+        bool sq = (&a == &b);
+        vector<unsigned> B(sq ? 0 : size);
+        Parallel::forRange(0, size, threadN, [&](int lo, int hi) {
+            for (int i = lo; i < hi; i++)
+                out[i] = (i < int(a.size())) ? unsigned(a[i] % p) : 0u;
+            if (!sq) {
+                for (int i = lo; i < hi; i++)
+                    B[i] = (i < int(b.size())) ? unsigned(b[i] % p) : 0u;
+            }
+        });
+
+        if (sq) {
+            nttParallel<p, g>(out, size, threadN);
+        } else if (threadN >= 2) {
+            Parallel::invoke([&]() { nttParallel<p, g>(out, size, threadN / 2); },
+                             [&]() { nttParallel<p, g>(B.data(), size, threadN - threadN / 2); });
+        } else {
+            nttParallel<p, g>(out, size, threadN);
+            nttParallel<p, g>(B.data(), size, threadN);
+        }
+
+        const unsigned* right = sq ? out : B.data();
+        Parallel::forRange(0, size, threadN, [&](int lo, int hi) {
+            NTTp::multiplyPointwise(out + lo, right + lo, out + lo, hi - lo, size);
+        }, 8);
+
+        nttInvParallel<p, g>(out, size, threadN);
+
+        Parallel::forRange(0, size, threadN, [&](int lo, int hi) {
+            for (int i = lo; i < hi; i++)
+                out[i] = NTTp::Base::normalize(out[i]);
+        });
+    }
+
+    // 2^k >= threadN sub-blocks, each sub-block has at least MIN_BLOCK_SIZE elements
+    static int blockLevel(int n, int threadN) {
+        if (threadN <= 1 || n < PARALLEL_MIN_SIZE)
+            return 0;
+
+        int k = 0;
+        while ((1 << k) < threadN && (n >> (k + 1)) >= MIN_BLOCK_SIZE)
+            k++;
+        return k;
+    }
+
+    // zeta_j = w_n ^ bitrev_k(j) (or its inverse), Montgomery form
+    template <int p, int g>
+    static unsigned zeta(int n, int k, int j, bool inverse) {
+        typedef MontgomeryNTT<p, g> NTTp;
+
+        int rev = 0;
+        for (int i = 0; i < k; i++) {
+            if ((j >> i) & 1)
+                rev |= 1 << (k - 1 - i);
+        }
+
+        int w = NTTp::modPow(NTTp::modPow(g, (p - 1) / n), rev);
+        if (inverse)
+            w = NTTp::modInv(w);
+        return NTTp::toMontgomery(w);
+    }
+
+    // a[i] *= z^i
+    template <int p, int g>
+    static void twist(unsigned* a, int m, unsigned z) {
+        if (CpuFeature::hasAVX2()) {
+            twistAVX2<p, g>(a, m, z);
+            return;
+        }
+
+        typedef MontgomeryNTT<p, g> NTTp;
+        unsigned cur = NTTp::toMontgomery(1);
+        for (int i = 0; i < m; i++) {
+            a[i] = NTTp::mul(a[i], cur);
+            cur = NTTp::mul(cur, z);
+        }
+    }
+
+    // m is a multiple of 8
+    template <int p, int g>
+    TARGET_AVX2
+    static void twistAVX2(unsigned* a, int m, unsigned z) {
+        typedef AVX2NTT<p, g> NTTp;
+
+        unsigned pw[8];
+        pw[0] = NTTp::Base::toMontgomery(1);
+        for (int i = 1; i < 8; i++)
+            pw[i] = NTTp::Base::mul(pw[i - 1], z);
+        __m256i cur = NTTp::load(pw);
+        __m256i step = _mm256_set1_epi32(int(NTTp::Base::mul(pw[7], z)));
+
+        for (int i = 0; i < m; i += 8) {
+            NTTp::store(a + i, NTTp::mul(NTTp::load(a + i), cur));
+            cur = NTTp::mul(cur, step);
+        }
+    }
+
+    // the top k levels of MontgomeryNTT::ntt() for the elements at i (mod m), lo <= i < hi
+    template <int p, int g>
+    static void topLevels(unsigned* a, int n, int k, int lo, int hi) {
+        typedef MontgomeryNTT<p, g> NTTp;
+
+        int m = n >> k;
+        for (int len = 0; len < k; len++) {
+            int half = n >> (len + 1);
+            for (int s = 0; s < (1 << len); s++) {
+                unsigned rot = NTTp::tw[s];
+                unsigned* x = a + s * (n >> len);
+                for (int q = 0; q < half; q += m) {
+                    for (int i = q + lo; i < q + hi; i++) {
+                        unsigned l = x[i];
+                        unsigned r = NTTp::mul(x[i + half], rot);
+                        x[i] = NTTp::add(l, r);
+                        x[i + half] = NTTp::sub(l, r);
+                    }
+                }
+            }
+        }
+    }
+
+    template <int p, int g>
+    TARGET_AVX2
+    static void topLevelsAVX2(unsigned* a, int n, int k, int lo, int hi) {
+        typedef AVX2NTT<p, g> NTTp;
+
+        int m = n >> k;
+        for (int len = 0; len < k; len++) {
+            int half = n >> (len + 1);
+            for (int s = 0; s < (1 << len); s++) {
+                __m256i rot = _mm256_set1_epi32(int(NTTp::Base::tw[s]));
+                unsigned* x = a + s * (n >> len);
+                for (int q = 0; q < half; q += m) {
+                    for (int i = q + lo; i < q + hi; i += 8) {
+                        __m256i l = NTTp::load(x + i);
+                        __m256i r = NTTp::mul(NTTp::load(x + i + half), rot);
+                        NTTp::store(x + i, NTTp::add(l, r));
+                        NTTp::store(x + i + half, NTTp::sub(l, r));
+                    }
+                }
+            }
+        }
+    }
+
+    // the top k levels of MontgomeryNTT::nttInv() for the elements at i (mod m), lo <= i < hi
+    template <int p, int g>
+    static void topLevelsInv(unsigned* a, int n, int k, int lo, int hi) {
+        typedef MontgomeryNTT<p, g> NTTp;
+
+        int m = n >> k;
+        for (int len = k - 1; len >= 0; len--) {
+            int half = n >> (len + 1);
+            for (int s = 0; s < (1 << len); s++) {
+                unsigned irot = NTTp::itw[s];
+                unsigned* x = a + s * (n >> len);
+                for (int q = 0; q < half; q += m) {
+                    for (int i = q + lo; i < q + hi; i++) {
+                        unsigned l = x[i];
+                        unsigned r = x[i + half];
+                        x[i] = NTTp::add(l, r);
+                        x[i + half] = NTTp::mul(NTTp::sub(l, r), irot);
+                    }
+                }
+            }
+        }
+    }
+
+    template <int p, int g>
+    TARGET_AVX2
+    static void topLevelsInvAVX2(unsigned* a, int n, int k, int lo, int hi) {
+        typedef AVX2NTT<p, g> NTTp;
+
+        int m = n >> k;
+        for (int len = k - 1; len >= 0; len--) {
+            int half = n >> (len + 1);
+            for (int s = 0; s < (1 << len); s++) {
+                __m256i irot = _mm256_set1_epi32(int(NTTp::Base::itw[s]));
+                unsigned* x = a + s * (n >> len);
+                for (int q = 0; q < half; q += m) {
+                    for (int i = q + lo; i < q + hi; i += 8) {
+                        __m256i l = NTTp::load(x + i);
+                        __m256i r = NTTp::load(x + i + half);
+                        NTTp::store(x + i, NTTp::add(l, r));
+                        NTTp::store(x + i + half, NTTp::mul(NTTp::sub(l, r), irot));
+                    }
+                }
+            }
+        }
+    }
+
+    //--- Garner
+
+    static const GarnerMod3<P1, P2, P3>& getGarner() {
+        static const GarnerMod3<P1, P2, P3> garner;
+        return garner;
+    }
+
+    static void garner(const int* x, const int* y, const int* z, int* out, int lo, int hi) {
+        garner(x, y, z, out, lo, hi, integral_constant<bool, (mod % 2 == 1 && mod < (1 << 30))>());
+    }
+
+    static void garner(const int* x, const int* y, const int* z, int* out, int lo, int hi, false_type) {
+        getGarner().get(x, y, z, out, lo, hi, mod);
+    }
+
+    static void garner(const int* x, const int* y, const int* z, int* out, int lo, int hi, true_type) {
+        if (CpuFeature::hasAVX2())
+            garnerAVX2(x, y, z, out, lo, hi);
+        else
+            getGarner().get(x, y, z, out, lo, hi, mod);
+    }
+
+    // Montgomery arithmetic on P2, P3 and 'mod' (root is not used by the arithmetic)
+    TARGET_AVX2
+    static void garnerAVX2(const int* x, const int* y, const int* z, int* out, int lo, int hi) {
+        typedef AVX2NTT<P2, 3> N2;
+        typedef AVX2NTT<P3, 11> N3;
+        typedef AVX2NTT<mod, 3> NM;
+
+        const GarnerMod3<P1, P2, P3>& g = getGarner();
+
+        const __m256i p2 = _mm256_set1_epi32(P2);
+        const __m256i p3 = _mm256_set1_epi32(P3);
+        const __m256i p3x3 = _mm256_set1_epi32(int(3u * P3));
+        const __m256i modV = _mm256_set1_epi32(mod);
+
+        // mul(u, K) = u * k when K = k * R
+        const __m256i k1 = _mm256_set1_epi32(int(N2::Base::normalize(N2::Base::toMontgomery(g.m1InvM2))));
+        const __m256i k2 = _mm256_set1_epi32(int(N3::Base::normalize(N3::Base::toMontgomery(g.m12InvM3))));
+        const __m256i k3 = _mm256_set1_epi32(int(N3::Base::normalize(N3::Base::toMontgomery(g.m1ModM3))));
+        const __m256i m1Mod = _mm256_set1_epi32(int(NM::Base::normalize(NM::Base::toMontgomery(P1 % mod))));
+        const __m256i m12Mod = _mm256_set1_epi32(int(NM::Base::normalize(NM::Base::toMontgomery(int(1ll * P1 * P2 % mod)))));
+        const __m256i one = _mm256_set1_epi32(int(NM::Base::normalize(NM::Base::toMontgomery(1))));
+
+        int i = lo;
+        for (; i + 8 <= hi; i += 8) {
+            __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+            __m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+            __m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(z + i));
+
+            // v1 = (r2 - r1) * m1^-1 (mod P2), r1 < P1 < P2
+            __m256i v1 = N2::mul(_mm256_add_epi32(_mm256_sub_epi32(r2, r1), p2), k1);
+            v1 = _mm256_min_epu32(v1, _mm256_sub_epi32(v1, p2));
+
+            // v2 = (r3 - r1 - m1 * v1) * (m1 * m2)^-1 (mod P3), 0 < r3 + 3 * P3 - r1 - (m1 * v1 % P3) < 4 * P3
+            __m256i t = N3::mul(v1, k3);
+            __m256i v2 = N3::mul(_mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(r3, p3x3), t), r1), k2);
+            v2 = _mm256_min_epu32(v2, _mm256_sub_epi32(v2, p3));
+
+            // r1 + m1 * v1 + m1 * m2 * v2 (mod 'mod')
+            __m256i res = NM::add(NM::add(NM::mul(v1, m1Mod), NM::mul(v2, m12Mod)), NM::mul(r1, one));
+            res = _mm256_min_epu32(res, _mm256_sub_epi32(res, modV));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), res);
+        }
+        g.get(x, y, z, out, i, hi, mod);
+    }
+};
@@ -11,6 +11,7 @@
 using namespace std;
 
 #include "polynomialProduct.h"
+#include "ntt.h"
 
 
 /////////// For Testing ///////////////////////////////////////////////////////
@@ -22,6 +23,7 @@ using namespace std;
 #include "../common/iostreamhelper.h"
 #include "../common/profile.h"
 #include "../common/rand.h"
+#include <chrono>
 
 //<Related problems>
 // https://www.hackerearth.com/problem/algorithm/stange-product-sums-e3bf6340/
@@ -181,6 +183,77 @@ void testPolynomialProduct() {
         }
         assert(ans == gt);
     }
+    // PolynomialProduct
+    {
+        const int MOD = 998244353;
+
+        for (int n : { 1, 2, 3, 10, 100, 1000 }) {
+            for (int maxDeg : { 1, 5, 40, 300 }) {
+                vector<vector<int>> polys(n);
+                for (auto& p : polys) {
+                    p.resize(1 + RandInt32::get() % maxDeg + 1);
+                    for (auto& c : p)
+                        c = RandInt32::get() % MOD;
+                }
+
+                vector<int> gt{ 1 };
+                for (auto& p : polys)
+                    gt = NTT<MOD, 3>::multiply(gt, p);
+
+                for (int threadN = 1; threadN <= 4; threadN++) {
+                    auto ans = PolynomialProduct<MOD>::multiplyAll(polys, threadN);
+                    if (ans != gt)
+                        cout << "Mismatched : n = " << n << ", maxDeg = " << maxDeg << ", threadN = " << threadN << endl;
+                    assert(ans == gt);
+                }
+            }
+
+            vector<int> A(n);
+            for (auto& a : A)
+                a = RandInt32::get() % MOD;
+            vector<int> gt{ 1 };
+            for (auto a : A)
+                gt = PolynomialProduct<MOD>::multiplyNaive(gt, vector<int>{ 1, a });
+            assert(PolynomialProduct<MOD>::multiplyLinear(A, 3) == gt);
+        }
+        assert(PolynomialProduct<MOD>::multiplyAll(vector<vector<int>>()) == vector<int>{ 1 });
+    }
 
     cout << "OK!" << endl;
+    return; //TODO: if you want to test, make this line a comment.
+    {
+        cout << "*** Speed test: PROD (1 + a_i * x), N = 10^6 ***" << endl;
+
+        const int MOD = 998244353;
+        int N = 1000000;
+        vector<int> A(N);
+        for (auto& a : A)
+            a = RandInt32::get() % MOD;
+
+        vector<int> gt;
+        {
+            cout << "  level by level, NTT::multiply()" << endl;
+            PROFILE_HI_START(0);
+            vector<vector<int>> cur(N);
+            for (int i = 0; i < N; i++)
+                cur[i] = vector<int>{ 1, A[i] };
+            while (cur.size() > 1) {
+                vector<vector<int>> next((cur.size() + 1) / 2);
+                for (int i = 0; i + 1 < int(cur.size()); i += 2)
+                    next[i / 2] = NTT<MOD, 3>::multiply(cur[i], cur[i + 1]);
+                if (cur.size() & 1)
+                    next.back() = move(cur.back());
+                cur.swap(next);
+            }
+            gt = cur[0];
+            PROFILE_HI_STOP(0);
+        }
+        for (int threadN = 1; threadN <= Parallel::threadCount(); threadN *= 2) {
+            auto start = chrono::high_resolution_clock::now();
+            auto ans = PolynomialProduct<MOD>::multiplyLinear(A, threadN);
+            double sec = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+            assert(ans == gt);
+            cout << "  PolynomialProduct, threads = " << threadN << " : " << sec << " sec" << endl;
+        }
+    }
 }
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include "../common/parallel.h"
+#include "polyNTTParallel.h"
+
 /*
 https://www.hackerearth.com/problem/algorithm/stange-product-sums-e3bf6340/
 https://www.hackerearth.com/problem/algorithm/stange-product-sums-e3bf6340/editorial/
@@ -102,3 +108,196 @@ https://www.hackerearth.com/problem/algorithm/stange-product-sums-e3bf6340/edito
                             { (d*x)^0/1! + (d*x)^1/2! + (d*x)^2/3! + ... }
 */
 
+/*
+  Parallel product tree in Huffman order
+
+  - the two polynomials with the smallest sizes are always merged first (priority queue over sizes),
+    which minimizes the total transform work for unbalanced inputs
+  - every thread takes the next pair from the shared queue (no level barrier),
+    and keeps its own NTT buffers for all its merges
+  - tiny leaves (ex: 1 + a_i * x) are first grouped and multiplied naively
+  - the last merge uses all threads (ParallelPolyNTT::nttParallel())
+
+  <How to use>
+    auto P = PolynomialProduct<>::multiplyAll(polys);           // PROD polys[i]
+    auto Q = PolynomialProduct<>::multiplyLinear(A);            // PROD (1 + A[i] * x)
+*/
+template <int mod = 998244353, int root = 3>
+struct PolynomialProduct {
+    typedef AVX2NTT<mod, root> NTTp;
+
+    static const int NAIVE_THRESHOLD = 32;      // naive multiplication if min(|a|, |b|) <= it
+    static const int LEAF_GROUP_SIZE = 64;      // leaves are grouped up to this size
+
+    // threadN = 0 : all hardware threads
+    static vector<int> multiplyAll(vector<vector<int>> polys, int threadN = 0) {
+        if (polys.empty())
+            return vector<int>{ 1 };
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+
+        long long total = 1;
+        for (auto& p : polys) {
+            if (p.empty())
+                return vector<int>();
+            total += int(p.size()) - 1;
+        }
+        int maxSize = 1;
+        while (maxSize < total)
+            maxSize <<= 1;
+        NTTp::Base::prepare(maxSize);       // the tables can't grow in parallel
+
+        vector<vector<int>> nodes = groupLeaves(polys, threadN);
+        return mergeAll(nodes, threadN);
+    }
+
+    // PROD (1 + a[i] * x)
+    static vector<int> multiplyLinear(const vector<int>& a, int threadN = 0) {
+        vector<vector<int>> polys(a.size());
+        for (int i = 0; i < int(a.size()); i++)
+            polys[i] = vector<int>{ 1, a[i] };
+        return multiplyAll(move(polys), threadN);
+    }
+
+    // a * b with the caller's buffers
+    // - threadN > 1 : parallel transforms
+    static vector<int> multiply(const vector<int>& a, const vector<int>& b, vector<unsigned>& bufA, vector<unsigned>& bufB, int threadN = 1) {
+        int na = int(a.size()), nb = int(b.size());
+        if (na == 0 || nb == 0)
+            return vector<int>();
+        if (min(na, nb) <= NAIVE_THRESHOLD)
+            return multiplyNaive(a, b);
+
+        int n = na + nb - 1;
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        if (int(bufA.size()) < size)
+            bufA.resize(size);
+        if (int(bufB.size()) < size)
+            bufB.resize(size);
+        copy(a.begin(), a.end(), bufA.begin());
+        fill(bufA.begin() + na, bufA.begin() + size, 0u);
+        copy(b.begin(), b.end(), bufB.begin());
+        fill(bufB.begin() + nb, bufB.begin() + size, 0u);
+
+        unsigned* x = bufA.data();
+        unsigned* y = bufB.data();
+        if (threadN > 1) {
+            Parallel::invoke([=]() { ParallelPolyNTT<mod>::template nttParallel<mod, root>(x, size, (threadN + 1) / 2); },
+                             [=]() { ParallelPolyNTT<mod>::template nttParallel<mod, root>(y, size, threadN / 2); });
+            Parallel::forRange(0, size, threadN, [=](int lo, int hi) {
+                NTTp::multiplyPointwise(x + lo, y + lo, x + lo, hi - lo, size);
+            }, 8);
+            ParallelPolyNTT<mod>::template nttInvParallel<mod, root>(x, size, threadN);
+        } else {
+            NTTp::ntt(x, size);
+            NTTp::ntt(y, size);
+            NTTp::multiplyPointwise(x, y, x, size);
+            NTTp::nttInv(x, size);
+        }
+
+        vector<int> res(n);
+        for (int i = 0; i < n; i++)
+            res[i] = int(NTTp::Base::normalize(x[i]));
+        return res;
+    }
+
+    static vector<int> multiplyNaive(const vector<int>& a, const vector<int>& b) {
+        int na = int(a.size()), nb = int(b.size());
+        if (na < nb)
+            return multiplyNaive(b, a);
+
+        vector<int> res(na + nb - 1);
+        for (int i = 0; i < na + nb - 1; i++) {
+            unsigned long long sum = 0;
+            int lo = max(0, i - na + 1), hi = min(i, nb - 1);
+            for (int j = lo; j <= hi; j++) {
+                sum += 1ull * b[j] * a[i - j];
+                if (((j - lo) & 15) == 15)
+                    sum %= mod;
+            }
+            res[i] = int(sum % mod);
+        }
+        return res;
+    }
+
+private:
+    // consecutive leaves in size order are multiplied naively while the group size <= LEAF_GROUP_SIZE
+    static vector<vector<int>> groupLeaves(vector<vector<int>>& polys, int threadN) {
+        vector<int> order(polys.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&polys](int l, int r) {
+            return polys[l].size() < polys[r].size();
+        });
+
+        vector<int> groupStart;
+        for (int i = 0, size = LEAF_GROUP_SIZE + 1; i < int(order.size()); i++) {
+            int n = int(polys[order[i]].size());
+            if (size + n - 1 > LEAF_GROUP_SIZE) {
+                groupStart.push_back(i);
+                size = n;
+            } else {
+                size += n - 1;
+            }
+        }
+        groupStart.push_back(int(order.size()));
+
+        int groupN = int(groupStart.size()) - 1;
+        vector<vector<int>> res(groupN);
+        Parallel::forRange(0, groupN, threadN, [&](int lo, int hi) {
+            for (int g = lo; g < hi; g++) {
+                vector<int> cur = move(polys[order[groupStart[g]]]);
+                for (int i = groupStart[g] + 1; i < groupStart[g + 1]; i++) {
+                    cur = multiplyNaive(cur, polys[order[i]]);
+                    vector<int>().swap(polys[order[i]]);
+                }
+                res[g] = move(cur);
+            }
+        });
+        return res;
+    }
+
+    static vector<int> mergeAll(vector<vector<int>>& nodes, int threadN) {
+        typedef pair<int, int> SizeIndex;
+        priority_queue<SizeIndex, vector<SizeIndex>, greater<SizeIndex>> heap;
+        for (int i = 0; i < int(nodes.size()); i++)
+            heap.emplace(int(nodes[i].size()), i);
+
+        mutex mtx;
+        condition_variable cv;
+        int busy = 0;
+
+        auto worker = [&](int) {
+            vector<unsigned> bufA, bufB;
+            unique_lock<mutex> lock(mtx);
+            while (true) {
+                cv.wait(lock, [&]() { return heap.size() >= 2 || (busy == 0 && heap.size() <= 1); });
+                if (heap.size() < 2)
+                    break;
+
+                int x = heap.top().second;
+                heap.pop();
+                int y = heap.top().second;
+                heap.pop();
+                bool last = heap.empty() && busy == 0;
+                busy++;
+                lock.unlock();
+
+                vector<int> r = multiply(nodes[x], nodes[y], bufA, bufB, last ? threadN : 1);
+                vector<int>().swap(nodes[y]);
+                nodes[x].swap(r);
+
+                lock.lock();
+                heap.emplace(int(nodes[x].size()), x);
+                busy--;
+                cv.notify_all();
+            }
+            cv.notify_all();
+        };
+        Parallel::forEach(threadN, threadN, worker);
+
+        return move(nodes[heap.top().second]);
+    }
+};
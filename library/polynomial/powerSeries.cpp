@@ -15,6 +15,8 @@ using namespace std;
 #include <string>
 #include <iostream>
 #include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
 
 //<Related problems>
 // https://www.codechef.com/problems/PPARTS
@@ -39,5 +41,123 @@ void testPowerSeries() {
             cout << "Mismatched : " << ans << ", " << gt << endl;
         assert(ans == gt);
     }
+    {
+        typedef NTT<998'244'353, 3> NTTT;
+        typedef PowerSeriesFastNTT<998'244'353, 3> FastT;
+        const int MOD = 998'244'353;
+
+        for (int n = 1; n <= 3000; n += 1 + n / 3) {
+            vector<int> a(n);
+            for (int i = 0; i < n; i++)
+                a[i] = RandInt32::get() % MOD;
+
+            a[0] = 1 + RandInt32::get() % (MOD - 1);
+            auto inv1 = NTTT::inverse(a);
+            auto inv2 = FastT::inverse(a);
+            if (inv1 != inv2)
+                cout << "Mismatched inverse() at n = " << n << endl;
+            assert(inv1 == inv2);
+
+            a[0] = 1;
+            auto ln1 = NTTT::ln(a);
+            ln1.resize(n);
+            auto ln2 = FastT::ln(a);
+            if (ln1 != ln2)
+                cout << "Mismatched ln() at n = " << n << endl;
+            assert(ln1 == ln2);
+
+            a[0] = 0;
+            auto exp1 = NTTT::exp(a);
+            exp1.resize(n);
+            auto exp2 = FastT::exp(a);
+            if (exp1 != exp2)
+                cout << "Mismatched exp() at n = " << n << endl;
+            assert(exp1 == exp2);
+
+            // sqrt(b^2) = +-b
+            vector<int> b(a.begin(), a.begin() + (n + 1) / 2);
+            b[0] = 1 + RandInt32::get() % (MOD - 1);
+            vector<int> b2 = NTTT::multiply(b, b);
+            b2.resize(n);
+            auto sq = FastT::sqrt(b2);
+            auto sq2 = NTTT::multiply(sq, sq);
+            sq2.resize(n);
+            if (sq2 != b2)
+                cout << "Mismatched sqrt() at n = " << n << endl;
+            assert(sq2 == b2);
+        }
+
+        vector<int> a{ 0, 0, 0, 0, 4, 4, 1 };
+        vector<int> gt{ 0, 0, 2, 1, 0, 0, 0 };
+        auto ans = FastT::sqrt(a);
+        if (ans[2] != 2) {
+            for (auto& x : ans)
+                x = (MOD - x) % MOD;
+        }
+        if (ans != gt)
+            cout << "Mismatched : " << ans << ", " << gt << endl;
+        assert(ans == gt);
+        assert(FastT::sqrt(vector<int>{ 0, 1, 2 }).empty());
+    }
     cout << "OK!" << endl;
+    return; //TODO: if you want to test, make this line a comment.
+    {
+        cout << "*** Speed test NTT vs PowerSeriesFastNTT ***" << endl;
+
+        typedef NTT<998'244'353, 3> NTTT;
+        typedef PowerSeriesFastNTT<998'244'353, 3> FastT;
+        const int MOD = 998'244'353;
+
+        for (int n : { 100'000, 1'000'000, 4'000'000 }) {
+            vector<int> a(n);
+            for (int i = 0; i < n; i++)
+                a[i] = RandInt32::get() % MOD;
+            cout << "N = " << n << endl;
+
+            a[0] = 1;
+            cout << "  inverse()" << endl;
+            PROFILE_HI_START(0);
+            auto inv1 = NTTT::inverse(a);
+            PROFILE_HI_STOP(0);
+            PROFILE_HI_START(1);
+            auto inv2 = FastT::inverse(a);
+            PROFILE_HI_STOP(1);
+            assert(inv1 == inv2);
+
+            cout << "  ln()" << endl;
+            PROFILE_HI_START(2);
+            auto ln1 = NTTT::ln(a);
+            PROFILE_HI_STOP(2);
+            PROFILE_HI_START(3);
+            auto ln2 = FastT::ln(a);
+            PROFILE_HI_STOP(3);
+            ln1.resize(n);
+            assert(ln1 == ln2);
+
+            // there is no sqrt() in NTT, so exp(ln(a) / 2) is the baseline
+            cout << "  sqrt()" << endl;
+            PROFILE_HI_START(4);
+            auto sq1 = NTTT::ln(a);
+            for (auto& x : sq1)
+                x = int(1ll * x * ((MOD + 1) / 2) % MOD);
+            sq1 = NTTT::exp(sq1);
+            PROFILE_HI_STOP(4);
+            PROFILE_HI_START(5);
+            auto sq2 = FastT::sqrt(a);
+            PROFILE_HI_STOP(5);
+            sq1.resize(n);
+            assert(sq1 == sq2);
+
+            a[0] = 0;
+            cout << "  exp()" << endl;
+            PROFILE_HI_START(6);
+            auto exp1 = NTTT::exp(a);
+            PROFILE_HI_STOP(6);
+            PROFILE_HI_START(7);
+            auto exp2 = FastT::exp(a);
+            PROFILE_HI_STOP(7);
+            exp1.resize(n);
+            assert(exp1 == exp2);
+        }
+    }
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ntt.h"
+#include "ntt_avx2.h"
 #include "polyFFTMod2.h"
+#include "../integer/discreteSqrt.h"
 
 /*
   1) e^x = x^0/0! + x^1/1! + x^2/2! + x^3/3! + ...
@@ -154,3 +156,271 @@ struct PowerSeriesMod {
         return fft.exp(lnF);
     }
 };
+
+
+/*
+  Fast power series operations (same API as NTT::inverse(), ln(), exp())
+
+  The Newton iterations never call multiply(). They work on transformed values directly.
+    1) middle product
+       - Only the middle part of some products is needed. A cyclic convolution of half size is enough
+         because the wrapped-around terms fall on the part we don't need.
+    2) transform reuse
+       - The transform of the current approximation is used several times in one step,
+         and the transform of a step is reused in the next step.
+    3) transform doubling
+       - The first half of a (bit-reversed) transform of size 2m is the transform of size m,
+         so the transform of size m is never recomputed.
+
+  All transforms are done by AVX2NTT (scalar Montgomery NTT on CPUs without AVX2).
+
+  [CAUTION]
+  - mod < 2^30, NTT friendly
+*/
+template <int mod = 998'244'353, int root = 3>
+struct PowerSeriesFastNTT {
+    typedef AVX2NTT<mod, root> NTTEngine;
+    typedef MontgomeryNTT<mod, root> Montgomery;
+
+    // a[0] != 0
+    static vector<int> inverse(const vector<int>& a) {
+        int n = int(a.size());
+        if (n == 0)
+            return{};
+
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        vector<unsigned> g(size), F(size), G(size);
+        g[0] = unsigned(modInv(a[0]));
+        for (int m = 1; m < n; m <<= 1) {
+            // h = (a * g - 1) / x^m, only [m, 2m) of a * g is needed
+            load(F.data(), a, 0, 2 * m, 2 * m);
+            copy(g.begin(), g.begin() + m, G.begin());
+            fill(G.begin() + m, G.begin() + 2 * m, 0u);
+            NTTEngine::ntt(F.data(), 2 * m);
+            NTTEngine::ntt(G.data(), 2 * m);
+            NTTEngine::multiplyPointwise(F.data(), G.data(), F.data(), 2 * m);
+            NTTEngine::nttInv(F.data(), 2 * m);
+
+            // g += -g * h * x^m
+            fill(F.begin(), F.begin() + m, 0u);
+            NTTEngine::ntt(F.data(), 2 * m);
+            NTTEngine::multiplyPointwise(F.data(), G.data(), F.data(), 2 * m);
+            NTTEngine::nttInv(F.data(), 2 * m);
+            for (int i = m; i < 2 * m; i++)
+                g[i] = Montgomery::sub(0, F[i]);
+        }
+
+        return store(g, n);
+    }
+
+    // ln f(x) = INTEGRAL f'(x) / f(x), a[0] = 1
+    static vector<int> ln(const vector<int>& a) {
+        int n = int(a.size());
+        if (n <= 1)
+            return vector<int>(n, 0);
+
+        vector<int> d(n - 1);
+        for (int i = 1; i < n; i++)
+            d[i - 1] = int(1ll * i * a[i] % mod);
+
+        vector<int> q = NTTEngine::multiply(d, inverse(a));
+        q.resize(n - 1);
+
+        auto inv = inverses(n);
+
+        vector<int> res(n);
+        for (int i = 1; i < n; i++)
+            res[i] = int(1ll * q[i - 1] * inv[i] % mod);
+        return res;
+    }
+
+    // a[0] = 0
+    static vector<int> exp(const vector<int>& a) {
+        int n = int(a.size());
+        if (n == 0)
+            return{};
+        if (n == 1)
+            return{ 1 };
+
+        int size = 2;
+        while (size < n)
+            size <<= 1;
+
+        auto inv = inverses(size);
+
+        // b = e^a (mod x^m), c = b^-1 (mod x^(m/2)), Z = ntt(c) of size m
+        vector<unsigned> b(size), c(size / 2), Y(size), Z(size), X(size), T(size);
+        b[0] = 1;
+        b[1] = unsigned(a[1]);
+        c[0] = 1;
+        Z[0] = 1;
+        Z[1] = 0;
+        NTTEngine::ntt(Z.data(), 2);
+        for (int m = 2; m < n; m <<= 1) {
+            // Y = ntt(b) of size 2m, Y[0..m) = ntt(b) of size m
+            copy(b.begin(), b.begin() + m, Y.begin());
+            fill(Y.begin() + m, Y.begin() + 2 * m, 0u);
+            NTTEngine::ntt(Y.data(), 2 * m);
+
+            // c = b^-1 (mod x^m) with the transforms of size m
+            NTTEngine::multiplyPointwise(Y.data(), Z.data(), T.data(), m);
+            NTTEngine::nttInv(T.data(), m);
+            fill(T.begin(), T.begin() + m / 2, 0u);
+            NTTEngine::ntt(T.data(), m);
+            NTTEngine::multiplyPointwise(T.data(), Z.data(), T.data(), m);
+            NTTEngine::nttInv(T.data(), m);
+            for (int i = m / 2; i < m; i++)
+                c[i] = Montgomery::sub(0, T[i]);
+
+            copy(c.begin(), c.begin() + m, Z.begin());
+            fill(Z.begin() + m, Z.begin() + 2 * m, 0u);
+            NTTEngine::ntt(Z.data(), 2 * m);
+
+            // X = (a mod x^m)' * b - b'  (mod x^m - 1), it's zero below x^(m-1)
+            for (int i = 0; i < m - 1; i++)
+                X[i] = unsigned(1ll * (i + 1) * (i + 1 < n ? a[i + 1] : 0) % mod);
+            X[m - 1] = 0;
+            NTTEngine::ntt(X.data(), m);
+            NTTEngine::multiplyPointwise(X.data(), Y.data(), X.data(), m);
+            NTTEngine::nttInv(X.data(), m);
+            for (int i = 0; i < m - 1; i++)
+                X[i] = Montgomery::sub(X[i], unsigned(1ll * (i + 1) * Montgomery::normalize(b[i + 1]) % mod));
+
+            // move the wrapped-around part to the right place
+            fill(X.begin() + m, X.begin() + 2 * m, 0u);
+            for (int i = 0; i < m - 1; i++) {
+                X[m + i] = X[i];
+                X[i] = 0;
+            }
+
+            // X = INTEGRAL X / b
+            NTTEngine::ntt(X.data(), 2 * m);
+            NTTEngine::multiplyPointwise(X.data(), Z.data(), X.data(), 2 * m);
+            NTTEngine::nttInv(X.data(), 2 * m);
+            for (int i = 2 * m - 1; i > 0; i--)
+                X[i] = unsigned(1ll * Montgomery::normalize(X[i - 1]) * inv[i] % mod);
+            X[0] = 0;
+
+            // X = a - ln b (mod x^2m), b += b * X
+            for (int i = m; i < min(n, 2 * m); i++)
+                X[i] = Montgomery::add(X[i], unsigned(a[i]));
+            fill(X.begin(), X.begin() + m, 0u);
+            NTTEngine::ntt(X.data(), 2 * m);
+            NTTEngine::multiplyPointwise(X.data(), Y.data(), X.data(), 2 * m);
+            NTTEngine::nttInv(X.data(), 2 * m);
+            copy(X.begin() + m, X.begin() + 2 * m, b.begin() + m);
+        }
+
+        return store(b, n);
+    }
+
+    // the result is empty if a has no square root
+    static vector<int> sqrt(const vector<int>& a) {
+        int n = int(a.size());
+
+        int zeros = 0;
+        while (zeros < n && a[zeros] == 0)
+            zeros++;
+        if (zeros == n)
+            return vector<int>(n, 0);
+        if (zeros & 1)
+            return{};
+
+        int s0 = DiscreteSqrt32bit::solve(a[zeros], mod);
+        if (s0 < 0)
+            return{};
+
+        vector<int> A(a.begin() + zeros, a.end());
+        vector<int> res(zeros / 2);
+        vector<int> b = sqrtNonzero(A, s0, n - zeros / 2);
+        res.insert(res.end(), b.begin(), b.begin() + (n - zeros / 2));
+        return res;
+    }
+
+private:
+    // a[0] = s0^2, returns sqrt(a) (mod x^n)
+    static vector<int> sqrtNonzero(const vector<int>& a, int s0, int n) {
+        int size = 1;
+        while (size < n)
+            size <<= 1;
+
+        const unsigned inv2 = unsigned(mod + 1) / 2;
+        const unsigned inv2M = Montgomery::toMontgomery(inv2);
+
+        // b = sqrt(a) (mod x^m), c = b^-1 (mod x^m), B = ntt(b) of size m
+        vector<unsigned> b(size), c(size), B(size), C(size), T(size);
+        b[0] = unsigned(s0);
+        c[0] = unsigned(modInv(s0));
+        B[0] = b[0];
+        for (int m = 1; m < n; m <<= 1) {
+            // T = b^2 (mod x^m - 1) = (a mod x^m) + (b^2 / x^m)
+            NTTEngine::multiplyPointwise(B.data(), B.data(), T.data(), m);
+            NTTEngine::nttInv(T.data(), m);
+
+            // T = (a - b^2) / x^m / 2
+            for (int i = 0; i < m; i++) {
+                unsigned lo = i < int(a.size()) ? unsigned(a[i]) : 0u;
+                unsigned hi = m + i < int(a.size()) ? unsigned(a[m + i]) : 0u;
+                T[i] = Montgomery::mul(Montgomery::sub(Montgomery::add(hi, lo), T[i]), inv2M);
+            }
+            fill(T.begin() + m, T.begin() + 2 * m, 0u);
+
+            // b += T * c * x^m
+            copy(c.begin(), c.begin() + m, C.begin());
+            fill(C.begin() + m, C.begin() + 2 * m, 0u);
+            NTTEngine::ntt(C.data(), 2 * m);
+            NTTEngine::ntt(T.data(), 2 * m);
+            NTTEngine::multiplyPointwise(T.data(), C.data(), T.data(), 2 * m);
+            NTTEngine::nttInv(T.data(), 2 * m);
+            copy(T.begin(), T.begin() + m, b.begin() + m);
+
+            if (2 * m >= n)
+                break;
+
+            // B = ntt(b) of size 2m
+            copy(b.begin(), b.begin() + 2 * m, B.begin());
+            NTTEngine::ntt(B.data(), 2 * m);
+
+            // c = b^-1 (mod x^2m), only [m, 2m) of b * c is needed
+            NTTEngine::multiplyPointwise(B.data(), C.data(), T.data(), 2 * m);
+            NTTEngine::nttInv(T.data(), 2 * m);
+            fill(T.begin(), T.begin() + m, 0u);
+            NTTEngine::ntt(T.data(), 2 * m);
+            NTTEngine::multiplyPointwise(T.data(), C.data(), T.data(), 2 * m);
+            NTTEngine::nttInv(T.data(), 2 * m);
+            for (int i = m; i < 2 * m; i++)
+                c[i] = Montgomery::sub(0, T[i]);
+        }
+
+        return store(b, n);
+    }
+
+    // dst[0..size) = a[first..last) with zero padding
+    static void load(unsigned* dst, const vector<int>& a, int first, int last, int size) {
+        int n = max(0, min(last, int(a.size())) - first);
+        copy(a.begin() + first, a.begin() + first + n, dst);
+        fill(dst + n, dst + size, 0u);
+    }
+
+    static vector<int> store(const vector<unsigned>& a, int n) {
+        vector<int> res(n);
+        for (int i = 0; i < n; i++)
+            res[i] = int(Montgomery::normalize(a[i]));
+        return res;
+    }
+
+    static vector<int> inverses(int n) {
+        vector<int> inv(n + 1);
+        inv[1] = 1;
+        for (int i = 2; i <= n; i++)
+            inv[i] = int((mod - 1ll * (mod / i) * inv[mod % i] % mod) % mod);
+        return inv;
+    }
+
+    static int modInv(int x) {
+        return Montgomery::modInv(x);
+    }
+};
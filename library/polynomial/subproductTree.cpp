@@ -0,0 +1,143 @@
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+#include "subproductTree.h"
+#include "ntt_fast.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+#include "../common/memoryUsage.h"
+
+#define MOD     998244353
+
+static int evaluateHorner(const vector<int>& f, int x) {
+    long long res = 0;
+    for (int i = int(f.size()) - 1; i >= 0; i--)
+        res = (res * x + f[i]) % MOD;
+    return int(res);
+}
+
+void testSubproductTree() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Subproduct Tree ------------------------" << endl;
+    {
+        for (int n : { 1, 2, 3, 5, 8, 33, 64, 100, 257, 1000, 3000 }) {
+            for (int fN : { 1, n / 2 + 1, n, 2 * n + 3 }) {
+                vector<int> X(n), f(fN);
+                for (int i = 0; i < n; i++)
+                    X[i] = RandInt32::get() % MOD;
+                if (n > 2)
+                    X[n - 1] = X[0];                // duplicated points
+                for (int i = 0; i < fN; i++)
+                    f[i] = RandInt32::get() % MOD;
+
+                vector<int> gt(n);
+                for (int i = 0; i < n; i++)
+                    gt[i] = evaluateHorner(f, X[i]);
+
+                for (int threadN = 1; threadN <= 3; threadN++) {
+                    for (int discardLevels : { 0, 1, 6 }) {
+                        SubproductTree<MOD, 3> tree;
+                        tree.build(X, threadN, discardLevels);
+                        auto Y = tree.evaluate(f);
+                        if (Y != gt)
+                            cout << "Mismatched evaluate() : n = " << n << ", fN = " << fN << ", threadN = " << threadN << ", discardLevels = " << discardLevels << endl;
+                        assert(Y == gt);
+                    }
+                }
+            }
+
+            // interpolation needs distinct points
+            vector<int> X(n), Y(n);
+            for (int i = 0; i < n; i++) {
+                X[i] = (i * 7 + 13) % MOD;
+                Y[i] = RandInt32::get() % MOD;
+            }
+            for (int discardLevels : { 0, 3 }) {
+                SubproductTree<MOD, 3> tree;
+                tree.build(X, 2, discardLevels);
+                auto g = tree.interpolate(Y);
+                assert(int(g.size()) == n);
+                for (int i = 0; i < n; i++)
+                    assert(evaluateHorner(g, X[i]) == Y[i]);
+
+                auto P = tree.polynomial();
+                for (int i = 0; i < n; i++)
+                    assert(evaluateHorner(P, X[i]) == 0);
+                assert(P[n] == 1);
+            }
+        }
+    }
+    cout << "OK!" << endl;
+    {
+        cout << "*** Speed test: FastNTT::EvaluationTree vs SubproductTree ***" << endl;
+
+        int n = 1 << 15;
+        vector<int> X(n), f(n);
+        for (int i = 0; i < n; i++) {
+            X[i] = RandInt32::get() % MOD;
+            f[i] = RandInt32::get() % MOD;
+        }
+
+        vector<int> Y1, Y2;
+        {
+            PROFILE_HI_START(0);
+            FastNTT<MOD, 3>::EvaluationTree tree;
+            tree.build(X);
+            Y1 = tree.evaluate(f, X);
+            PROFILE_HI_STOP(0);
+        }
+        {
+            PROFILE_HI_START(1);
+            SubproductTree<MOD, 3> tree;
+            tree.build(X, 1);
+            Y2 = tree.evaluate(f);
+            PROFILE_HI_STOP(1);
+        }
+        assert(Y1 == Y2);
+    }
+    {
+        cout << "*** Speed test: SubproductTree, N = 10^6 points, degree 10^6 ***" << endl;
+
+        int n = 1'000'000;
+        vector<int> X(n), f(n + 1);
+        for (int i = 0; i < n; i++)
+            X[i] = RandInt32::get() % MOD;
+        for (int i = 0; i <= n; i++)
+            f[i] = RandInt32::get() % MOD;
+
+        vector<int> gt;
+        for (int threadN = 1; threadN <= Parallel::threadCount(); threadN *= 2) {
+            for (int discardLevels : { 10, 0 }) {
+                size_t rss0 = MemoryUsage::currentRSS();
+
+                auto start = chrono::high_resolution_clock::now();
+                SubproductTree<MOD, 3> tree;
+                tree.build(X, threadN, discardLevels);
+                auto Y = tree.evaluate(f);
+                double sec = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - start).count() / 1e6;
+
+                if (gt.empty())
+                    gt = Y;
+                assert(Y == gt);
+
+                cout << "  threads = " << threadN << ", discarded levels = " << discardLevels
+                     << " : " << sec << " sec, " << n / sec << " points/sec"
+                     << ", tree = " << (tree.memoryUsage() >> 20) << " MB"
+                     << ", RSS before = " << (rss0 >> 20) << " MB"
+                     << ", peak RSS = " << (MemoryUsage::peakRSS() >> 20) << " MB" << endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,442 @@
+#pragma once
+
+#include "../common/parallel.h"
+#include "ntt_avx2.h"
+#include "powerSeries.h"
+
+/*
+  Subproduct tree in one contiguous arena (multipoint evaluation & interpolation)
+
+  - level l has (size >> l) nodes of 2^l points, a node is stored as 2^l + 1 coefficients
+  - the nodes are stored as reversed polynomials
+      Q(y) = y^s * P(1/y), P(x) = (x - X[i])(x - X[i+1])...(x - X[i+s-1])
+  - padded points are P(x) = 1
+  - evaluation uses the transposed algorithm (middle products only, no polynomial division)
+      V_root[t] = [x^(-t-1)] f(x) / P_root(x)
+      V_left    = (V * Q_right)[s, 2s)
+      V_right   = (V * Q_left)[s, 2s)
+      f(X[i])   = V_leaf[0]
+  - the nodes of a level are processed in parallel
+  - discardLevels > 0 : the lowest 'discardLevels' levels are not stored.
+                        They are rebuilt one subtree at a time when they are needed (lower peak memory).
+
+  <How to use>
+    SubproductTree<> tree;
+    tree.build(X);                          // all threads, all levels
+    auto Y = tree.evaluate(f);              // Y[i] = f(X[i])
+    auto g = tree.interpolate(Y);           // g(X[i]) = Y[i], deg(g) < n
+
+  [CAUTION]
+  - mod < 2^30, NTT friendly
+  - interpolate() needs distinct points
+*/
+template <int mod = 998'244'353, int root = 3>
+struct SubproductTree {
+    typedef AVX2NTT<mod, root> NTTEngine;
+    typedef MontgomeryNTT<mod, root> Montgomery;
+
+    static const int NAIVE_SIZE = 32;               // nodes with 2^l <= NAIVE_SIZE points use naive multiplication
+
+    int N;                                          // the number of points
+    int size;                                       // 2^logSize >= N
+    int logSize;
+    int lowLevel;                                   // levels [lowLevel, logSize] are stored
+    int threadN;
+    vector<int> X;
+    vector<unsigned> arena;
+    vector<size_t> offset;                          // offset of level l in arena
+
+    SubproductTree() : N(0), size(0), logSize(0), lowLevel(0), threadN(1) {
+    }
+
+    // threadN = 0 : all hardware threads
+    void build(const vector<int>& X, int threadN = 0, int discardLevels = 0) {
+        this->X = X;
+        this->threadN = (threadN > 0) ? threadN : Parallel::threadCount();
+
+        N = int(X.size());
+        logSize = 0;
+        while ((1 << logSize) < N)
+            logSize++;
+        size = 1 << logSize;
+        lowLevel = max(0, min(discardLevels, logSize));
+
+        NTTEngine::Base::prepare(2 * size);         // twiddle tables are not thread-safe to grow
+
+        offset.assign(logSize + 2, 0);
+        for (int l = lowLevel; l <= logSize; l++)
+            offset[l + 1] = offset[l] + size_t(size >> l) * ((size_t(1) << l) + 1);
+        arena.assign(offset[logSize + 1], 0u);
+
+        // the lowest stored level
+        int subN = size >> lowLevel;
+        Parallel::forRange(0, subN, this->threadN, [this](int lo, int hi) {
+            vector<unsigned> local;
+            vector<size_t> localOffset;
+            Scratch scratch;
+            for (int i = lo; i < hi; i++) {
+                buildSubtree(i, local, localOffset, scratch);
+                const unsigned* src = local.data() + localOffset[lowLevel];
+                copy(src, src + (1 << lowLevel) + 1, node(lowLevel, i));
+            }
+        });
+
+        for (int l = lowLevel; l < logSize; l++)
+            multiplyLevelParallel(node(l, 0), node(l + 1, 0), 1 << l, size >> (l + 1));
+    }
+
+    // (x - X[0])(x - X[1])...(x - X[N-1]), low order first
+    vector<int> polynomial() const {
+        vector<int> res(N + 1);
+        const unsigned* q = node(logSize, 0);
+        for (int i = 0; i <= N; i++)
+            res[i] = int(q[size - i]);
+        return res;
+    }
+
+    // Y[i] = f(X[i])
+    vector<int> evaluate(const vector<int>& f) const {
+        if (N == 0)
+            return{};
+
+        // V_root[t] = [y^(m - N + t)] G(y) / Prev(y), G = reverse of f, Prev(y) = y^N * P(1/y)
+        int m = max(int(f.size()), N);
+        vector<int> prev(m - N + size);
+        const unsigned* q = node(logSize, 0);
+        for (int i = 0; i <= N && i < int(prev.size()); i++)
+            prev[i] = int(q[size - N + i]);
+
+        vector<int> G(m);
+        for (int i = 0; i < int(f.size()); i++)
+            G[m - 1 - i] = f[i];
+
+        auto inv = PowerSeriesFastNTT<mod, root>::inverse(prev);
+        auto GQ = NTTEngine::multiply(G, inv);
+
+        vector<unsigned> V(size), W(size);
+        for (int t = 0; t < size; t++)
+            V[t] = unsigned(GQ[m - N + t]);
+
+        for (int l = logSize - 1; l >= lowLevel; l--) {
+            descendLevelParallel(V.data(), W.data(), node(l, 0), 1 << l, size >> (l + 1));
+            swap(V, W);
+        }
+
+        // the discarded levels, one subtree at a time
+        if (lowLevel > 0) {
+            int subSize = 1 << lowLevel;
+            Parallel::forRange(0, size >> lowLevel, threadN, [this, &V, &W, subSize](int lo, int hi) {
+                vector<unsigned> local;
+                vector<size_t> localOffset;
+                Scratch scratch;
+                for (int i = lo; i < hi; i++) {
+                    if (i * subSize >= N)
+                        break;
+                    buildSubtree(i, local, localOffset, scratch);
+                    unsigned* v = V.data() + size_t(i) * subSize;
+                    unsigned* w = W.data() + size_t(i) * subSize;
+                    for (int l = lowLevel - 1; l >= 0; l--) {
+                        descendLevel(v, w, local.data() + localOffset[l], 1 << l, 0, subSize >> (l + 1), scratch);
+                        swap(v, w);
+                    }
+                }
+            });
+            if (lowLevel & 1)
+                swap(V, W);                         // the results of odd levels are in W
+        }
+
+        vector<int> res(N);
+        for (int i = 0; i < N; i++)
+            res[i] = int(Montgomery::normalize(V[i]));
+        return res;
+    }
+
+    // returns g such that g(X[i]) = Y[i] and deg(g) < N
+    vector<int> interpolate(const vector<int>& Y) const {
+        if (N == 0)
+            return{};
+
+        // c[i] = Y[i] / P'(X[i])
+        auto P = polynomial();
+        vector<int> dP(N);
+        for (int i = 1; i <= N; i++)
+            dP[i - 1] = int(1ll * i * P[i] % mod);
+        auto d = evaluate(dP);
+
+        vector<unsigned> R(size), S(size);
+        {
+            vector<int> prefix(N + 1);
+            prefix[0] = 1;
+            for (int i = 0; i < N; i++)
+                prefix[i + 1] = int(1ll * prefix[i] * d[i] % mod);
+            long long inv = Montgomery::modInv(prefix[N]);
+            for (int i = N - 1; i >= 0; i--) {
+                R[i] = unsigned(inv * prefix[i] % mod * Y[i] % mod);
+                inv = inv * d[i] % mod;
+            }
+        }
+
+        // the discarded levels, one subtree at a time
+        if (lowLevel > 0) {
+            int subSize = 1 << lowLevel;
+            Parallel::forRange(0, size >> lowLevel, threadN, [this, &R, &S, subSize](int lo, int hi) {
+                vector<unsigned> local;
+                vector<size_t> localOffset;
+                Scratch scratch;
+                for (int i = lo; i < hi; i++) {
+                    if (i * subSize >= N)
+                        break;
+                    buildSubtree(i, local, localOffset, scratch);
+                    unsigned* r = R.data() + size_t(i) * subSize;
+                    unsigned* s = S.data() + size_t(i) * subSize;
+                    for (int l = 0; l < lowLevel; l++) {
+                        ascendLevel(r, s, local.data() + localOffset[l], 1 << l, 0, subSize >> (l + 1), scratch);
+                        swap(r, s);
+                    }
+                }
+            });
+            if (lowLevel & 1)
+                swap(R, S);                         // the results of odd levels are in S
+        }
+
+        for (int l = lowLevel; l < logSize; l++) {
+            ascendLevelParallel(R.data(), S.data(), node(l, 0), 1 << l, size >> (l + 1));
+            swap(R, S);
+        }
+
+        // g(x) = x^(size-1) * R(1/x)
+        vector<int> res(N);
+        for (int i = 0; i < N; i++)
+            res[i] = int(Montgomery::normalize(R[size - 1 - i]));
+        return res;
+    }
+
+    // bytes of the stored tree
+    size_t memoryUsage() const {
+        return arena.size() * sizeof(unsigned);
+    }
+
+private:
+    struct Scratch {
+        vector<unsigned> A, B, C, D;
+
+        void reserve(int n) {
+            if (int(A.size()) < n) {
+                A.resize(n);
+                B.resize(n);
+                C.resize(n);
+                D.resize(n);
+            }
+        }
+    };
+
+    unsigned* node(int level, int i) {
+        return arena.data() + offset[level] + size_t(i) * ((size_t(1) << level) + 1);
+    }
+
+    const unsigned* node(int level, int i) const {
+        return arena.data() + offset[level] + size_t(i) * ((size_t(1) << level) + 1);
+    }
+
+    // builds levels [0, lowLevel] of the i-th subtree into 'local'
+    void buildSubtree(int i, vector<unsigned>& local, vector<size_t>& localOffset, Scratch& scratch) const {
+        int subSize = 1 << lowLevel;
+        localOffset.assign(lowLevel + 2, 0);
+        for (int l = 0; l <= lowLevel; l++)
+            localOffset[l + 1] = localOffset[l] + size_t(subSize >> l) * ((size_t(1) << l) + 1);
+        local.resize(localOffset[lowLevel + 1]);
+
+        // leaves
+        unsigned* leaf = local.data();
+        for (int j = 0, k = i * subSize; j < subSize; j++, k++) {
+            if (k < N) {
+                leaf[2 * j] = 1;
+                leaf[2 * j + 1] = X[k] ? unsigned(mod - X[k]) : 0u;
+            } else {
+                leaf[2 * j] = 0;
+                leaf[2 * j + 1] = 1;
+            }
+        }
+
+        for (int l = 0; l < lowLevel; l++)
+            multiplyLevel(local.data() + localOffset[l], local.data() + localOffset[l + 1], 1 << l, 0, subSize >> (l + 1), scratch);
+    }
+
+    //--- level operations, nodes [first, last) of the parent level (2s points)
+
+    // parent = Q_left * Q_right
+    static void multiplyLevel(const unsigned* child, unsigned* parent, int s, int first, int last, Scratch& scratch) {
+        if (s <= NAIVE_SIZE) {
+            for (int i = first; i < last; i++) {
+                const unsigned* a = child + size_t(2 * i) * (s + 1);
+                const unsigned* b = a + (s + 1);
+                unsigned* c = parent + size_t(i) * (2 * s + 1);
+                for (int t = 0; t <= 2 * s; t++) {
+                    unsigned long long sum = 0;
+                    for (int j = max(0, t - s); j <= min(t, s); j++)
+                        sum += 1ull * a[j] * b[t - j] % mod;
+                    c[t] = unsigned(sum % mod);
+                }
+            }
+            return;
+        }
+
+        int n = 2 * s;
+        scratch.reserve(n);
+        unsigned* A = scratch.A.data();
+        unsigned* B = scratch.B.data();
+        for (int i = first; i < last; i++) {
+            const unsigned* a = child + size_t(2 * i) * (s + 1);
+            const unsigned* b = a + (s + 1);
+            unsigned* c = parent + size_t(i) * (2 * s + 1);
+
+            copy(a, a + s + 1, A);
+            fill(A + s + 1, A + n, 0u);
+            copy(b, b + s + 1, B);
+            fill(B + s + 1, B + n, 0u);
+            NTTEngine::ntt(A, n);
+            NTTEngine::ntt(B, n);
+            NTTEngine::multiplyPointwise(A, B, A, n);
+            NTTEngine::nttInv(A, n);
+
+            // y^2s wraps around to y^0
+            unsigned top = unsigned(1ull * a[s] * b[s] % mod);
+            for (int t = 0; t < n; t++)
+                c[t] = Montgomery::normalize(A[t]);
+            c[0] = (c[0] + mod - top) % mod;
+            c[n] = top;
+        }
+    }
+
+    // V (2s values per parent) -> W (s values per child)
+    static void descendLevel(const unsigned* V, unsigned* W, const unsigned* child, int s, int first, int last, Scratch& scratch) {
+        if (s <= NAIVE_SIZE) {
+            for (int i = first; i < last; i++) {
+                const unsigned* v = V + size_t(i) * (2 * s);
+                const unsigned* qL = child + size_t(2 * i) * (s + 1);
+                const unsigned* qR = qL + (s + 1);
+                unsigned* wL = W + size_t(i) * (2 * s);
+                unsigned* wR = wL + s;
+                for (int k = 0; k < s; k++) {
+                    unsigned long long sumL = 0, sumR = 0;
+                    for (int j = 0; j <= s; j++) {
+                        sumL += 1ull * v[s + k - j] * qR[j] % mod;
+                        sumR += 1ull * v[s + k - j] * qL[j] % mod;
+                    }
+                    wL[k] = unsigned(sumL % mod);
+                    wR[k] = unsigned(sumR % mod);
+                }
+            }
+            return;
+        }
+
+        int n = 2 * s;
+        scratch.reserve(n);
+        unsigned* A = scratch.A.data();
+        unsigned* B = scratch.B.data();
+        unsigned* C = scratch.C.data();
+        for (int i = first; i < last; i++) {
+            const unsigned* v = V + size_t(i) * (2 * s);
+            const unsigned* qL = child + size_t(2 * i) * (s + 1);
+            const unsigned* qR = qL + (s + 1);
+            unsigned* wL = W + size_t(i) * (2 * s);
+            unsigned* wR = wL + s;
+
+            copy(v, v + n, A);
+            NTTEngine::ntt(A, n);
+
+            copy(qR, qR + s + 1, B);
+            fill(B + s + 1, B + n, 0u);
+            NTTEngine::ntt(B, n);
+            NTTEngine::multiplyPointwise(A, B, B, n);
+            NTTEngine::nttInv(B, n);
+
+            copy(qL, qL + s + 1, C);
+            fill(C + s + 1, C + n, 0u);
+            NTTEngine::ntt(C, n);
+            NTTEngine::multiplyPointwise(A, C, C, n);
+            NTTEngine::nttInv(C, n);
+
+            // the wrapped-around part falls on [0, s)
+            copy(B + s, B + n, wL);
+            copy(C + s, C + n, wR);
+        }
+    }
+
+    // R (s values per child) -> S (2s values per parent), S = R_left * Q_right + R_right * Q_left
+    static void ascendLevel(const unsigned* R, unsigned* S, const unsigned* child, int s, int first, int last, Scratch& scratch) {
+        if (s <= NAIVE_SIZE) {
+            for (int i = first; i < last; i++) {
+                const unsigned* rL = R + size_t(i) * (2 * s);
+                const unsigned* rR = rL + s;
+                const unsigned* qL = child + size_t(2 * i) * (s + 1);
+                const unsigned* qR = qL + (s + 1);
+                unsigned* out = S + size_t(i) * (2 * s);
+                for (int t = 0; t < 2 * s; t++) {
+                    unsigned long long sum = 0;
+                    for (int j = max(0, t - s); j <= min(t, s - 1); j++)
+                        sum += (1ull * Montgomery::normalize(rL[j]) * qR[t - j] + 1ull * Montgomery::normalize(rR[j]) * qL[t - j]) % mod;
+                    out[t] = unsigned(sum % mod);
+                }
+            }
+            return;
+        }
+
+        int n = 2 * s;
+        scratch.reserve(n);
+        unsigned* A = scratch.A.data();
+        unsigned* B = scratch.B.data();
+        unsigned* C = scratch.C.data();
+        unsigned* D = scratch.D.data();
+        for (int i = first; i < last; i++) {
+            const unsigned* rL = R + size_t(i) * (2 * s);
+            const unsigned* rR = rL + s;
+            const unsigned* qL = child + size_t(2 * i) * (s + 1);
+            const unsigned* qR = qL + (s + 1);
+            unsigned* out = S + size_t(i) * (2 * s);
+
+            copy(rL, rL + s, A);
+            fill(A + s, A + n, 0u);
+            copy(qR, qR + s + 1, B);
+            fill(B + s + 1, B + n, 0u);
+            copy(rR, rR + s, C);
+            fill(C + s, C + n, 0u);
+            copy(qL, qL + s + 1, D);
+            fill(D + s + 1, D + n, 0u);
+            NTTEngine::ntt(A, n);
+            NTTEngine::ntt(B, n);
+            NTTEngine::ntt(C, n);
+            NTTEngine::ntt(D, n);
+            NTTEngine::multiplyPointwise(A, B, A, n);
+            NTTEngine::multiplyPointwise(C, D, C, n);
+            for (int t = 0; t < n; t++)
+                A[t] = Montgomery::add(A[t], C[t]);
+            NTTEngine::nttInv(A, n);
+
+            copy(A, A + n, out);
+        }
+    }
+
+    //--- parallel versions
+
+    void multiplyLevelParallel(const unsigned* child, unsigned* parent, int s, int count) const {
+        Parallel::forRange(0, count, threadN, [child, parent, s](int lo, int hi) {
+            Scratch scratch;
+            multiplyLevel(child, parent, s, lo, hi, scratch);
+        });
+    }
+
+    void descendLevelParallel(const unsigned* V, unsigned* W, const unsigned* child, int s, int count) const {
+        Parallel::forRange(0, count, threadN, [V, W, child, s](int lo, int hi) {
+            Scratch scratch;
+            descendLevel(V, W, child, s, lo, hi, scratch);
+        });
+    }
+
+    void ascendLevelParallel(const unsigned* R, unsigned* S, const unsigned* child, int s, int count) const {
+        Parallel::forRange(0, count, threadN, [R, S, child, s](int lo, int hi) {
+            Scratch scratch;
+            ascendLevel(R, S, child, s, lo, hi, scratch);
+        });
+    }
+};
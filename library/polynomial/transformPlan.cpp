@@ -0,0 +1,166 @@
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#include "fft.h"
+#include "convolution.h"
+#include "ntt.h"
+#include "transformPlan.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+#define MOD     998244353
+
+void testTransformPlan() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Transform Plan ------------------------" << endl;
+    {
+        for (int n = 1; n <= (1 << 12); n <<= 1) {
+            vector<pair<double, double>> in(n);
+            for (int i = 0; i < n; i++)
+                in[i] = make_pair(double(RandInt32::get() % 1000), double(RandInt32::get() % 1000));
+
+            FFTPlan plan(n);
+            for (int inverse = 0; inverse < 2; inverse++) {
+                vector<pair<double, double>> out1(n), out2(n);
+                FFT::fft(in, out1, inverse != 0);
+                plan.fft(in.data(), out2.data(), inverse != 0);
+                for (int i = 0; i < n; i++) {
+                    if (fabs(out1[i].first - out2[i].first) > 1e-6 || fabs(out1[i].second - out2[i].second) > 1e-6) {
+                        cout << "Mismatched at " << __LINE__ << ": n = " << n << ", i = " << i << endl;
+                    }
+                    assert(fabs(out1[i].first - out2[i].first) <= 1e-6 && fabs(out1[i].second - out2[i].second) <= 1e-6);
+                }
+
+                vector<pair<double, double>> data(in);
+                FFT::fft(data, plan, inverse != 0);
+                for (int i = 0; i < n; i++)
+                    assert(fabs(data[i].first - out2[i].first) <= 1e-9 && fabs(data[i].second - out2[i].second) <= 1e-9);
+            }
+        }
+
+        for (int i = 0; i < 100; i++) {
+            int N = RandInt32::get() % 2000 + 1;
+            int M = RandInt32::get() % 2000 + 1;
+            vector<int> x(N), h(M);
+            for (int j = 0; j < N; j++)
+                x[j] = RandInt32::get() % 1000;
+            for (int j = 0; j < M; j++)
+                h[j] = RandInt32::get() % 1000;
+
+            for (int reverseH = 0; reverseH < 2; reverseH++) {
+                auto& plan = FFTPlan::get(N + M - 1);
+                auto out1 = Convolution::convolute(x, h, reverseH != 0);
+                auto out2 = Convolution::convolute(x, h, plan, reverseH != 0);
+                if (out1 != out2) {
+                    cout << "Mismatched at " << __LINE__ << ": N = " << N << ", M = " << M << endl;
+                }
+                assert(out1 == out2);
+            }
+        }
+
+        for (int i = 0; i < 100; i++) {
+            int N = RandInt32::get() % 2000 + 1;
+            int M = RandInt32::get() % 2000 + 1;
+            vector<int> a(N), b(M);
+            for (int j = 0; j < N; j++)
+                a[j] = RandInt32::get() % MOD;
+            for (int j = 0; j < M; j++)
+                b[j] = RandInt32::get() % MOD;
+
+            for (int reverseB = 0; reverseB < 2; reverseB++) {
+                auto& plan = NTTPlan<MOD, 3>::get(N + M - 1);
+                auto out1 = NTT<MOD, 3>::multiply(a, b, reverseB != 0);
+                auto out2 = NTT<MOD, 3>::multiply(a, b, plan, reverseB != 0);
+                if (out1 != out2) {
+                    cout << "Mismatched at " << __LINE__ << ": N = " << N << ", M = " << M << endl;
+                }
+                assert(out1 == out2);
+            }
+
+            auto& plan = NTTPlan<MOD, 3>::get(2 * N - 1);
+            assert((NTT<MOD, 3>::square(a) == NTT<MOD, 3>::square(a, plan)));
+        }
+
+        // same transform as NTT::ntt()
+        for (int n = 1; n <= (1 << 12); n <<= 1) {
+            vector<int> a(n);
+            for (int j = 0; j < n; j++)
+                a[j] = RandInt32::get() % MOD;
+
+            NTTPlan<MOD, 3> plan(n);
+            for (int inverse = 0; inverse < 2; inverse++) {
+                vector<int> out1(a), out2(a);
+                NTT<MOD, 3>::ntt(out1, inverse != 0);
+                plan.ntt(out2.data(), inverse != 0);
+                assert(out1 == out2);
+            }
+        }
+    }
+    cout << "OK!" << endl;
+    {
+        cout << "*** Speed & scratch allocation test ***" << endl;
+
+        const int T = 10;
+        for (int n = (1 << 12); n <= (1 << 18); n <<= 3) {
+            vector<int> a(n), b(n), out(2 * n - 1);
+            for (int j = 0; j < n; j++) {
+                a[j] = RandInt32::get() % MOD;
+                b[j] = RandInt32::get() % 1000;
+            }
+            vector<int> x(n), h(n);
+            for (int j = 0; j < n; j++) {
+                x[j] = RandInt32::get() % 1000;
+                h[j] = RandInt32::get() % 1000;
+            }
+
+            auto& nttPlan = NTTPlan<MOD, 3>::get(2 * n - 1);
+            auto& fftPlan = FFTPlan::get(2 * n - 1);
+            cout << "N = " << n << ", " << T << " calls" << endl;
+
+            // the plans keep their scratch buffers between calls
+            const int* nttScratch = nttPlan.buffer(0);
+            const FFTPlan::Complex* fftScratch = fftPlan.buffer(0);
+
+            cout << "  NTT::multiply()                  : ";
+            PROFILE_HI_START(0);
+            for (int i = 0; i < T; i++)
+                NTT<MOD, 3>::multiply(a, b);
+            PROFILE_HI_STOP(0);
+
+            long long alloc = AlignedBuffer<int>::allocationCount();
+            cout << "  NTT::multiply() with NTTPlan     : ";
+            PROFILE_HI_START(1);
+            for (int i = 0; i < T; i++)
+                NTT<MOD, 3>::multiply(a.data(), n, b.data(), n, out.data(), nttPlan);
+            PROFILE_HI_STOP(1);
+            assert(nttPlan.buffer(0) == nttScratch);
+            cout << "    scratch allocations/call : " << double(AlignedBuffer<int>::allocationCount() - alloc) / T << endl;
+
+            cout << "  Convolution::convolute()         : ";
+            PROFILE_HI_START(2);
+            for (int i = 0; i < T; i++)
+                Convolution::convolute(x, h);
+            PROFILE_HI_STOP(2);
+
+            alloc = AlignedBuffer<FFTPlan::Complex>::allocationCount();
+            cout << "  Convolution::convolute() with FFTPlan : ";
+            PROFILE_HI_START(3);
+            for (int i = 0; i < T; i++)
+                Convolution::convolute(x.data(), n, h.data(), n, out.data(), fftPlan);
+            PROFILE_HI_STOP(3);
+            assert(fftPlan.buffer(0) == fftScratch);
+            cout << "    scratch allocations/call : " << double(AlignedBuffer<FFTPlan::Complex>::allocationCount() - alloc) / T << endl;
+        }
+    }
+}
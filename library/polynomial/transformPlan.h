@@ -0,0 +1,302 @@
+#pragma once
+
+#include <memory>
+
+#ifndef M_PI
+#define M_PI       3.14159265358979323846   // pi
+#endif
+
+/*
+  Transform plans (FFTW style)
+
+  A plan keeps everything that depends only on the transform size:
+    - bit-reversal table
+    - roots of unity (w[m + j] = w_2m^j, the same layout as FastNTT)
+    - aligned scratch buffers
+
+  <How to use>
+    1) one size
+        FFTPlan plan(1 << 16);
+        plan.fft(data);                 // in-place, data has plan.size() elements
+
+    2) many sizes (ex: Newton iteration)
+        auto& plan = NTTPlan<998244353, 3>::get(size);  // cached per size
+        NTT<998244353, 3>::multiply(a, b, plan);        // no root recomputation, no scratch allocation
+*/
+
+// 64-byte aligned buffer, it doesn't initialize elements
+template <typename T>
+struct AlignedBuffer {
+    static const int ALIGNMENT = 64;
+
+    AlignedBuffer() : N(0), raw(nullptr), ptr(nullptr) {
+    }
+
+    explicit AlignedBuffer(int n) : N(0), raw(nullptr), ptr(nullptr) {
+        resize(n);
+    }
+
+    ~AlignedBuffer() {
+        delete[] raw;
+    }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator =(const AlignedBuffer&) = delete;
+
+    void resize(int n) {
+        if (n == N)
+            return;
+
+        delete[] raw;
+        raw = new char[sizeof(T) * n + ALIGNMENT];
+        allocationCount()++;
+        ptr = reinterpret_cast<T*>((reinterpret_cast<size_t>(raw) + ALIGNMENT - 1) & ~size_t(ALIGNMENT - 1));
+        N = n;
+    }
+
+    int size() const {
+        return N;
+    }
+
+    T* data() {
+        return ptr;
+    }
+
+    const T* data() const {
+        return ptr;
+    }
+
+    T& operator [](int i) {
+        return ptr[i];
+    }
+
+    const T& operator [](int i) const {
+        return ptr[i];
+    }
+
+    // the number of AlignedBuffer<T> allocations so far, for tests (plans allocate only in init())
+    static long long& allocationCount() {
+        static long long count = 0;
+        return count;
+    }
+
+private:
+    int N;
+    char* raw;
+    T* ptr;
+};
+
+//--- FFT plan (complex number = pair<double, double>, the same as FFT)
+
+struct FFTPlan {
+    typedef pair<double, double> Complex;
+
+    static const int SCRATCH_COUNT = 2;
+
+    int N;
+    int logN;
+    vector<int> rev;                        // bit reversal
+    vector<Complex> w;                      // w[m + j] = e^(-i * PI * j / m), 0 <= j < m
+    AlignedBuffer<Complex> scratch[SCRATCH_COUNT];
+
+    explicit FFTPlan(int n = 0) : N(0), logN(0) {
+        if (n > 0)
+            init(n);
+    }
+
+    // n = 2^k
+    void init(int n) {
+        N = n;
+        logN = 0;
+        while ((1 << logN) < n)
+            logN++;
+
+        rev.assign(n, 0);
+        for (int i = 1; i < n; i++)
+            rev[i] = (rev[i >> 1] >> 1) | ((i & 1) << (logN - 1));
+
+        w.assign(max(n, 2), Complex(0.0, 0.0));
+        for (int m = 1; m < n; m <<= 1) {
+            for (int j = 0; j < m; j++)
+                w[m + j] = Complex(cos(M_PI * j / m), -sin(M_PI * j / m));
+        }
+
+        for (int i = 0; i < SCRATCH_COUNT; i++)
+            scratch[i].resize(n);
+    }
+
+    int size() const {
+        return N;
+    }
+
+    Complex* buffer(int i) {
+        return scratch[i].data();
+    }
+
+    // in-place, data[0..N-1]
+    void fft(Complex* data, bool inverse = false) const {
+        for (int i = 0; i < N; i++) {
+            if (i < rev[i])
+                swap(data[i], data[rev[i]]);
+        }
+        butterfly(data, inverse);
+    }
+
+    // out[0..N-1] = FFT(in[0..N-1]), in and out must not overlap
+    void fft(const Complex* in, Complex* out, bool inverse = false) const {
+        for (int i = 0; i < N; i++)
+            out[rev[i]] = in[i];
+        butterfly(out, inverse);
+    }
+
+    // plan cache, one plan per size
+    static FFTPlan& get(int n) {
+        static vector<unique_ptr<FFTPlan>> plans(32);
+
+        int k = 0;
+        while ((1 << k) < n)
+            k++;
+        if (!plans[k])
+            plans[k].reset(new FFTPlan(1 << k));
+        return *plans[k];
+    }
+
+private:
+    void butterfly(Complex* data, bool inverse) const {
+        for (int m = 1; m < N; m <<= 1) {
+            for (int i = 0; i < N; i += (m << 1)) {
+                Complex* x = data + i;
+                Complex* y = data + i + m;
+                const Complex* r = w.data() + m;
+                for (int j = 0; j < m; j++) {
+                    double wr = r[j].first;
+                    double wi = inverse ? -r[j].second : r[j].second;
+                    double tr = y[j].first * wr - y[j].second * wi;
+                    double ti = y[j].first * wi + y[j].second * wr;
+                    y[j].first = x[j].first - tr;
+                    y[j].second = x[j].second - ti;
+                    x[j].first += tr;
+                    x[j].second += ti;
+                }
+            }
+        }
+
+        if (inverse) {
+            double inv = 1.0 / N;
+            for (int i = 0; i < N; i++) {
+                data[i].first *= inv;
+                data[i].second *= inv;
+            }
+        }
+    }
+};
+
+//--- NTT plan (the same transform as NTT<mod, root>::ntt())
+
+template <int mod, int root>
+struct NTTPlan {
+    static const int SCRATCH_COUNT = 2;
+
+    int N;
+    int logN;
+    int nInv;
+    vector<int> rev;                        // bit reversal
+    vector<int> w, wInv;                    // w[m + j] = w_2m^j, 0 <= j < m
+    AlignedBuffer<int> scratch[SCRATCH_COUNT];
+
+    explicit NTTPlan(int n = 0) : N(0), logN(0), nInv(1) {
+        if (n > 0)
+            init(n);
+    }
+
+    // n = 2^k
+    void init(int n) {
+        N = n;
+        logN = 0;
+        while ((1 << logN) < n)
+            logN++;
+        nInv = modPow(n, mod - 2);
+
+        rev.assign(n, 0);
+        for (int i = 1; i < n; i++)
+            rev[i] = (rev[i >> 1] >> 1) | ((i & 1) << (logN - 1));
+
+        w.assign(max(n, 2), 0);
+        wInv.assign(max(n, 2), 0);
+        for (int m = 1; m < n; m <<= 1) {
+            int base = modPow(root, (mod - 1) / (2 * m));
+            int baseInv = modPow(base, mod - 2);
+            w[m] = wInv[m] = 1;
+            for (int j = 1; j < m; j++) {
+                w[m + j] = int(1ll * w[m + j - 1] * base % mod);
+                wInv[m + j] = int(1ll * wInv[m + j - 1] * baseInv % mod);
+            }
+        }
+
+        for (int i = 0; i < SCRATCH_COUNT; i++)
+            scratch[i].resize(n);
+    }
+
+    int size() const {
+        return N;
+    }
+
+    int* buffer(int i) {
+        return scratch[i].data();
+    }
+
+    // in-place, a[0..N-1], 0 <= a[i] < mod
+    void ntt(int* a, bool inverse = false) const {
+        for (int i = 0; i < N; i++) {
+            if (i < rev[i])
+                swap(a[i], a[rev[i]]);
+        }
+
+        const int* tw = inverse ? wInv.data() : w.data();
+        for (int m = 1; m < N; m <<= 1) {
+            for (int i = 0; i < N; i += (m << 1)) {
+                int* x = a + i;
+                int* y = a + i + m;
+                const int* r = tw + m;
+                for (int j = 0; j < m; j++) {
+                    int t = int(1ll * y[j] * r[j] % mod);
+                    y[j] = x[j] - t;
+                    if (y[j] < 0)
+                        y[j] += mod;
+                    x[j] += t;
+                    if (x[j] >= mod)
+                        x[j] -= mod;
+                }
+            }
+        }
+
+        if (inverse) {
+            for (int i = 0; i < N; i++)
+                a[i] = int(1ll * a[i] * nInv % mod);
+        }
+    }
+
+    // plan cache, one plan per size
+    static NTTPlan& get(int n) {
+        static vector<unique_ptr<NTTPlan>> plans(32);
+
+        int k = 0;
+        while ((1 << k) < n)
+            k++;
+        if (!plans[k])
+            plans[k].reset(new NTTPlan(1 << k));
+        return *plans[k];
+    }
+
+private:
+    static int modPow(int x, int n) {
+        long long t = x % mod;
+        long long res = 1;
+        for (; n > 0; n >>= 1) {
+            if (n & 1)
+                res = res * t % mod;
+            t = t * t % mod;
+        }
+        return int(res);
+    }
+};
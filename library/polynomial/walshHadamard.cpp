@@ -5,6 +5,7 @@ using namespace std;
 #include "walshHadamard.h"
 #include "walshHadamardMod.h"
 #include "walshHadamardMod3xor.h"
+#include "walshHadamardFast.h"
 
 /////////// For Testing ///////////////////////////////////////////////////////
 
@@ -153,6 +154,26 @@ static vector<T> slowAndMod(const vector<T>& A, const vector<T>& B) {
 }
 
 
+static vector<int> slowSubsetConvolutionMod(const vector<int>& A, const vector<int>& B) {
+    int size = 1;
+    while (size < int(A.size()) || size < int(B.size()))
+        size <<= 1;
+
+    vector<int> C(size);
+    for (int x = 0; x < size; x++) {
+        long long sum = 0;
+        for (int i = x; ; i = (i - 1) & x) {
+            if (i < int(A.size()) && (x ^ i) < int(B.size()))
+                sum = (sum + 1ll * A[i] * B[x ^ i]) % MOD;
+            if (!i)
+                break;
+        }
+        C[x] = int(sum);
+    }
+
+    return C;
+}
+
 //-----------------------------------------------------------------------------
 // https://www.codechef.com/problems/MDSWIN
 // -> https://discuss.codechef.com/t/mdswin-editorial/44120
@@ -268,6 +289,150 @@ void testWalshHadamard() {
             cout << "Mismatched : " << ans2 << ", " << gt2 << endl;
         assert(ans2 == gt2);
     }
+    // cache-blocked / AVX2 / multithreaded transforms
+    {
+        for (int N : { 1, 2, 3, 5, 8, 17, 100, 1000 }) {
+            vector<long long> A(N), B(N);
+            vector<int> C(N), D(N);
+            vector<double> E(N), F(N);
+            for (int i = 0; i < N; i++) {
+                A[i] = RandInt32::get() % 10000 - 5000;
+                B[i] = RandInt32::get() % 10000 - 5000;
+                C[i] = RandInt32::get() % MOD;
+                D[i] = RandInt32::get() % MOD;
+                E[i] = double(A[i]);
+                F[i] = double(B[i]);
+            }
+
+            assert(FWHTFast<long long>::fastXor(A, B) == slowXor(A, B));
+            assert(FWHTFast<long long>::fastOr(A, B) == slowOr(A, B));
+            assert(FWHTFast<long long>::fastAnd(A, B) == slowAnd(A, B));
+            assert(FWHTFast<double>::fastXor(E, F) == slowXor(E, F));
+            assert(FWHTFast<double>::fastOr(E, F) == slowOr(E, F));
+            assert(FWHTModFast<MOD>::fastXor(C, D) == slowXorMod(C, D));
+            assert(FWHTModFast<MOD>::fastOr(C, D) == slowOrMod(C, D));
+            assert(FWHTModFast<MOD>::fastAnd(C, D) == slowAndMod(C, D));
+
+            assert(FWHTModFast<MOD>::subsetConvolution(C, D) == slowSubsetConvolutionMod(C, D));
+        }
+
+        // large sizes (outer levels), threads
+        for (int logN : { 12, 13, 16, 18 }) {
+            int N = 1 << logN;
+            vector<int> A(N), B(N);
+            for (int i = 0; i < N; i++) {
+                A[i] = RandInt32::get() % MOD;
+                B[i] = RandInt32::get() % MOD;
+            }
+            auto gtXor = FWHTMod<int, MOD>::fastXor(A, B);
+            auto gtOr = FWHTMod<int, MOD>::fastOr(A, B);
+            auto gtAnd = FWHTMod<int, MOD>::fastAnd(A, B);
+            for (int threadN = 1; threadN <= 3; threadN++) {
+                assert(FWHTModFast<MOD>::fastXor(A, B, threadN) == gtXor);
+                assert(FWHTModFast<MOD>::fastOr(A, B, threadN) == gtOr);
+                assert(FWHTModFast<MOD>::fastAnd(A, B, threadN) == gtAnd);
+            }
+
+            vector<int> P(N);
+            for (int i = 0; i < N; i++)
+                P[i] = RandInt32::get() % 100;
+            auto Q = P;
+            FWHTFast<int>::transformXor(Q.data(), N, false, 2);
+            FWHTFast<int>::transformXor(Q.data(), N, true, 2);
+            assert(Q == P);
+            FWHTFast<int>::transformOr(Q.data(), N, false, 2);
+            FWHTFast<int>::transformOr(Q.data(), N, true, 2);
+            assert(Q == P);
+            FWHTFast<int>::transformAnd(Q.data(), N, false, 2);
+            FWHTFast<int>::transformAnd(Q.data(), N, true, 2);
+            assert(Q == P);
+
+            vector<long long> E(A.begin(), A.end()), F(B.begin(), B.end());
+            assert(FWHTFast<long long>::fastXor(E, F, 3) == FWHT<long long>::fastXor(E, F));
+        }
+
+        // mod > 2^30, a + b overflows int
+        for (int N : { 1, 2, 4, 8, 64, 256 }) {
+            const int BIG_MOD = 2147483647;
+            vector<int> A(N), B(N);
+            for (int i = 0; i < N; i++) {
+                A[i] = BIG_MOD - 1 - RandInt32::get() % 1000;
+                B[i] = BIG_MOD - 1 - RandInt32::get() % 1000;
+            }
+            vector<long long> gt(N);
+            for (int i = 0; i < N; i++) {
+                for (int j = 0; j < N; j++)
+                    gt[i ^ j] = (gt[i ^ j] + 1ll * A[i] * B[j]) % BIG_MOD;
+            }
+            auto C = FWHTModFast<BIG_MOD>::fastXor(A, B);
+            assert(vector<long long>(C.begin(), C.end()) == gt);
+
+            // subset convolution, the scalar rank products
+            vector<long long> gtSubset(N);
+            for (int x = 0; x < N; x++) {
+                for (int i = x; ; i = (i - 1) & x) {
+                    gtSubset[x] = (gtSubset[x] + 1ll * A[i] * B[x ^ i]) % BIG_MOD;
+                    if (i == 0)
+                        break;
+                }
+            }
+            auto S = FWHTModFast<BIG_MOD>::subsetConvolution(A, B);
+            assert(vector<long long>(S.begin(), S.end()) == gtSubset);
+        }
+
+        for (int logN : { 11, 16 }) {
+            int N = 1 << logN;
+            vector<int> A(N), B(N);
+            for (int i = 0; i < N; i++) {
+                A[i] = RandInt32::get() % MOD;
+                B[i] = RandInt32::get() % MOD;
+            }
+            auto gt = FWHTModFast<MOD>::subsetConvolution(A, B, 1);
+            assert(FWHTModFast<998244353>::subsetConvolution(A, B, 3) == FWHTModFast<998244353>::subsetConvolution(A, B, 1));
+            assert(FWHTModFast<MOD>::subsetConvolution(A, B, 3) == gt);
+            if (logN == 11)
+                assert(gt == slowSubsetConvolutionMod(A, B));
+        }
+    }
 
     cout << "OK!" << endl;
+    {
+        cout << "*** Speed test: FWHTMod vs FWHTModFast ***" << endl;
+
+        int N = 1 << 22;
+        vector<int> A(N), B(N);
+        for (int i = 0; i < N; i++) {
+            A[i] = RandInt32::get() % MOD;
+            B[i] = RandInt32::get() % MOD;
+        }
+
+        vector<int> ans1, ans2, ans3;
+        cout << "  FWHTMod::fastXor(), N = 2^22" << endl;
+        PROFILE_HI_START(0);
+        ans1 = FWHTMod<int, MOD>::fastXor(A, B);
+        PROFILE_HI_STOP(0);
+
+        cout << "  FWHTModFast::fastXor(), N = 2^22, 1 thread" << endl;
+        PROFILE_HI_START(1);
+        ans2 = FWHTModFast<MOD>::fastXor(A, B, 1);
+        PROFILE_HI_STOP(1);
+
+        cout << "  FWHTModFast::fastXor(), N = 2^22, all threads" << endl;
+        PROFILE_HI_START(2);
+        ans3 = FWHTModFast<MOD>::fastXor(A, B, Parallel::threadCount());
+        PROFILE_HI_STOP(2);
+
+        assert(ans1 == ans2 && ans1 == ans3);
+
+        int M = 1 << 20;
+        vector<int> C(M), D(M);
+        for (int i = 0; i < M; i++) {
+            C[i] = RandInt32::get() % MOD;
+            D[i] = RandInt32::get() % MOD;
+        }
+        cout << "  FWHTModFast::subsetConvolution(), N = 2^20" << endl;
+        PROFILE_HI_START(3);
+        FWHTModFast<MOD>::subsetConvolution(C, D, Parallel::threadCount());
+        PROFILE_HI_STOP(3);
+    }
 }
@@ -0,0 +1,675 @@
+#pragma once
+
+#include <type_traits>
+#include "../common/cpuFeature.h"
+#include "../common/parallel.h"
+#include "ntt_avx2.h"
+
+/*
+  Cache-blocked, AVX2, multithreaded Walsh-Hadamard / subset transforms
+
+  - the levels with step < BLOCK_SIZE are done block by block (a block stays in L1),
+    and the levels inside one AVX2 register are done with lane shuffles
+  - the levels with step >= BLOCK_SIZE are done 3 levels (radix-8) per pass over the memory
+  - both parts are split across threads when n >= PARALLEL_MIN_SIZE
+  - AVX2 is selected at runtime (CpuFeature::hasAVX2()), there is a scalar fallback
+
+  transforms (in-place, n = 2^k)
+    XOR : (u, v) -> (u + v, u - v)                  inverse : the same + divide by n
+    OR  : F(x) = SUM_{i subset of x} A[i]            inverse : Mobius transform
+    AND : F(x) = SUM_{i superset of x} A[i]          inverse : Mobius transform
+
+  <How to use>
+    auto C = FWHTFast<long long>::fastXor(A, B);
+    auto C = FWHTModFast<1000000007>::fastOr(A, B);
+    FWHTFast<int>::transformOr(F.data(), 1 << 24, false);   // sum over subsets (zeta transform)
+    auto H = FWHTModFast<998244353>::subsetConvolution(A, B);
+*/
+
+//--- element operations
+
+// 32-bit integers, wrapping arithmetic
+template <typename T>
+struct FWHTOpsInt32 {
+    static const bool SIMD = true;
+    static const int LANES = 8;
+
+    static T add(T a, T b) {
+        return T(unsigned(a) + unsigned(b));
+    }
+
+    static T sub(T a, T b) {
+        return T(unsigned(a) - unsigned(b));
+    }
+
+    TARGET_AVX2
+    static __m256i addV(__m256i a, __m256i b) {
+        return _mm256_add_epi32(a, b);
+    }
+
+    TARGET_AVX2
+    static __m256i subV(__m256i a, __m256i b) {
+        return _mm256_sub_epi32(a, b);
+    }
+
+    // swaps lanes i and i ^ S
+    template <int S>
+    TARGET_AVX2
+    static __m256i swapLanes(__m256i x) {
+        if (S == 1)
+            return _mm256_shuffle_epi32(x, 0xB1);
+        else if (S == 2)
+            return _mm256_shuffle_epi32(x, 0x4E);
+        else
+            return _mm256_permute2x128_si256(x, x, 0x01);
+    }
+
+    // all bits of lane i are set if (i & S) != 0
+    template <int S>
+    TARGET_AVX2
+    static __m256i highLanes() {
+        return _mm256_setr_epi32(0, (1 & S) ? -1 : 0, (2 & S) ? -1 : 0, (3 & S) ? -1 : 0,
+                                 (4 & S) ? -1 : 0, (5 & S) ? -1 : 0, (6 & S) ? -1 : 0, (7 & S) ? -1 : 0);
+    }
+
+    // a[0..count) /= n
+    static void scale(T* a, int count, int n) {
+        for (int i = 0; i < count; i++)
+            a[i] /= n;
+    }
+};
+
+// 64-bit integers, wrapping arithmetic
+template <typename T>
+struct FWHTOpsInt64 {
+    static const bool SIMD = true;
+    static const int LANES = 4;
+
+    static T add(T a, T b) {
+        return T((unsigned long long)a + (unsigned long long)b);
+    }
+
+    static T sub(T a, T b) {
+        return T((unsigned long long)a - (unsigned long long)b);
+    }
+
+    TARGET_AVX2
+    static __m256i addV(__m256i a, __m256i b) {
+        return _mm256_add_epi64(a, b);
+    }
+
+    TARGET_AVX2
+    static __m256i subV(__m256i a, __m256i b) {
+        return _mm256_sub_epi64(a, b);
+    }
+
+    template <int S>
+    TARGET_AVX2
+    static __m256i swapLanes(__m256i x) {
+        if (S == 1)
+            return _mm256_shuffle_epi32(x, 0x4E);
+        else
+            return _mm256_permute2x128_si256(x, x, 0x01);
+    }
+
+    template <int S>
+    TARGET_AVX2
+    static __m256i highLanes() {
+        return _mm256_setr_epi64x(0, (1 & S) ? -1 : 0, (2 & S) ? -1 : 0, (3 & S) ? -1 : 0);
+    }
+
+    // a[0..count) /= n
+    static void scale(T* a, int count, int n) {
+        for (int i = 0; i < count; i++)
+            a[i] /= n;
+    }
+};
+
+// 0 <= value < mod < 2^31
+template <int mod>
+struct FWHTOpsMod {
+    static const bool SIMD = true;
+    static const int LANES = 8;
+
+    // unsigned, a + b can be 2^31 or more
+    static int add(int a, int b) {
+        unsigned t = unsigned(a) + unsigned(b);
+        return int(t >= unsigned(mod) ? t - unsigned(mod) : t);
+    }
+
+    static int sub(int a, int b) {
+        unsigned t = unsigned(a) - unsigned(b);
+        return int(t >= unsigned(mod) ? t + unsigned(mod) : t);
+    }
+
+    TARGET_AVX2
+    static __m256i addV(__m256i a, __m256i b) {
+        __m256i t = _mm256_add_epi32(a, b);
+        return _mm256_min_epu32(t, _mm256_sub_epi32(t, _mm256_set1_epi32(mod)));
+    }
+
+    TARGET_AVX2
+    static __m256i subV(__m256i a, __m256i b) {
+        __m256i t = _mm256_sub_epi32(a, b);
+        return _mm256_min_epu32(t, _mm256_add_epi32(t, _mm256_set1_epi32(mod)));
+    }
+
+    template <int S>
+    TARGET_AVX2
+    static __m256i swapLanes(__m256i x) {
+        return FWHTOpsInt32<int>::swapLanes<S>(x);
+    }
+
+    template <int S>
+    TARGET_AVX2
+    static __m256i highLanes() {
+        return FWHTOpsInt32<int>::highLanes<S>();
+    }
+
+    // a[0..count) *= n^-1
+    static void scale(int* a, int count, int n) {
+        long long t = n % mod, invN = 1;
+        for (int e = mod - 2; e > 0; e >>= 1) {
+            if (e & 1)
+                invN = invN * t % mod;
+            t = t * t % mod;
+        }
+        for (int i = 0; i < count; i++)
+            a[i] = int(a[i] * invN % mod);
+    }
+};
+
+// any other type (double, ...)
+template <typename T>
+struct FWHTOpsScalar {
+    static const bool SIMD = false;
+    static const int LANES = 1;
+
+    static T add(T a, T b) {
+        return a + b;
+    }
+
+    static T sub(T a, T b) {
+        return a - b;
+    }
+
+    // a[0..count) /= n
+    static void scale(T* a, int count, int n) {
+        for (int i = 0; i < count; i++)
+            a[i] /= n;
+    }
+};
+
+template <typename T>
+struct FWHTOpsSelector {
+    typedef typename conditional<is_integral<T>::value && sizeof(T) == 4, FWHTOpsInt32<T>,
+            typename conditional<is_integral<T>::value && sizeof(T) == 8, FWHTOpsInt64<T>,
+                                 FWHTOpsScalar<T>>::type>::type type;
+};
+
+//--- transform engine
+
+template <typename T, typename Ops>
+struct FWHTEngine {
+    enum TransformType {
+        XOR,
+        OR,
+        AND
+    };
+
+    static const int BLOCK_SIZE = 1 << 12;
+    static const int PARALLEL_MIN_SIZE = 1 << 16;
+
+    // threadN <= 0 : all hardware threads
+    template <int Type, bool Inverse>
+    static void transform(T* a, int n, int threadN = 1) {
+        if (n <= 1)
+            return;
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+        if (n < PARALLEL_MIN_SIZE)
+            threadN = 1;
+
+        if (Ops::SIMD && n >= Ops::LANES && CpuFeature::hasAVX2())
+            transformImpl<Type, Inverse>(a, n, threadN, integral_constant<bool, Ops::SIMD>());
+        else
+            transformImpl<Type, Inverse>(a, n, threadN, false_type());
+
+        if (Type == XOR && Inverse) {
+            Parallel::forRange(0, n, threadN, [a, n](int lo, int hi) {
+                Ops::scale(a + lo, hi - lo, n);
+            });
+        }
+    }
+
+private:
+    //--- scalar
+
+    template <int Type, bool Inverse>
+    static void butterfly(T& u, T& v) {
+        if (Type == XOR) {
+            T x = u;
+            u = Ops::add(x, v);
+            v = Ops::sub(x, v);
+        } else if (Type == OR) {
+            v = Inverse ? Ops::sub(v, u) : Ops::add(v, u);
+        } else {
+            u = Inverse ? Ops::sub(u, v) : Ops::add(u, v);
+        }
+    }
+
+    // levels [step, blockN) inside a[0..blockN)
+    template <int Type, bool Inverse>
+    static void blockScalar(T* a, int blockN, int step) {
+        for (; step < blockN; step <<= 1) {
+            for (int i = 0; i < blockN; i += (step << 1)) {
+                for (int j = i; j < i + step; j++)
+                    butterfly<Type, Inverse>(a[j], a[j + step]);
+            }
+        }
+    }
+
+    // levels [step, step * 2^levels) for units [lo, hi), unit = (group, j)
+    // - a row chunk of 2^levels * OUTER_CHUNK elements stays in L1
+    template <int Type, bool Inverse>
+    static void outerScalar(T* a, int step, int levels, int lo, int hi) {
+        const int OUTER_CHUNK = 256;
+        int cnt = 1 << levels;
+        for (int u = lo; u < hi; ) {
+            int j = u % step;
+            int len = min(min(hi - u, step - j), OUTER_CHUNK);
+            T* p = a + size_t(u / step) * (size_t(step) << levels) + j;
+            for (int d = 1; d < cnt; d <<= 1) {
+                for (int t = 0; t < cnt; t++) {
+                    if (t & d)
+                        continue;
+                    T* x = p + size_t(t) * step;
+                    T* y = p + size_t(t + d) * step;
+                    for (int k = 0; k < len; k++)
+                        butterfly<Type, Inverse>(x[k], y[k]);
+                }
+            }
+            u += len;
+        }
+    }
+
+    template <int Type, bool Inverse>
+    static void transformImpl(T* a, int n, int threadN, false_type) {
+        int blockN = min(n, int(BLOCK_SIZE));
+        Parallel::forRange(0, n / blockN, threadN, [a, blockN](int lo, int hi) {
+            for (int b = lo; b < hi; b++)
+                blockScalar<Type, Inverse>(a + size_t(b) * blockN, blockN, 1);
+        });
+
+        for (int step = blockN; step < n; ) {
+            int levels = 0;
+            while (levels < 3 && (step << levels) < n)
+                levels++;
+            Parallel::forRange(0, n >> levels, threadN, [a, step, levels](int lo, int hi) {
+                outerScalar<Type, Inverse>(a, step, levels, lo, hi);
+            });
+            step <<= levels;
+        }
+    }
+
+    //--- AVX2
+
+    TARGET_AVX2
+    static __m256i load(const T* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    TARGET_AVX2
+    static void store(T* p, __m256i x) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+    }
+
+    template <int Type, bool Inverse>
+    TARGET_AVX2
+    static void butterflyV(__m256i& u, __m256i& v) {
+        if (Type == XOR) {
+            __m256i x = u;
+            u = Ops::addV(x, v);
+            v = Ops::subV(x, v);
+        } else if (Type == OR) {
+            v = Inverse ? Ops::subV(v, u) : Ops::addV(v, u);
+        } else {
+            u = Inverse ? Ops::subV(u, v) : Ops::addV(u, v);
+        }
+    }
+
+    // one level inside a register, lanes i and i ^ S
+    template <int Type, bool Inverse, int S>
+    TARGET_AVX2
+    static __m256i levelInRegister(__m256i x) {
+        __m256i sw = Ops::template swapLanes<S>(x);
+        __m256i hi = Ops::template highLanes<S>();
+        if (Type == XOR)
+            return _mm256_blendv_epi8(Ops::addV(x, sw), Ops::subV(sw, x), hi);
+        else if (Type == OR)
+            return _mm256_blendv_epi8(x, Inverse ? Ops::subV(x, sw) : Ops::addV(x, sw), hi);
+        else
+            return _mm256_blendv_epi8(Inverse ? Ops::subV(x, sw) : Ops::addV(x, sw), x, hi);
+    }
+
+    template <int Type, bool Inverse>
+    TARGET_AVX2
+    static void blockSIMD(T* a, int blockN) {
+        for (int i = 0; i < blockN; i += Ops::LANES) {
+            __m256i x = load(a + i);
+            x = levelInRegister<Type, Inverse, 1>(x);
+            x = levelInRegister<Type, Inverse, 2>(x);
+            if (Ops::LANES == 8)
+                x = levelInRegister<Type, Inverse, 4>(x);
+            store(a + i, x);
+        }
+
+        // two levels per pass
+        int step = Ops::LANES;
+        for (; (step << 1) < blockN; step <<= 2) {
+            for (int i = 0; i < blockN; i += (step << 2)) {
+                for (int j = i; j < i + step; j += Ops::LANES) {
+                    __m256i x0 = load(a + j);
+                    __m256i x1 = load(a + j + step);
+                    __m256i x2 = load(a + j + 2 * step);
+                    __m256i x3 = load(a + j + 3 * step);
+                    butterflyV<Type, Inverse>(x0, x1);
+                    butterflyV<Type, Inverse>(x2, x3);
+                    butterflyV<Type, Inverse>(x0, x2);
+                    butterflyV<Type, Inverse>(x1, x3);
+                    store(a + j, x0);
+                    store(a + j + step, x1);
+                    store(a + j + 2 * step, x2);
+                    store(a + j + 3 * step, x3);
+                }
+            }
+        }
+        if (step < blockN) {
+            for (int j = 0; j < step; j += Ops::LANES) {
+                __m256i x0 = load(a + j);
+                __m256i x1 = load(a + j + step);
+                butterflyV<Type, Inverse>(x0, x1);
+                store(a + j, x0);
+                store(a + j + step, x1);
+            }
+        }
+    }
+
+    template <int Type, bool Inverse>
+    TARGET_AVX2
+    static void outerSIMD(T* a, int step, int levels, int lo, int hi) {
+        __m256i x[8];
+        int cnt = 1 << levels;
+        for (int u = lo; u < hi; u += Ops::LANES) {
+            T* p = a + size_t(u / step) * (size_t(step) << levels) + (u % step);
+            for (int t = 0; t < cnt; t++)
+                x[t] = load(p + size_t(t) * step);
+            for (int d = 1; d < cnt; d <<= 1) {
+                for (int t = 0; t < cnt; t++) {
+                    if (!(t & d))
+                        butterflyV<Type, Inverse>(x[t], x[t + d]);
+                }
+            }
+            for (int t = 0; t < cnt; t++)
+                store(p + size_t(t) * step, x[t]);
+        }
+    }
+
+    template <int Type, bool Inverse>
+    static void transformImpl(T* a, int n, int threadN, true_type) {
+        int blockN = min(n, int(BLOCK_SIZE));
+        Parallel::forRange(0, n / blockN, threadN, [a, blockN](int lo, int hi) {
+            for (int b = lo; b < hi; b++)
+                blockSIMD<Type, Inverse>(a + size_t(b) * blockN, blockN);
+        });
+
+        for (int step = blockN; step < n; ) {
+            int levels = 0;
+            while (levels < 3 && (step << levels) < n)
+                levels++;
+            Parallel::forRange(0, n >> levels, threadN, [a, step, levels](int lo, int hi) {
+                outerSIMD<Type, Inverse>(a, step, levels, lo, hi);
+            }, Ops::LANES);
+            step <<= levels;
+        }
+    }
+};
+
+//--- Walsh-Hadamard transforms
+
+template <typename T>
+struct FWHTFast {
+    typedef FWHTEngine<T, typename FWHTOpsSelector<T>::type> Engine;
+
+    // threadN <= 0 : all hardware threads
+    static vector<T> fastXor(const vector<T>& A, const vector<T>& B, int threadN = 1) {
+        return convolute<Engine::XOR>(A, B, threadN);
+    }
+
+    static vector<T> fastOr(const vector<T>& A, const vector<T>& B, int threadN = 1) {
+        return convolute<Engine::OR>(A, B, threadN);
+    }
+
+    static vector<T> fastAnd(const vector<T>& A, const vector<T>& B, int threadN = 1) {
+        return convolute<Engine::AND>(A, B, threadN);
+    }
+
+    //--- in-place transforms, n = 2^k
+
+    static void transformXor(T* P, int n, bool inverse, int threadN = 1) {
+        if (inverse)
+            Engine::template transform<Engine::XOR, true>(P, n, threadN);
+        else
+            Engine::template transform<Engine::XOR, false>(P, n, threadN);
+    }
+
+    // forward : F(x) = SUM_{i subset of x} P[i]
+    static void transformOr(T* P, int n, bool inverse, int threadN = 1) {
+        if (inverse)
+            Engine::template transform<Engine::OR, true>(P, n, threadN);
+        else
+            Engine::template transform<Engine::OR, false>(P, n, threadN);
+    }
+
+    // forward : F(x) = SUM_{i superset of x} P[i]
+    static void transformAnd(T* P, int n, bool inverse, int threadN = 1) {
+        if (inverse)
+            Engine::template transform<Engine::AND, true>(P, n, threadN);
+        else
+            Engine::template transform<Engine::AND, false>(P, n, threadN);
+    }
+
+private:
+    template <int Type>
+    static vector<T> convolute(const vector<T>& A, const vector<T>& B, int threadN) {
+        int size = int(max(A.size(), B.size()));
+        int n = 1;
+        while (n < size)
+            n <<= 1;
+
+        vector<T> C(n), D(n);
+        copy(A.begin(), A.end(), C.begin());
+        copy(B.begin(), B.end(), D.begin());
+
+        Engine::template transform<Type, false>(C.data(), n, threadN);
+        Engine::template transform<Type, false>(D.data(), n, threadN);
+        for (int i = 0; i < n; i++)
+            C[i] *= D[i];
+        Engine::template transform<Type, true>(C.data(), n, threadN);
+
+        return C;
+    }
+};
+
+// 0 <= value < mod < 2^31
+template <int mod = 1000000007>
+struct FWHTModFast {
+    typedef FWHTEngine<int, FWHTOpsMod<mod>> Engine;
+
+    static vector<int> fastXor(const vector<int>& A, const vector<int>& B, int threadN = 1) {
+        return convolute<Engine::XOR>(A, B, threadN);
+    }
+
+    static vector<int> fastOr(const vector<int>& A, const vector<int>& B, int threadN = 1) {
+        return convolute<Engine::OR>(A, B, threadN);
+    }
+
+    static vector<int> fastAnd(const vector<int>& A, const vector<int>& B, int threadN = 1) {
+        return convolute<Engine::AND>(A, B, threadN);
+    }
+
+    //--- in-place transforms, n = 2^k
+
+    static void transformXor(int* P, int n, bool inverse, int threadN = 1) {
+        if (inverse)
+            Engine::template transform<Engine::XOR, true>(P, n, threadN);
+        else
+            Engine::template transform<Engine::XOR, false>(P, n, threadN);
+    }
+
+    static void transformOr(int* P, int n, bool inverse, int threadN = 1) {
+        if (inverse)
+            Engine::template transform<Engine::OR, true>(P, n, threadN);
+        else
+            Engine::template transform<Engine::OR, false>(P, n, threadN);
+    }
+
+    static void transformAnd(int* P, int n, bool inverse, int threadN = 1) {
+        if (inverse)
+            Engine::template transform<Engine::AND, true>(P, n, threadN);
+        else
+            Engine::template transform<Engine::AND, false>(P, n, threadN);
+    }
+
+    //--- subset convolution
+
+    // C[x] = SUM_{i subset of x} A[i] * B[x ^ i], O(k^2 * 2^k) when size = 2^k
+    // - ranked zeta transforms, the rank products are vectorized (Montgomery, if mod is odd and < 2^30)
+    static vector<int> subsetConvolution(const vector<int>& A, const vector<int>& B, int threadN = 1) {
+        int size = int(max(A.size(), B.size()));
+        int logN = 0;
+        while ((1 << logN) < size)
+            logN++;
+        int n = 1 << logN;
+        int rankN = logN + 1;
+
+        if (threadN <= 0)
+            threadN = Parallel::threadCount();
+        if (n < Engine::PARALLEL_MIN_SIZE)
+            threadN = 1;
+
+        // F[r * n + x] = A[x] if popcount(x) = r
+        vector<int> F(size_t(rankN) * n), G(size_t(rankN) * n);
+        for (int x = 0; x < int(A.size()); x++)
+            F[size_t(popCount(x)) * n + x] = A[x];
+        for (int x = 0; x < int(B.size()); x++)
+            G[size_t(popCount(x)) * n + x] = B[x];
+
+        // every transform is parallelized inside
+        for (int r = 0; r < rankN; r++) {
+            transformOr(&F[size_t(r) * n], n, false, threadN);
+            transformOr(&G[size_t(r) * n], n, false, threadN);
+        }
+
+        // F[k] <- SUM_{i=0..k} F[i] * G[k - i], k = logN..0 (in-place)
+        Parallel::forRange(0, n, threadN, [&F, &G, n, rankN](int lo, int hi) {
+            for (int first = lo; first < hi; first += PRODUCT_BLOCK_SIZE) {
+                int last = min(hi, first + PRODUCT_BLOCK_SIZE);
+                multiplyRanks(F.data(), G.data(), n, rankN, first, last,
+                              integral_constant<bool, (mod & 1) != 0 && mod < (1 << 30)>());
+            }
+        }, 8);
+
+        for (int r = 0; r < rankN; r++)
+            transformOr(&F[size_t(r) * n], n, true, threadN);
+
+        vector<int> res(n);
+        for (int x = 0; x < n; x++)
+            res[x] = F[size_t(popCount(x)) * n + x];
+        return res;
+    }
+
+private:
+    static const int PRODUCT_BLOCK_SIZE = 512;
+
+    template <int Type>
+    static vector<int> convolute(const vector<int>& A, const vector<int>& B, int threadN) {
+        int size = int(max(A.size(), B.size()));
+        int n = 1;
+        while (n < size)
+            n <<= 1;
+
+        vector<int> C(n), D(n);
+        copy(A.begin(), A.end(), C.begin());
+        copy(B.begin(), B.end(), D.begin());
+
+        Engine::template transform<Type, false>(C.data(), n, threadN);
+        Engine::template transform<Type, false>(D.data(), n, threadN);
+        for (int i = 0; i < n; i++)
+            C[i] = int(1ll * C[i] * D[i] % mod);
+        Engine::template transform<Type, true>(C.data(), n, threadN);
+
+        return C;
+    }
+
+    static int popCount(unsigned x) {
+#ifndef __GNUC__
+        return int(__popcnt(x));
+#else
+        return __builtin_popcount(x);
+#endif
+    }
+
+    static void multiplyRanksScalar(int* F, const int* G, int n, int rankN, int first, int last) {
+        for (int k = rankN - 1; k >= 0; k--) {
+            for (int x = first; x < last; x++) {
+                unsigned long long sum = 0;
+                for (int i = 0; i <= k; i++) {
+                    // a product is below 2^62, so the sum can't overflow before it reaches 2^63
+                    sum += 1ull * F[size_t(i) * n + x] * G[size_t(k - i) * n + x];
+                    if (sum >= (1ull << 63))
+                        sum %= mod;
+                }
+                F[size_t(k) * n + x] = int(sum % mod);
+            }
+        }
+    }
+
+    static void multiplyRanks(int* F, const int* G, int n, int rankN, int first, int last, false_type) {
+        multiplyRanksScalar(F, G, n, rankN, first, last);
+    }
+
+    static void multiplyRanks(int* F, const int* G, int n, int rankN, int first, int last, true_type) {
+        if (CpuFeature::hasAVX2() && (first & 7) == 0 && (last & 7) == 0)
+            multiplyRanksAVX2(F, G, n, rankN, first, last);
+        else
+            multiplyRanksScalar(F, G, n, rankN, first, last);
+    }
+
+    // mul(F, G * R) = F * G (Montgomery), the sum stays in [0, 2 * mod)
+    TARGET_AVX2
+    static void multiplyRanksAVX2(int* F, const int* G, int n, int rankN, int first, int last) {
+        typedef AVX2NTT<mod, 3> MontV;
+
+        unsigned GM[32][PRODUCT_BLOCK_SIZE];
+        int cnt = last - first;
+        for (int r = 0; r < rankN; r++) {
+            for (int x = 0; x < cnt; x++)
+                GM[r][x] = MontV::Base::toMontgomery(unsigned(G[size_t(r) * n + first + x]));
+        }
+
+        for (int k = rankN - 1; k >= 0; k--) {
+            unsigned* out = reinterpret_cast<unsigned*>(F + size_t(k) * n + first);
+            for (int x = 0; x < cnt; x += 8) {
+                __m256i sum = _mm256_setzero_si256();
+                for (int i = 0; i <= k; i++) {
+                    __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(F + size_t(i) * n + first + x));
+                    __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&GM[k - i][x]));
+                    sum = MontV::add(sum, MontV::mul(f, g));
+                }
+                sum = _mm256_min_epu32(sum, _mm256_sub_epi32(sum, _mm256_set1_epi32(mod)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), sum);
+            }
+        }
+    }
+};
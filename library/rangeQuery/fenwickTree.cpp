@@ -178,4 +178,37 @@ void testFenwickTree() {
         }
     }
     cout << "OK!" << endl;
+    cout << "*** batch / parallel build test" << endl;
+    {
+        for (int N : { 1, 100, 4096 * 2, 4096 * 5 + 17, 100000, (1 << 22) + 3 }) {
+            vector<int> in(N);
+            for (int i = 0; i < N; i++)
+                in[i] = RandInt32::get() % 1000;
+
+            FenwickTree<int> fenwick(in);
+            for (int threadN : { 2, 3, 4 }) {
+                FenwickTree<int> ft(in, threadN);
+                assert(ft.tree == fenwick.tree);
+            }
+
+            vector<int> pos(1000), val(1000);
+            for (int i = 0; i < 1000; i++) {
+                pos[i] = RandInt32::get() % N;
+                val[i] = RandInt32::get() % 1000;
+            }
+            pos[0] = -1;
+
+            auto res = fenwick.sumBatch(pos);
+            for (int i = 0; i < 1000; i++)
+                assert(res[i] == fenwick.sum(pos[i]));
+
+            pos[0] = 0;
+            FenwickTree<int> ft(in);
+            fenwick.addBatch(pos, val);
+            for (int i = 0; i < 1000; i++)
+                ft.add(pos[i], val[i]);
+            assert(ft.tree == fenwick.tree);
+        }
+    }
+    cout << "OK!" << endl;
 }
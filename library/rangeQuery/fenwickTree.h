@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <xmmintrin.h>
+#include "../common/parallel.h"
 
 //--------- Fenwick Tree (Binary Indexed Tree) --------------------------------
 
@@ -29,11 +31,21 @@
 
     3) range query
        Not working!!!
+
+  3. batched operations for large N : sumBatch(), addBatch()
+     - the first node of the query PREFETCH_DISTANCE positions ahead is prefetched, it is the one that misses
+       (the nodes near the root are shared by many queries and stay in the cache)
+     - prefetching the whole path of every query, or advancing several queries in lockstep, was slower than
+       plain sum() / add() : the out-of-order core already overlaps the independent loads of nearby queries
  */
 
 // for sum from 0 to pos
 template <typename T>
 struct FenwickTree {
+    static const int PREFETCH_DISTANCE = 8;
+    static const int BATCH_THRESHOLD = 1 << 22;     // smaller trees mostly stay in the cache, no prefetch
+    static const int BUILD_BLOCK = 1 << 12;         // a power of 2, the unit of the parallel build
+
     vector<T> tree;
 
     FenwickTree() {
@@ -46,12 +58,12 @@ struct FenwickTree {
         build(value, n);
     }
 
-    FenwickTree(const T arr[], int n) {
-        build(arr, n);
+    FenwickTree(const T arr[], int n, int threadN = 1) {
+        build(arr, n, threadN);
     }
 
-    FenwickTree(const vector<T>& v) {
-        build(v);
+    FenwickTree(const vector<T>& v, int threadN = 1) {
+        build(v, threadN);
     }
 
 
@@ -71,19 +83,41 @@ struct FenwickTree {
     }
 
     // O(N)
-    void build(const T arr[], int n) {
-        tree.clear();
-        tree.push_back(T(0));
-        tree.insert(tree.end(), arr, arr + n);
-        for (int step = 2; step <= n; step <<= 1) {
+    // - threadN > 1 : blocks of BUILD_BLOCK values are built in parallel, and only the N / BUILD_BLOCK nodes
+    //                 above them are left to a single thread
+    void build(const T arr[], int n, int threadN = 1) {
+        if (threadN <= 1 || n < BUILD_BLOCK * 2) {
+            tree.clear();
+            tree.push_back(T(0));
+            tree.insert(tree.end(), arr, arr + n);
+            for (int step = 2; step <= n; step <<= 1) {
+                for (int i = step >> 1, j = step; j <= n; i += step, j += step)
+                    tree[j] += tree[i];
+            }
+            return;
+        }
+
+        tree.resize(n + 1);
+        tree[0] = T(0);
+        Parallel::forRange(0, (n + BUILD_BLOCK - 1) / BUILD_BLOCK, threadN, [this, arr, n](int lo, int hi) {
+            for (int b = lo; b < hi; b++) {
+                int first = b * BUILD_BLOCK, last = min(n, first + BUILD_BLOCK);
+                copy(arr + first, arr + last, tree.begin() + first + 1);
+                for (int step = 2; step <= BUILD_BLOCK; step <<= 1) {
+                    for (int j = first + step; j <= last; j += step)
+                        tree[j] += tree[j - (step >> 1)];
+                }
+            }
+        });
+        for (int step = BUILD_BLOCK * 2; step <= n; step <<= 1) {
             for (int i = step >> 1, j = step; j <= n; i += step, j += step)
                 tree[j] += tree[i];
         }
     }
 
     // O(N)
-    void build(const vector<T>& v) {
-        build(&v[0], int(v.size()));
+    void build(const vector<T>& v, int threadN = 1) {
+        build(&v[0], int(v.size()), threadN);
     }
 
 
@@ -119,6 +153,38 @@ struct FenwickTree {
         }
     }
 
+    //--- batched operations
+
+    // out[i] = sum(pos[i]), O(n * logN)
+    void sumBatch(const int pos[], int n, T out[]) const {
+        int size = int(tree.size());
+        for (int i = 0; i < n; i++) {
+            if (size >= BATCH_THRESHOLD && i + PREFETCH_DISTANCE < n)
+                prefetch(pos[i + PREFETCH_DISTANCE] + 1);
+            out[i] = sum(pos[i]);
+        }
+    }
+
+    vector<T> sumBatch(const vector<int>& pos) const {
+        vector<T> res(pos.size());
+        sumBatch(pos.data(), int(pos.size()), res.data());
+        return res;
+    }
+
+    // add(pos[i], val[i]) for all i, O(n * logN)
+    void addBatch(const int pos[], const T val[], int n) {
+        int size = int(tree.size());
+        for (int i = 0; i < n; i++) {
+            if (size >= BATCH_THRESHOLD && i + PREFETCH_DISTANCE < n)
+                prefetch(pos[i + PREFETCH_DISTANCE] + 1);
+            add(pos[i], val[i]);
+        }
+    }
+
+    void addBatch(const vector<int>& pos, const vector<T>& val) {
+        addBatch(pos.data(), val.data(), int(pos.size()));
+    }
+
     // inclusive, O(logN)
     // [CAUTION] This is not a general range update.
     void addRange(int left, int right, T val) {
@@ -169,6 +235,11 @@ struct FenwickTree {
 
         return lo;
     }
+
+private:
+    void prefetch(int i) const {
+        _mm_prefetch(reinterpret_cast<const char*>(&tree[i]), _MM_HINT_T0);
+    }
 };
 
 
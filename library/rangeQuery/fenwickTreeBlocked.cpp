@@ -0,0 +1,142 @@
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#include "fenwickTreeBlocked.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+void testBlockedFenwickTree() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Blocked Fenwick Tree ------------------------------" << endl;
+    for (int N : { 1, 15, 16, 17, 1000, 1024, 1025, 100000 }) {
+        vector<long long> in(N);
+        for (int i = 0; i < N; i++)
+            in[i] = RandInt32::get() % 1000;
+
+        FenwickTree<long long> fenwick(in);
+        BlockedFenwickTree<long long> blocked(in);
+        BlockedFenwickTree<long long, 4> blockedSmall(in, 3);
+        for (int i = 0; i < 1000; i++) {
+            int pos = RandInt32::get() % N;
+            long long val = RandInt32::get() % 1000;
+            fenwick.add(pos, val);
+            if (i & 1)
+                blocked.add(pos, val);
+            else
+                blocked.addBatch(&pos, &val, 1);
+            blockedSmall.add(pos, val);
+
+            int L = RandInt32::get() % N, R = RandInt32::get() % N;
+            if (L > R)
+                swap(L, R);
+            long long gt = fenwick.sumRange(L, R);
+            assert(blocked.sumRange(L, R) == gt);
+            assert(blockedSmall.sumRange(L, R) == gt);
+        }
+
+        vector<int> pos(1000);
+        vector<long long> val(1000);
+        for (int i = 0; i < 1000; i++) {
+            pos[i] = RandInt32::get() % N;
+            val[i] = RandInt32::get() % 1000;
+        }
+        fenwick.addBatch(pos, val);
+        blocked.addBatch(pos, val);
+        blockedSmall.addBatch(pos, val);
+
+        pos[0] = -1;
+        auto gt = fenwick.sumBatch(pos);
+        auto res = blocked.sumBatch(pos);
+        auto resSmall = blockedSmall.sumBatch(pos);
+        for (int i = 0; i < 1000; i++) {
+            assert(gt[i] == fenwick.sum(pos[i]));
+            assert(res[i] == gt[i] && resSmall[i] == gt[i]);
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        const int Q = 1 << 24;
+
+        for (int N : { 1 << 20, 1 << 24, 1 << 27 }) {
+            vector<int> in(N);
+            for (auto& x : in)
+                x = RandInt32::get() % 16;
+            vector<int> pos(Q);
+            for (auto& p : pos)
+                p = RandInt32::get() % N;
+            vector<int> out(Q);
+
+            FenwickTree<int> fenwick;
+            cout << "N = " << N << ", FenwickTree::build(), 1 thread : ";
+            PROFILE_HI_START(0);
+            fenwick.build(in);
+            PROFILE_HI_STOP(0);
+
+            cout << "N = " << N << ", FenwickTree::build(), " << Parallel::threadCount() << " threads : ";
+            PROFILE_HI_START(1);
+            fenwick.build(in, Parallel::threadCount());
+            PROFILE_HI_STOP(1);
+
+            long long res1 = 0, res2 = 0, res3 = 0, res4 = 0;
+
+            cout << "N = " << N << ", FenwickTree::sum() : ";
+            PROFILE_HI_START(2);
+            for (int p : pos)
+                res1 += fenwick.sum(p);
+            PROFILE_HI_STOP(2);
+
+            cout << "N = " << N << ", FenwickTree::sumBatch() : ";
+            PROFILE_HI_START(3);
+            fenwick.sumBatch(pos.data(), Q, out.data());
+            PROFILE_HI_STOP(3);
+            for (int x : out)
+                res2 += x;
+
+            BlockedFenwickTree<int> blocked(in, Parallel::threadCount());
+            cout << "N = " << N << ", BlockedFenwickTree::sum() : ";
+            PROFILE_HI_START(4);
+            for (int p : pos)
+                res3 += blocked.sum(p);
+            PROFILE_HI_STOP(4);
+
+            cout << "N = " << N << ", BlockedFenwickTree::sumBatch() : ";
+            PROFILE_HI_START(5);
+            blocked.sumBatch(pos.data(), Q, out.data());
+            PROFILE_HI_STOP(5);
+            for (int x : out)
+                res4 += x;
+
+            assert(res1 == res2 && res2 == res3 && res3 == res4);
+
+            cout << "N = " << N << ", FenwickTree::add() : ";
+            PROFILE_HI_START(6);
+            for (int p : pos)
+                fenwick.add(p, 1);
+            PROFILE_HI_STOP(6);
+
+            vector<int> ones(Q, 1);
+            cout << "N = " << N << ", FenwickTree::addBatch() : ";
+            PROFILE_HI_START(7);
+            fenwick.addBatch(pos.data(), ones.data(), Q);
+            PROFILE_HI_STOP(7);
+
+            cout << "N = " << N << ", BlockedFenwickTree::addBatch() : ";
+            PROFILE_HI_START(8);
+            blocked.addBatch(pos.data(), ones.data(), Q);
+            PROFILE_HI_STOP(8);
+        }
+    }
+}
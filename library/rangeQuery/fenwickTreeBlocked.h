@@ -0,0 +1,206 @@
+#pragma once
+
+#include <xmmintrin.h>
+#include "fenwickTree.h"
+#include "../common/parallel.h"
+
+//--------- Blocked Fenwick Tree ----------------------------------------------
+
+/*
+  A two-level Fenwick tree for N far above the L3 cache size
+
+  - values are split into blocks of BLOCK = 2^BlockBits values
+  - each block has its own small Fenwick tree stored contiguously (4 KB for int with BlockBits = 10),
+    and an outer Fenwick tree keeps the sums of whole blocks (N / BLOCK values, small enough to stay cached)
+  - sum() reads the cached outer tree and one block, instead of logN nodes spread over the whole array
+  - the interface is the same as FenwickTree's point update / range query
+
+  <How to use>
+    BlockedFenwickTree<long long> ft(v, threadN);
+    ft.add(pos, x);
+    long long s = ft.sum(pos);              // [0, pos]
+    ft.sumBatch(pos, n, out);               // interleaved, prefetching
+*/
+
+template <typename T, int BlockBits = 10>
+struct BlockedFenwickTree {
+    static const int BLOCK = 1 << BlockBits;
+    static const int BATCH_LANES = 16;
+
+    int            N;
+    FenwickTree<T> outer;                   // sums of blocks
+    vector<T>      inner;                   // the node k (1 <= k <= BLOCK) of block b is inner[b * BLOCK + k], inner[0] = 0
+
+    BlockedFenwickTree() : N(0) {
+    }
+
+    explicit BlockedFenwickTree(int n) {
+        init(n);
+    }
+
+    BlockedFenwickTree(const T arr[], int n, int threadN = 1) {
+        build(arr, n, threadN);
+    }
+
+    BlockedFenwickTree(const vector<T>& v, int threadN = 1) {
+        build(v, threadN);
+    }
+
+
+    void init(int n) {
+        N = n;
+        int blockN = (n + BLOCK - 1) / BLOCK;
+        outer.init(blockN);
+        inner.assign(size_t(blockN) * BLOCK + 1, T(0));
+    }
+
+    // O(N), blocks are built in parallel
+    void build(const T arr[], int n, int threadN = 1) {
+        init(n);
+
+        int blockN = (n + BLOCK - 1) / BLOCK;
+        vector<T> blockSum(blockN);
+        Parallel::forRange(0, blockN, threadN, [this, arr, n, &blockSum](int lo, int hi) {
+            for (int b = lo; b < hi; b++) {
+                T* tree = &inner[size_t(b) * BLOCK];
+                int first = b * BLOCK, cnt = min(n - first, BLOCK);
+                copy(arr + first, arr + first + cnt, tree + 1);
+                for (int step = 2; step <= BLOCK; step <<= 1) {
+                    for (int j = step; j <= BLOCK; j += step)
+                        tree[j] += tree[j - (step >> 1)];
+                }
+                blockSum[b] = tree[BLOCK];
+            }
+        });
+        outer.build(blockSum);
+    }
+
+    void build(const vector<T>& v, int threadN = 1) {
+        build(v.data(), int(v.size()), threadN);
+    }
+
+
+    // sum from 0 to pos
+    // O(logN)
+    T sum(int pos) const {
+        if (pos < 0)
+            return T(0);
+
+        int b = pos >> BlockBits;
+        T res = (b > 0) ? outer.sum(b - 1) : T(0);
+
+        const T* tree = &inner[size_t(b) * BLOCK];
+        for (int k = (pos & (BLOCK - 1)) + 1; k > 0; k &= k - 1)
+            res += tree[k];
+        return res;
+    }
+
+    // inclusive, O(logN)
+    T sumRange(int left, int right) const {
+        T res = sum(right);
+        if (left > 0)
+            res -= sum(left - 1);
+        return res;
+    }
+
+    // O(logN)
+    void add(int pos, T val) {
+        int b = pos >> BlockBits;
+        outer.add(b, val);
+
+        T* tree = &inner[size_t(b) * BLOCK];
+        for (int k = (pos & (BLOCK - 1)) + 1; k <= BLOCK; k += k & -k)
+            tree[k] += val;
+    }
+
+    //--- batched operations
+
+    // out[i] = sum(pos[i])
+    // - the first nodes of the blocks are fetched while the outer sums are computed,
+    //   then the lanes advance in lockstep inside their blocks, a finished lane stays on inner[0]
+    void sumBatch(const int pos[], int n, T out[]) const {
+        for (int base = 0; base < n; base += BATCH_LANES) {
+            int laneN = min(BATCH_LANES, n - base);
+
+            size_t start[BATCH_LANES], idx[BATCH_LANES];
+            int k[BATCH_LANES];
+            T res[BATCH_LANES];
+            for (int i = 0; i < laneN; i++) {
+                int p = pos[base + i];
+                start[i] = size_t(max(p, 0) >> BlockBits) * BLOCK;
+                k[i] = (p < 0) ? 0 : (p & (BLOCK - 1)) + 1;
+                idx[i] = k[i] ? start[i] + k[i] : 0;
+                prefetch(&inner[idx[i]]);
+            }
+            for (int i = 0; i < laneN; i++) {
+                int b = pos[base + i] >> BlockBits;
+                res[i] = (b > 0) ? outer.sum(b - 1) : T(0);
+            }
+
+            for (int any = 1; any; ) {
+                any = 0;
+                for (int i = 0; i < laneN; i++) {
+                    res[i] += inner[idx[i]];
+                    k[i] &= k[i] - 1;
+                    idx[i] = k[i] ? start[i] + k[i] : 0;
+                    prefetch(&inner[idx[i]]);
+                    any |= k[i];
+                }
+            }
+
+            for (int i = 0; i < laneN; i++)
+                out[base + i] = res[i];
+        }
+    }
+
+    vector<T> sumBatch(const vector<int>& pos) const {
+        vector<T> res(pos.size());
+        sumBatch(pos.data(), int(pos.size()), res.data());
+        return res;
+    }
+
+    // add(pos[i], val[i]) for all i, a finished lane adds 0 to inner[0]
+    void addBatch(const int pos[], const T val[], int n) {
+        for (int base = 0; base < n; base += BATCH_LANES) {
+            int laneN = min(BATCH_LANES, n - base);
+
+            size_t start[BATCH_LANES], idx[BATCH_LANES];
+            int k[BATCH_LANES];
+            T v[BATCH_LANES];
+            for (int i = 0; i < laneN; i++) {
+                int p = pos[base + i];
+                start[i] = size_t(p >> BlockBits) * BLOCK;
+                k[i] = (p & (BLOCK - 1)) + 1;
+                idx[i] = start[i] + k[i];
+                v[i] = val[base + i];
+                prefetch(&inner[idx[i]]);
+            }
+            for (int i = 0; i < laneN; i++)
+                outer.add(pos[base + i] >> BlockBits, val[base + i]);
+
+            for (int any = 1; any; ) {
+                any = 0;
+                for (int i = 0; i < laneN; i++) {
+                    inner[idx[i]] += v[i];
+                    k[i] += k[i] & -k[i];
+                    if (k[i] > BLOCK) {
+                        k[i] = 0;
+                        v[i] = T(0);
+                    }
+                    idx[i] = k[i] ? start[i] + k[i] : 0;
+                    prefetch(&inner[idx[i]]);
+                    any |= k[i];
+                }
+            }
+        }
+    }
+
+    void addBatch(const vector<int>& pos, const vector<T>& val) {
+        addBatch(pos.data(), val.data(), int(pos.size()));
+    }
+
+private:
+    static void prefetch(const T* p) {
+        _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0);
+    }
+};
@@ -0,0 +1,199 @@
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+#include "fenwickTreeConcurrent.h"
+#include "fenwickTreeMultAdd.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+template <typename Func>
+static void runThreads(int threadN, Func f) {
+    vector<thread> threads;
+    for (int t = 0; t < threadN; t++)
+        threads.emplace_back(f, t);
+    for (auto& th : threads)
+        th.join();
+}
+
+void testConcurrentFenwickTree() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Concurrent Fenwick Tree ------------------------------" << endl;
+    for (int shardN : { 1, 3, 8 }) {
+        const int N = 1000, THREADS = 8, OPS = 20000;
+
+        vector<long long> in(N);
+        for (auto& x : in)
+            x = RandInt32::get() % 1000;
+
+        vector<vector<pair<int, int>>> ops(THREADS, vector<pair<int, int>>(OPS));
+        for (auto& v : ops) {
+            for (auto& op : v)
+                op = make_pair(int(RandInt32::get() % N), int(RandInt32::get() % 100));
+        }
+
+        ConcurrentFenwickTree<long long> ft(in, shardN);
+        FenwickTree<long long> gt(in);
+        for (auto& v : ops) {
+            for (auto& op : v)
+                gt.add(op.first, op.second);
+        }
+
+        // writers add positive values only, so a reader must see non-decreasing totals
+        atomic<bool> done(false);
+        thread reader([&]() {
+            long long prev = 0;
+            while (!done.load()) {
+                long long s = ft.sum(N - 1);
+                assert(s >= prev);
+                prev = s;
+            }
+        });
+        runThreads(THREADS, [&](int t) {
+            for (auto& op : ops[t])
+                ft.add(op.first, op.second);
+        });
+        done = true;
+        reader.join();
+
+        for (int i = 0; i < 1000; i++) {
+            int L = RandInt32::get() % N, R = RandInt32::get() % N;
+            if (L > R)
+                swap(L, R);
+            assert(ft.sumRange(L, R) == gt.sumRange(L, R));
+        }
+        assert(ft.snapshot().tree == gt.tree);
+    }
+    for (int shardN : { 1, 4 }) {
+        const int N = 1000, THREADS = 4, OPS = 10000;
+
+        vector<vector<pair<int, int>>> ops(THREADS, vector<pair<int, int>>(OPS));
+        for (auto& v : ops) {
+            for (auto& op : v) {
+                op = make_pair(int(RandInt32::get() % N), int(RandInt32::get() % N));
+                if (op.first > op.second)
+                    swap(op.first, op.second);
+            }
+        }
+
+        ConcurrentFenwickTreeMultAdd<long long> ft(N, shardN);
+        FenwickTreeMultAdd<long long> gt(N);
+        for (auto& v : ops) {
+            for (auto& op : v)
+                gt.addRange(op.first, op.second, 3);
+        }
+        runThreads(THREADS, [&](int t) {
+            for (auto& op : ops[t])
+                ft.addRange(op.first, op.second, 3);
+        });
+
+        for (int i = 0; i < 1000; i++) {
+            int L = RandInt32::get() % N, R = RandInt32::get() % N;
+            if (L > R)
+                swap(L, R);
+            assert(ft.sumRange(L, R) == gt.sumRange(L, R));
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        const int N = 1 << 20;
+        const int OPS = 1 << 22;        // in total, 1 of 16 operations is a sum()
+
+        vector<int> pos(OPS);
+        for (auto& p : pos)
+            p = RandInt32::get() % N;
+
+        cout << "(" << Parallel::threadCount() << " hardware threads)" << endl;
+        for (int threadN : { 1, 2, 4, 8, 16, 32, 64 }) {
+            int chunk = OPS / threadN;
+            vector<long long> res(threadN);
+
+            {
+                FenwickTree<long long> ft(N);
+                mutex lock;
+                cout << "threads = " << threadN << ", FenwickTree + mutex : ";
+                PROFILE_HI_START(0);
+                runThreads(threadN, [&](int t) {
+                    long long r = 0;
+                    for (int i = t * chunk; i < (t + 1) * chunk; i++) {
+                        lock_guard<mutex> guard(lock);
+                        if (i & 15)
+                            ft.add(pos[i], 1);
+                        else
+                            r += ft.sum(pos[i]);
+                    }
+                    res[t] = r;
+                });
+                PROFILE_HI_STOP(0);
+            }
+            for (int shardN : { 1, threadN }) {
+                ConcurrentFenwickTree<long long> ft(N, shardN);
+                cout << "threads = " << threadN << ", ConcurrentFenwickTree, shards = " << shardN << " : ";
+                PROFILE_HI_START(1);
+                runThreads(threadN, [&](int t) {
+                    long long r = 0;
+                    for (int i = t * chunk; i < (t + 1) * chunk; i++) {
+                        if (i & 15)
+                            ft.add(pos[i], 1);
+                        else
+                            r += ft.sum(pos[i]);
+                    }
+                    res[t] = r;
+                });
+                PROFILE_HI_STOP(1);
+                if (threadN == 1)
+                    break;
+            }
+            {
+                FenwickTreeMultAdd<long long> ft(N);
+                mutex lock;
+                cout << "threads = " << threadN << ", FenwickTreeMultAdd + mutex : ";
+                PROFILE_HI_START(2);
+                runThreads(threadN, [&](int t) {
+                    long long r = 0;
+                    for (int i = t * chunk; i < (t + 1) * chunk; i++) {
+                        int L = min(pos[i], pos[i ^ 1]), R = max(pos[i], pos[i ^ 1]);
+                        lock_guard<mutex> guard(lock);
+                        if (i & 15)
+                            ft.addRange(L, R, 1);
+                        else
+                            r += ft.sumRange(L, R);
+                    }
+                    res[t] = r;
+                });
+                PROFILE_HI_STOP(2);
+            }
+            {
+                ConcurrentFenwickTreeMultAdd<long long> ft(N, threadN);
+                cout << "threads = " << threadN << ", ConcurrentFenwickTreeMultAdd, shards = " << threadN << " : ";
+                PROFILE_HI_START(3);
+                runThreads(threadN, [&](int t) {
+                    long long r = 0;
+                    for (int i = t * chunk; i < (t + 1) * chunk; i++) {
+                        int L = min(pos[i], pos[i ^ 1]), R = max(pos[i], pos[i ^ 1]);
+                        if (i & 15)
+                            ft.addRange(L, R, 1);
+                        else
+                            r += ft.sumRange(L, R);
+                    }
+                    res[t] = r;
+                });
+                PROFILE_HI_STOP(3);
+            }
+        }
+    }
+}
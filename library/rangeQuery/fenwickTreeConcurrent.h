@@ -0,0 +1,171 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include "fenwickTree.h"
+
+//--------- Concurrent Fenwick Tree -------------------------------------------
+
+/*
+  A Fenwick tree that many threads can update and read at the same time without a lock
+
+  - T must be an integral type (std::atomic<T>::fetch_add)
+  - add() updates every node on its path with a relaxed atomic fetch_add
+  - sum() reads the nodes with relaxed loads : an add() that runs at the same time may be seen partially
+    (some of its nodes and not the others), a sum() is exact once all writers are done
+  - shardN > 1 : every thread adds to its own copy of the tree (threads are assigned to shards round-robin),
+    so writers do not fight over the nodes near the root, and sum() merges the shards at read time
+    => add() : O(logN), sum() : O(shardN * logN)
+
+  <How to use>
+    ConcurrentFenwickTree<long long> ft(N, Parallel::threadCount());
+    // on any thread
+    ft.add(pos, x);
+    long long s = ft.sum(pos);
+*/
+
+template <typename T>
+struct ConcurrentFenwickTree {
+    int N;
+    int shardN;
+    vector<unique_ptr<atomic<T>[]>> shards;    // shards[s][0..N], 1-based nodes as FenwickTree::tree
+
+    ConcurrentFenwickTree() : N(0), shardN(0) {
+    }
+
+    explicit ConcurrentFenwickTree(int n, int shardN = 1) {
+        init(n, shardN);
+    }
+
+    ConcurrentFenwickTree(const vector<T>& v, int shardN = 1) {
+        build(v, shardN);
+    }
+
+
+    // not thread-safe
+    void init(int n, int shardN = 1) {
+        this->N = n;
+        this->shardN = max(1, shardN);
+        shards.clear();
+        for (int s = 0; s < this->shardN; s++) {
+            shards.emplace_back(new atomic<T>[n + 1]);
+            for (int i = 0; i <= n; i++)
+                shards.back()[i].store(T(0), memory_order_relaxed);
+        }
+    }
+
+    // not thread-safe, O(N)
+    void build(const vector<T>& v, int shardN = 1) {
+        init(int(v.size()), shardN);
+
+        FenwickTree<T> ft(v);
+        for (int i = 1; i <= N; i++)
+            shards[0][i].store(ft.tree[i], memory_order_relaxed);
+    }
+
+
+    // thread-safe, O(logN)
+    void add(int pos, T val) {
+        atomic<T>* tree = shards[shardIndex()].get();
+        for (pos++; pos <= N; pos += pos & -pos)
+            tree[pos].fetch_add(val, memory_order_relaxed);
+    }
+
+    // inclusive, thread-safe, O(logN)
+    // [CAUTION] This is not a general range update.
+    void addRange(int left, int right, T val) {
+        add(left, val);
+        if (right + 1 < N)
+            add(right + 1, -val);
+    }
+
+    // sum from 0 to pos, thread-safe, O(shardN * logN)
+    T sum(int pos) const {
+        T res = T(0);
+        for (int s = 0; s < shardN; s++) {
+            const atomic<T>* tree = shards[s].get();
+            for (int i = pos + 1; i > 0; i &= i - 1)
+                res += tree[i].load(memory_order_relaxed);
+        }
+        return res;
+    }
+
+    // inclusive, thread-safe, O(shardN * logN)
+    T sumRange(int left, int right) const {
+        T res = sum(right);
+        if (left > 0)
+            res -= sum(left - 1);
+        return res;
+    }
+
+    // merges all shards into a plain Fenwick tree, O(shardN * N)
+    FenwickTree<T> snapshot() const {
+        FenwickTree<T> res(N);
+        for (int s = 0; s < shardN; s++) {
+            for (int i = 1; i <= N; i++)
+                res.tree[i] += shards[s][i].load(memory_order_relaxed);
+        }
+        return res;
+    }
+
+private:
+    int shardIndex() const {
+        if (shardN == 1)
+            return 0;
+        return threadIndex() % shardN;
+    }
+
+    // 0, 1, 2, ... in the order threads first call it
+    static int threadIndex() {
+        static atomic<int> counter(0);
+        static thread_local int index = counter.fetch_add(1, memory_order_relaxed);
+        return index;
+    }
+};
+
+//--------- Concurrent Fenwick Tree Mult & Add --------------------------------
+
+// FenwickTreeMultAdd on two ConcurrentFenwickTrees, range add and range sum from many threads
+// - a sum() running at the same time as an add() may see only one of its two trees
+template <typename T>
+struct ConcurrentFenwickTreeMultAdd {
+    ConcurrentFenwickTree<T> mulT;
+    ConcurrentFenwickTree<T> addT;
+
+    ConcurrentFenwickTreeMultAdd() {
+    }
+
+    explicit ConcurrentFenwickTreeMultAdd(int n, int shardN = 1) : mulT(n, shardN), addT(n, shardN) {
+    }
+
+
+    // not thread-safe
+    void init(int n, int shardN = 1) {
+        mulT.init(n, shardN);
+        addT.init(n, shardN);
+    }
+
+
+    // thread-safe
+    void add(int x, T d) {
+        mulT.add(x, d);
+        addT.add(x, d * (1 - x));
+    }
+
+    // (inclusive, inclusive), thread-safe
+    void addRange(int left, int right, T d) {
+        add(left, d);
+        add(right + 1, -d);
+    }
+
+    // thread-safe
+    T sum(int x) const {
+        return addT.sum(x) + mulT.sum(x) * x;
+    }
+
+    // (inclusive, inclusive), thread-safe
+    T sumRange(int left, int right) const {
+        return sum(right) - sum(left - 1);
+    }
+};
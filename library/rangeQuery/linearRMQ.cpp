@@ -0,0 +1,230 @@
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+#include "linearRMQ.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+#include "monoid.h"
+#include "sparseTable.h"
+#include "sparseTableFast.h"
+#include "sparseTableMin.h"
+#include "sparseTableMinFast.h"
+#include "sparseTableMinIndex.h"
+#include "sparseTableMinIndexFast.h"
+#include "sparseTableIndex.h"
+#include "sparseTableIndexFast.h"
+#include "sparseTableSimpleRMQ.h"
+#include "sparseTableDisjoint.h"
+#include "schieberVishkinRMQ.h"
+
+template <typename U>
+static size_t memoryOf(const vector<U>& v) {
+    return v.size() * sizeof(U);
+}
+
+template <typename U>
+static size_t memoryOf(const vector<vector<U>>& v) {
+    size_t res = 0;
+    for (auto& it : v)
+        res += memoryOf(it);
+    return res;
+}
+
+void testLinearRMQ() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Linear RMQ (block decomposition) ------------------------" << endl;
+    for (int N : { 1, 2, 63, 64, 65, 128, 1000, 4096, 100000, 200003 }) {
+        for (int X : { 3, 1000000000 }) {
+            vector<int> v(N);
+            for (auto& x : v)
+                x = RandInt32::get() % X;
+
+            LinearRMQ<int> rmq(v);
+            LinearRMQ<int> rmqParallel(v, 4);
+            SparseTableMinIndex gt(v);
+            assert(rmq.mask == rmqParallel.mask && rmq.table == rmqParallel.table && rmq.tableValue == rmqParallel.tableValue);
+
+            for (int i = 0; i < 10000; i++) {
+                int L = RandInt32::get() % N, R = RandInt32::get() % N;
+                if (L > R)
+                    swap(L, R);
+                if (i < 2000 && R - L > 130)
+                    R = L + int(RandInt32::get() % 130);
+
+                int idx = int(min_element(v.begin() + L, v.begin() + R + 1) - v.begin());
+                assert(rmq.queryIndex(L, R) == idx);
+                assert(rmq.query(L, R) == v[idx]);
+                assert(v[gt.query(L, R)] == v[idx]);
+            }
+        }
+    }
+    {
+        vector<long long> v(1000);
+        for (auto& x : v)
+            x = -(long long)RandInt32::get() * RandInt32::get();
+        LinearRMQ<long long> rmq(v);
+        for (int i = 0; i < 1000; i++) {
+            int L = RandInt32::get() % 1000, R = RandInt32::get() % 1000;
+            if (L > R)
+                swap(L, R);
+            assert(rmq.query(L, R) == *min_element(v.begin() + L, v.begin() + R + 1));
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        const int N = 10000000;
+        const int Q = 10000000;
+
+        vector<int> v(N);
+        for (auto& x : v)
+            x = RandInt32::get() % N;   // also valid indices for SparseTableIndex / FastSparseTableIndex
+        vector<pair<int, int>> qry(Q);
+        for (auto& q : qry) {
+            q.first = RandInt32::get() % N;
+            q.second = RandInt32::get() % N;
+            if (q.first > q.second)
+                swap(q.first, q.second);
+        }
+
+        long long gt = 0;
+        auto report = [N](const char* name, size_t bytes) {
+            cout << "    " << name << " : " << double(bytes) / N << " bytes per value" << endl;
+        };
+        auto runValue = [&](const char* name, const auto& rmq) {
+            long long res = 0;
+            cout << "N = " << N << ", " << name << ", 10^7 queries : ";
+            PROFILE_HI_START(1);
+            for (auto& q : qry)
+                res += rmq.query(q.first, q.second);
+            PROFILE_HI_STOP(1);
+            return res;
+        };
+        auto runIndex = [&](const char* name, const auto& query) {
+            long long res = 0;
+            cout << "N = " << N << ", " << name << ", 10^7 queries : ";
+            PROFILE_HI_START(2);
+            for (auto& q : qry)
+                res += v[query(q.first, q.second)];
+            PROFILE_HI_STOP(2);
+            return res;
+        };
+
+        {
+            LinearRMQ<int> rmq;
+            cout << "N = " << N << ", LinearRMQ, build : ";
+            PROFILE_HI_START(0);
+            rmq.build(v);
+            PROFILE_HI_STOP(0);
+
+            cout << "N = " << N << ", LinearRMQ, parallel build (" << Parallel::threadCount() << " threads) : ";
+            PROFILE_HI_START(5);
+            rmq.build(v, Parallel::threadCount());
+            PROFILE_HI_STOP(5);
+
+            gt = runValue("LinearRMQ::query()", rmq);
+            assert(runIndex("LinearRMQ::queryIndex()", [&rmq](int L, int R) { return rmq.queryIndex(L, R); }) == gt);
+            report("LinearRMQ", rmq.memoryBytes());
+        }
+        {
+            SparseTable<int, MinMonoid<int>> rmq(v);
+            assert(runValue("SparseTable<MinMonoid>", rmq) == gt);
+            report("SparseTable", memoryOf(rmq.value) + memoryOf(rmq.H));
+        }
+        {
+            auto rmq = makeFastSparseTable(v, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+            assert(runValue("FastSparseTable", rmq) == gt);
+            report("FastSparseTable", memoryOf(rmq.value));
+        }
+        {
+            SparseTableMin rmq(v);
+            assert(runValue("SparseTableMin", rmq) == gt);
+            report("SparseTableMin", memoryOf(rmq.value) + memoryOf(rmq.H));
+        }
+        {
+            FastSparseTableMin rmq(v);
+            assert(runValue("FastSparseTableMin", rmq) == gt);
+            report("FastSparseTableMin", memoryOf(rmq.value));
+        }
+        {
+            SimpleSparseTableRMQ<int> rmq(v);
+            assert(runValue("SimpleSparseTableRMQ", rmq) == gt);
+            report("SimpleSparseTableRMQ", memoryOf(rmq.values));
+        }
+        {
+            auto rmq = makeDisjointSparseTable(v, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+            assert(runValue("DisjointSparseTable", rmq) == gt);
+            report("DisjointSparseTable", memoryOf(rmq.table) + memoryOf(rmq.H));
+        }
+        {
+            SparseTableMinIndex rmq(v);
+            assert(runIndex("SparseTableMinIndex", [&rmq](int L, int R) { return rmq.query(L, R); }) == gt);
+            report("SparseTableMinIndex", memoryOf(rmq.value) + memoryOf(rmq.H) + memoryOf(rmq.in));
+        }
+        {
+            FastSparseTableMinIndex rmq(v);
+            assert(runIndex("FastSparseTableMinIndex", [&rmq](int L, int R) { return rmq.query(L, R); }) == gt);
+            report("FastSparseTableMinIndex", memoryOf(rmq.value) + memoryOf(rmq.in));
+        }
+        {
+            // latency and memory only, level 0 of these tables holds the values instead of indices
+            auto rmq = makeSparseTableIndex(v.data(), N, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+            long long res = runIndex("SparseTableIndex", [&rmq](int L, int R) { return rmq.query(L, R); });
+            cout << "    checksum : " << res << endl;  // keeps the query loop from being optimized away
+            report("SparseTableIndex", memoryOf(rmq.value) + memoryOf(rmq.H) + memoryOf(rmq.in));
+        }
+        {
+            auto rmq = makeFastSparseTableIndex(v.data(), N, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+            long long res = runIndex("FastSparseTableIndex", [&rmq](int L, int R) { return rmq.query(L, R); });
+            cout << "    checksum : " << res << endl;  // keeps the query loop from being optimized away
+            report("FastSparseTableIndex", memoryOf(rmq.value) + memoryOf(rmq.in));
+        }
+        {
+            SchieberVishkinRMQ<int> rmq(v);
+            assert(runIndex("SchieberVishkinRMQ", [&rmq](int L, int R) { return rmq.queryIndex(L, R); }) == gt);
+            report("SchieberVishkinRMQ", memoryOf(rmq.indices) + memoryOf(rmq.inlabel) + memoryOf(rmq.ascendant) + memoryOf(rmq.head));
+        }
+    }
+    {
+        // sparse tables need about 27 words per value at this size
+        const int N = 100000000;
+        const int Q = 10000000;
+
+        vector<int> v(N);
+        for (auto& x : v)
+            x = RandInt32::get();
+
+        LinearRMQ<int> rmq;
+        cout << "N = " << N << ", LinearRMQ, parallel build (" << Parallel::threadCount() << " threads) : ";
+        PROFILE_HI_START(3);
+        rmq.build(v, Parallel::threadCount());
+        PROFILE_HI_STOP(3);
+        cout << "    LinearRMQ : " << double(rmq.memoryBytes()) / N << " bytes per value" << endl;
+
+        long long res = 0;
+        cout << "N = " << N << ", LinearRMQ::query(), 10^7 queries : ";
+        PROFILE_HI_START(4);
+        for (int i = 0; i < Q; i++) {
+            int L = RandInt32::get() % N, R = RandInt32::get() % N;
+            if (L > R)
+                swap(L, R);
+            res += rmq.query(L, R);
+        }
+        PROFILE_HI_STOP(4);
+        cout << "    (" << res << ")" << endl;
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "../integer/bit.h"
+#include "../common/parallel.h"
+
+//--------- RMQ (Range Minimum Query) - O(N) memory, O(1) query ---------------
+
+/*
+  Block decomposition RMQ
+
+  - values are split into blocks of 64
+  - in-block : mask[i] is the monotonic stack of its block after pushing value i, one bit per position,
+               so the minimum of [l, r] in one block is the lowest bit of mask[r] at or above l (one ctz)
+  - between blocks : a sparse table over the block minima (N / 64 * log(N / 64) indices and their values,
+                     query() reads the values directly and does not need to follow the indices)
+  - memory : one 64-bit mask per value + about 0.3 words (2.3 ~ 2.6 bytes) per value for the block tables,
+             about 1.3 words (10.3 ~ 10.6 bytes) per value without the values
+             (measured with 32-bit values : 14.3 bytes per value at N = 10^7, 14.6 at N = 10^8 ;
+              a sparse table keeps log(N) words per value)
+  - build : O(N), blocks and sparse table levels can be built in parallel
+  - ties are broken to the left (the smallest index of the minimum)
+
+  <How to use>
+    LinearRMQ<int> rmq(v);                  // LinearRMQ<int> rmq(v, Parallel::threadCount());
+    int x = rmq.query(left, right);         // the minimum value in [left, right]
+    int i = rmq.queryIndex(left, right);    // its index
+*/
+
+template <typename T = int>
+struct LinearRMQ {
+    typedef unsigned long long u64;
+
+    static const int BLOCK_BITS = 6;
+    static const int BLOCK = 1 << BLOCK_BITS;
+    static const int PARALLEL_THRESHOLD = 1 << 16;
+
+    int         N;
+    int         blockN;
+    vector<T>   values;
+    vector<u64> mask;                   // in-block monotonic stacks
+    vector<int> table;                  // table[k * blockN + b] = the index of min(blocks b .. b + 2^k - 1)
+    vector<T>   tableValue;             // tableValue[k * blockN + b] = values[table[k * blockN + b]]
+
+    LinearRMQ() : N(0), blockN(0) {
+    }
+
+    LinearRMQ(const T a[], int n, int threadN = 1) {
+        build(a, n, threadN);
+    }
+
+    explicit LinearRMQ(const vector<T>& v, int threadN = 1) {
+        build(v, threadN);
+    }
+
+
+    // O(N)
+    void build(const T a[], int n, int threadN = 1) {
+        N = n;
+        blockN = (n + BLOCK - 1) / BLOCK;
+        values.assign(a, a + n);
+        mask.assign(n, 0);
+        if (n <= 0) {
+            table.clear();
+            tableValue.clear();
+            return;
+        }
+        if (n < PARALLEL_THRESHOLD)
+            threadN = 1;
+
+        int levelN = log2Int(unsigned(blockN)) + 1;
+        table.assign(size_t(levelN) * blockN, 0);
+        tableValue.assign(size_t(levelN) * blockN, T());
+
+        Parallel::forRange(0, blockN, threadN, [this](int lo, int hi) {
+            for (int b = lo; b < hi; b++) {
+                int first = b * BLOCK, last = min(N, first + BLOCK);
+                u64 stack = 0;
+                for (int i = first; i < last; i++) {
+                    while (stack && values[i] < values[first + 63 - clz(stack)])
+                        stack &= ~(1ull << (63 - clz(stack)));
+                    stack |= 1ull << (i - first);
+                    mask[i] = stack;
+                }
+                table[b] = first + ctz(stack);
+                tableValue[b] = values[table[b]];
+            }
+        });
+
+        for (int k = 1; k < levelN; k++) {
+            const int* prev = &table[size_t(k - 1) * blockN];
+            int* curr = &table[size_t(k) * blockN];
+            T* currValue = &tableValue[size_t(k) * blockN];
+            int half = 1 << (k - 1);
+            Parallel::forRange(0, blockN - (1 << k) + 1, threadN, [this, prev, curr, currValue, half](int lo, int hi) {
+                for (int b = lo; b < hi; b++) {
+                    curr[b] = minIndex(prev[b], prev[b + half]);
+                    currValue[b] = values[curr[b]];
+                }
+            });
+        }
+    }
+
+    void build(const vector<T>& v, int threadN = 1) {
+        build(v.data(), int(v.size()), threadN);
+    }
+
+
+    // inclusive, O(1)
+    T query(int left, int right) const {
+        int bl = left >> BLOCK_BITS, br = right >> BLOCK_BITS;
+        if (bl == br)
+            return values[inBlock(left, right)];
+
+        T res = min(values[inBlock(left, (bl << BLOCK_BITS) + BLOCK - 1)], values[inBlock(br << BLOCK_BITS, right)]);
+        if (bl + 1 < br) {
+            int k = log2Int(unsigned(br - bl - 1));
+            const T* level = &tableValue[size_t(k) * blockN];
+            res = min(res, min(level[bl + 1], level[br - (1 << k)]));
+        }
+        return res;
+    }
+
+    // inclusive, O(1), the smallest index of the minimum
+    int queryIndex(int left, int right) const {
+        int bl = left >> BLOCK_BITS, br = right >> BLOCK_BITS;
+        if (bl == br)
+            return inBlock(left, right);
+
+        int res = inBlock(left, (bl << BLOCK_BITS) + BLOCK - 1);
+        if (bl + 1 < br) {
+            int k = log2Int(unsigned(br - bl - 1));
+            const int* level = &table[size_t(k) * blockN];
+            res = minIndex(res, minIndex(level[bl + 1], level[br - (1 << k)]));
+        }
+        return minIndex(res, inBlock(br << BLOCK_BITS, right));
+    }
+
+    // bytes used by the structure, the values included
+    size_t memoryBytes() const {
+        return values.size() * sizeof(T) + mask.size() * sizeof(u64) + table.size() * sizeof(int) + tableValue.size() * sizeof(T);
+    }
+
+private:
+    // left and right are in the same block
+    int inBlock(int left, int right) const {
+        int first = left & ~(BLOCK - 1);
+        return first + ctz(mask[right] >> (left - first) << (left - first));
+    }
+
+    // PRECONDITION: i < j
+    int minIndex(int i, int j) const {
+        return (values[j] < values[i]) ? j : i;
+    }
+};
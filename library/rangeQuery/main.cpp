@@ -14,6 +14,8 @@ int main(void) {
     TEST(FenwickTree2D);
     TEST(FenwickTreeMultAdd);
     TEST(FenwickTreeEx);
+    TEST(BlockedFenwickTree);
+    TEST(ConcurrentFenwickTree);
     TEST(GeneralizedBIT);
     TEST(PersistentFenwickTree);
     TEST(PersistentFenwickTreeMultAdd);
@@ -38,12 +40,15 @@ int main(void) {
     TEST(SparseTable2D);
     TEST(DisjointSparseTable);
     TEST(SparseTableSimpleRMQ);
+    TEST(LinearRMQ);
     TEST(SegmentTreeLine1D);
     TEST(SegmentTreeLine2D);
     TEST(SegmentTreeLine2DArray);
     TEST(SegmentTreeLineSegment2D);
     TEST(SegmentTreeLineSegment2DSum);
     TEST(SqrtTree);
+    TEST(Monoid);
+    TEST(SegmentTreeWide);
     TEST(MergeSortTree);
     TEST(MergeSortTreeWithSum);
     TEST(MergeSortTreeIndex);
@@ -0,0 +1,212 @@
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+
+#include "monoid.h"
+#include "segmentTree.h"
+#include "segmentTreeCompact.h"
+#include "segmentTreePersistent.h"
+#include "sparseTable.h"
+#include "sqrtTree.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+
+void testMonoid() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Monoid (static MergeOp) ---------------------------" << endl;
+    {
+        assert((MergeOpIdentity<MinMonoid<int>, int>::get()) == numeric_limits<int>::max());
+        assert((MergeOpIdentity<MaxMonoid<int>, int>::get()) == numeric_limits<int>::lowest());
+        assert((MergeOpIdentity<MinOp<int>, int>::get()) == 0);
+        assert((MergeOpIdentity<function<int(int, int)>, int>::get()) == 0);
+    }
+    {
+        int N = 1000;
+        vector<int> v(N);
+        for (auto& x : v)
+            x = RandInt32::get() % 10000 - 5000;
+        vector<int> positive(N);
+        for (auto& x : positive)
+            x = RandInt32::get() % 100 + 1;
+
+        SegmentTree<int, MinMonoid<int>> segMin(v);
+        SegmentTree<int, SumMonoid<int>> segSum(positive);
+        CompactSegmentTree<int, MinMonoid<int>> compactMin(v);
+        CompactSegmentTree<int, MaxMonoid<int>> compactMax(v, MaxMonoid<int>(), MaxMonoid<int>::identity(), true);
+        SparseTable<int, MaxMonoid<int>> sparseMax(v);
+        SqrtTree<int, MinMonoid<int>> sqrtMin(v);
+        PersistentSegmentTree<int, SumMonoid<int>> persistentSum(positive);
+        int root = persistentSum.getInitRoot();
+
+        for (int i = 0; i < 1000; i++) {
+            int L = RandInt32::get() % N, R = RandInt32::get() % N;
+            if (L > R)
+                swap(L, R);
+            int gtMin = *min_element(v.begin() + L, v.begin() + R + 1);
+            int gtMax = *max_element(v.begin() + L, v.begin() + R + 1);
+            int gtSum = 0;
+            for (int j = L; j <= R; j++)
+                gtSum += positive[j];
+
+            assert(segMin.query(L, R) == gtMin);
+            assert(segSum.query(L, R) == gtSum);
+            assert(compactMin.query(L, R) == gtMin);
+            assert(compactMax.query(L, R) == gtMax);
+            assert(sparseMax.query(L, R) == gtMax);
+            assert(sqrtMin.query(L, R) == gtMin);
+            assert(persistentSum.query(root, L, R) == gtSum);
+        }
+
+        // templated predicates
+        for (int i = 0; i < 100; i++) {
+            int k = RandInt32::get() % (50 * N);
+            int gt = 0, sum = 0;
+            while (gt < N && sum + positive[gt] < k)
+                sum += positive[gt++];
+            assert(segSum.lowerBound([k](int x) { return x >= k; }) == min(gt, N - 1));
+            assert(persistentSum.lowerBound(root, [k](int x) { return x >= k; }) == gt);
+
+            int start = RandInt32::get() % N, limit = RandInt32::get() % 10000 - 5000;
+            int next = start;
+            while (next < N && v[next] <= limit)
+                next++;
+            assert(findNext(compactMax, start, [limit](int x) { return x > limit; }) == (next < N ? next : -1));
+        }
+
+        // updates
+        for (int i = 0; i < 1000; i++) {
+            int idx = RandInt32::get() % N, x = RandInt32::get() % 10000 - 5000;
+            v[idx] = x;
+            segMin.update(idx, x);
+            compactMin.update(idx, x);
+            int L = RandInt32::get() % N, R = RandInt32::get() % N;
+            if (L > R)
+                swap(L, R);
+            int gt = *min_element(v.begin() + L, v.begin() + R + 1);
+            assert(segMin.query(L, R) == gt);
+            assert(compactMin.query(L, R) == gt);
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        const int N = 1000000;
+        const int OPS = 10000000;
+        vector<int> v(N);
+        for (auto& x : v)
+            x = RandInt32::get();
+
+        struct Op {
+            int type, a, b;
+        };
+        vector<Op> ops(OPS);
+        for (auto& op : ops) {
+            op.type = RandInt32::get() & 1;
+            op.a = RandInt32::get() % N;
+            op.b = op.type ? int(RandInt32::get()) : int(RandInt32::get() % N);
+            if (!op.type && op.a > op.b)
+                swap(op.a, op.b);
+        }
+
+        auto run = [&](auto& tree) {
+            long long res = 0;
+            for (auto& op : ops) {
+                if (op.type)
+                    tree.update(op.a, op.b);
+                else
+                    res += tree.query(op.a, op.b);
+            }
+            return res;
+        };
+
+        long long res1, res2, res3, res4;
+
+        SegmentTree<int> segFunc(v, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+        cout << "SegmentTree, function<T(T,T)>, 10^7 mixed ops : ";
+        PROFILE_HI_START(0);
+        res1 = run(segFunc);
+        PROFILE_HI_STOP(0);
+
+        SegmentTree<int, MinMonoid<int>> segMonoid(v);
+        cout << "SegmentTree, MinMonoid, 10^7 mixed ops : ";
+        PROFILE_HI_START(1);
+        res2 = run(segMonoid);
+        PROFILE_HI_STOP(1);
+
+        CompactSegmentTree<int> compactFunc(v, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+        cout << "CompactSegmentTree, function<T(T,T)>, 10^7 mixed ops : ";
+        PROFILE_HI_START(2);
+        res3 = run(compactFunc);
+        PROFILE_HI_STOP(2);
+
+        CompactSegmentTree<int, MinMonoid<int>> compactMonoid(v);
+        cout << "CompactSegmentTree, MinMonoid, 10^7 mixed ops : ";
+        PROFILE_HI_START(3);
+        res4 = run(compactMonoid);
+        PROFILE_HI_STOP(3);
+
+        assert(res1 == res2 && res2 == res3 && res3 == res4);
+    }
+    {
+        const int N = 1000000;
+        const int OPS = 10000000;
+        vector<int> v(N);
+        for (auto& x : v)
+            x = RandInt32::get();
+        vector<pair<int, int>> Q(OPS);
+        for (auto& q : Q) {
+            q.first = RandInt32::get() % N;
+            q.second = RandInt32::get() % N;
+            if (q.first > q.second)
+                swap(q.first, q.second);
+        }
+
+        auto run = [&](const auto& table) {
+            long long res = 0;
+            for (auto& q : Q)
+                res += table.query(q.first, q.second);
+            return res;
+        };
+
+        long long res1, res2, res3, res4;
+
+        SparseTable<int> sparseFunc(v, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+        cout << "SparseTable, function<T(T,T)>, 10^7 queries : ";
+        PROFILE_HI_START(4);
+        res1 = run(sparseFunc);
+        PROFILE_HI_STOP(4);
+
+        SparseTable<int, MinMonoid<int>> sparseMonoid(v);
+        cout << "SparseTable, MinMonoid, 10^7 queries : ";
+        PROFILE_HI_START(5);
+        res2 = run(sparseMonoid);
+        PROFILE_HI_STOP(5);
+
+        SqrtTree<int> sqrtFunc(v, [](int a, int b) { return min(a, b); }, numeric_limits<int>::max());
+        cout << "SqrtTree, function<T(T,T)>, 10^7 queries : ";
+        PROFILE_HI_START(6);
+        res3 = run(sqrtFunc);
+        PROFILE_HI_STOP(6);
+
+        SqrtTree<int, MinMonoid<int>> sqrtMonoid(v);
+        cout << "SqrtTree, MinMonoid, 10^7 queries : ";
+        PROFILE_HI_START(7);
+        res4 = run(sqrtMonoid);
+        PROFILE_HI_STOP(7);
+
+        assert(res1 == res2 && res2 == res3 && res3 == res4);
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <functional>
+
+//--------- Operations --------------------------------------------------------
+
+template <typename T>
+struct MaxOp {
+    T operator()(T a, T b) const {
+        return max(a, b);
+    }
+};
+
+template <typename T>
+struct MinOp {
+    T operator()(T a, T b) const {
+        return min(a, b);
+    }
+};
+
+template <typename T>
+struct SumOp {
+    T operator()(T a, T b) const {
+        return a + b;
+    }
+};
+
+template <typename T>
+struct GcdOp {
+    T operator()(T a, T b) const {
+        return gcd(a, b);
+    }
+};
+
+template <typename T>
+struct LcmOp {
+    T operator()(T a, T b) const {
+        return lcm(a, b);
+    }
+};
+
+//--------- Monoids -----------------------------------------------------------
+// A monoid is an operation whose identity is known at compile time
+//   - value_type, static T identity()
+//   - it is a MergeOp (operator()), so trees call it directly instead of through function<T(T,T)>
+//   - trees use identity() as their default value
+
+template <typename T>
+struct MaxMonoid : MaxOp<T> {
+    typedef T value_type;
+
+    static T identity() {
+        return numeric_limits<T>::lowest();
+    }
+};
+
+template <typename T>
+struct MinMonoid : MinOp<T> {
+    typedef T value_type;
+
+    static T identity() {
+        return numeric_limits<T>::max();
+    }
+};
+
+template <typename T>
+struct SumMonoid : SumOp<T> {
+    typedef T value_type;
+
+    static T identity() {
+        return T();
+    }
+};
+
+template <typename T>
+struct GcdMonoid : GcdOp<T> {
+    typedef T value_type;
+
+    static T identity() {
+        return T();
+    }
+};
+
+// the default MergeOp of a tree : MergeOp() for monoids and operations,
+// a function<T(T,T)> has no useful default and must be passed to the constructor
+template <typename MergeOp>
+struct MergeOpDefault {
+    static MergeOp get() {
+        return MergeOp();
+    }
+};
+
+template <typename R, typename... Args>
+struct MergeOpDefault<function<R(Args...)>> {
+    static function<R(Args...)> get() {
+        static_assert(!is_same<R, R>::value, "pass the merge operation to the constructor");
+        return function<R(Args...)>();
+    }
+};
+
+// the default value of a tree : MergeOp::identity() for monoids, T() for the other operations
+template <typename MergeOp, typename T, typename = void>
+struct MergeOpIdentity {
+    static T get() {
+        return T();
+    }
+};
+
+template <typename MergeOp, typename T>
+struct MergeOpIdentity<MergeOp, T, decltype(void(MergeOp::identity()))> {
+    static T get() {
+        return MergeOp::identity();
+    }
+};
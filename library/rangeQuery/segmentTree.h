@@ -2,43 +2,7 @@
 
 #include <vector>
 #include <functional>
-
-//--------- Operations --------------------------------------------------------
-
-template <typename T>
-struct MaxOp {
-    T operator()(T a, T b) const {
-        return max(a, b);
-    }
-};
-
-template <typename T>
-struct MinOp {
-    T operator()(T a, T b) const {
-        return min(a, b);
-    }
-};
-
-template <typename T>
-struct SumOp {
-    T operator()(T a, T b) const {
-        return a + b;
-    }
-};
-
-template <typename T>
-struct GcdOp {
-    T operator()(T a, T b) const {
-        return gcd(a, b);
-    }
-};
-
-template <typename T>
-struct LcmOp {
-    T operator()(T a, T b) const {
-        return lcm(a, b);
-    }
-};
+#include "monoid.h"
 
 //--------- General Segment Tree ----------------------------------------------
 
@@ -52,25 +16,25 @@ struct SegmentTree {
     MergeOp   mergeOp;
     T         defaultValue;
 
-    explicit SegmentTree(MergeOp op, T dflt = T())
+    explicit SegmentTree(MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get())
         : N(0), tree(), mergeOp(op), defaultValue(dflt) {
     }
 
-    SegmentTree(int size, MergeOp op, T dflt = T())
+    explicit SegmentTree(int size, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get())
         : N(size), tree(size * 4, dflt), mergeOp(op), defaultValue(dflt) {
     }
 
-    SegmentTree(T value, int n, MergeOp op, T dflt = T())
+    SegmentTree(T value, int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dflt) {
         build(value, n);
     }
 
-    SegmentTree(const T arr[], int n, MergeOp op, T dflt = T())
+    SegmentTree(const T arr[], int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dflt) {
         build(arr, n);
     }
 
-    SegmentTree(const vector<T>& v, MergeOp op, T dflt = T())
+    explicit SegmentTree(const vector<T>& v, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dflt) {
         build(v);
     }
@@ -121,7 +85,8 @@ struct SegmentTree {
     //   f(x): xxxxxxxxxxxOOOOOOOO
     //         S          ^
     // O(logN)
-    int lowerBound(const function<bool(T)>& f) const {
+    template <typename Pred>
+    int lowerBound(const Pred& f) const {
         return lowerBoundSub(f, defaultValue, 1, 0, N - 1);
     }
 
@@ -187,7 +152,8 @@ private:
     }
 
 
-    int lowerBoundSub(const function<bool(T)>& f, T delta, int node, int nodeLeft, int nodeRight) const {
+    template <typename Pred>
+    int lowerBoundSub(const Pred& f, T delta, int node, int nodeLeft, int nodeRight) const {
         if (nodeLeft >= nodeRight)
             return nodeLeft;
 
@@ -216,6 +182,8 @@ inline SegmentTree<T, MergeOp> makeSegmentTree(const vector<T>& v, MergeOp op, T
 }
 
 /* example
+    0) with a monoid (no std::function, the identity is the default value)
+        SegmentTree<int, MinMonoid<int>> segTree(v);
     1) Min Segment Tree (RMQ)
         auto segTree = makeSegmentTree<int>(N, [](int a, int b) { return min(a, b); }, INT_MAX);
     2) Max Segment Tree 
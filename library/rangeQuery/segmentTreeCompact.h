@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <functional>
+#include "monoid.h"
 
 //--------- Compact Segment Tree ----------------------------------------------
 // http://codeforces.com/blog/entry/18051
@@ -21,26 +22,26 @@ struct CompactSegmentTree {
     MergeOp   mergeOp;
     T         defaultValue;
 
-    explicit CompactSegmentTree(MergeOp op, T dflt = T())
+    explicit CompactSegmentTree(MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get())
         : RealN(0), N(0), tree(), mergeOp(op), defaultValue(dflt) {
     }
 
-    CompactSegmentTree(int size, MergeOp op, T dflt = T(), bool alignPowerOf2 = false)
+    explicit CompactSegmentTree(int size, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get(), bool alignPowerOf2 = false)
         : mergeOp(op), defaultValue(dflt) {
         init(size, alignPowerOf2);
     }
 
-    CompactSegmentTree(T value, int n, MergeOp op, T dflt = T(), bool alignPowerOf2 = false)
+    CompactSegmentTree(T value, int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get(), bool alignPowerOf2 = false)
         : mergeOp(op), defaultValue(dflt) {
         build(value, n, alignPowerOf2);
     }
 
-    CompactSegmentTree(const T arr[], int n, MergeOp op, T dflt = T(), bool alignPowerOf2 = false)
+    CompactSegmentTree(const T arr[], int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get(), bool alignPowerOf2 = false)
         : mergeOp(op), defaultValue(dflt) {
         build(arr, n, alignPowerOf2);
     }
 
-    CompactSegmentTree(const vector<T>& v, MergeOp op, T dflt = T(), bool alignPowerOf2 = false)
+    explicit CompactSegmentTree(const vector<T>& v, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get(), bool alignPowerOf2 = false)
         : mergeOp(op), defaultValue(dflt) {
         build(v, alignPowerOf2);
     }
@@ -168,8 +169,8 @@ inline CompactSegmentTree<T, MergeOp> makeCompactSegmentTree(const T arr[], int
 //   f(x): xxxxxxxxxxxOOOOOOOO
 //         S          ^
 // O(logN)
-template <typename T, typename MergeOp>
-inline int findNext(const CompactSegmentTree<T,MergeOp>& st, int start, const function<bool(T)>& f) {
+template <typename T, typename MergeOp, typename Pred>
+inline int findNext(const CompactSegmentTree<T,MergeOp>& st, int start, const Pred& f) {
     int cur = start + st.N;
 
     while (true) {
@@ -200,8 +201,8 @@ inline int findNext(const CompactSegmentTree<T,MergeOp>& st, int start, const fu
 //   f(x): OOOOOOOOxxxxxxxxxxx
 //                ^          S
 // O(logN)
-template <typename T, typename MergeOp>
-inline int findPrev(const CompactSegmentTree<T, MergeOp>& st, int start, const function<bool(T)>& f) {
+template <typename T, typename MergeOp, typename Pred>
+inline int findPrev(const CompactSegmentTree<T, MergeOp>& st, int start, const Pred& f) {
     int cur = start + st.N;
 
     while (true) {
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include "monoid.h"
+#include "../common/cpuFeature.h"
+
+/*
+  Static binary segment tree in Eytzinger (heap) layout, node k has children 2k and 2k + 1
+
+  - Monoid : SumMonoid, MinMonoid, MaxMonoid, ... (monoid.h)
+  - the storage is aligned to 64 bytes, so the 16 descendants 16k .. 16k + 15 of node k four levels below
+    share one cache line (int) and a descent prefetches them four levels ahead
+  - range queries and point updates run bottom-up like CompactSegmentTree
+
+  <How to use>
+    EytzingerSegmentTree<int, SumMonoid<int>> tree(v);
+    int s = tree.query(left, right);        // inclusive
+    int i = tree.lowerBound(k);             // the first i where v[0] + ... + v[i] >= k
+*/
+
+template <typename T, typename Monoid>
+struct EytzingerSegmentTree {
+    static const int PREFETCH_LINES = (16 * sizeof(T) + 63) / 64;
+
+    int       N;
+    int       P;                            // a power of 2, N <= P, leaves are tree[P..P+N)
+    vector<T> storage;
+
+    EytzingerSegmentTree() : N(0), P(1) {
+    }
+
+    explicit EytzingerSegmentTree(const vector<T>& v) {
+        build(v);
+    }
+
+    EytzingerSegmentTree(const T a[], int n) {
+        build(a, n);
+    }
+
+    // the aligned start of a copy's storage is at another offset, so the data is copied through base()
+    EytzingerSegmentTree(const EytzingerSegmentTree& rhs) {
+        copyFrom(rhs);
+    }
+
+    EytzingerSegmentTree(EytzingerSegmentTree&& rhs) = default;
+
+    EytzingerSegmentTree& operator =(const EytzingerSegmentTree& rhs) {
+        if (this != &rhs)
+            copyFrom(rhs);
+        return *this;
+    }
+
+    EytzingerSegmentTree& operator =(EytzingerSegmentTree&& rhs) = default;
+
+    // O(N)
+    void build(const T a[], int n) {
+        N = n;
+        P = 1;
+        while (P < n)
+            P <<= 1;
+
+        storage.assign(2 * P + 64 / sizeof(T), Monoid::identity());
+        T* tree = base();
+        copy(a, a + n, tree + P);
+        for (int i = P - 1; i > 0; i--)
+            tree[i] = Monoid()(tree[2 * i], tree[2 * i + 1]);
+    }
+
+    void build(const vector<T>& v) {
+        build(v.data(), int(v.size()));
+    }
+
+    //--- query
+
+    T query(int index) const {
+        return base()[P + index];
+    }
+
+    // inclusive, O(log(N))
+    T query(int left, int right) const {
+        const T* tree = base();
+        T resL = Monoid::identity(), resR = Monoid::identity();
+        for (int L = left + P, R = right + P + 1; L < R; L >>= 1, R >>= 1) {
+            if (L & 1)
+                resL = Monoid()(resL, tree[L++]);
+            if (R & 1)
+                resR = Monoid()(tree[--R], resR);
+        }
+        return Monoid()(resL, resR);
+    }
+
+    //--- update
+
+    // O(log(N))
+    void update(int index, T value) {
+        T* tree = base();
+        int i = index + P;
+        tree[i] = value;
+        for (i >>= 1; i > 0; i >>= 1)
+            tree[i] = Monoid()(tree[2 * i], tree[2 * i + 1]);
+    }
+
+    //--- search
+
+    // PRECONDITION: Monoid is SumMonoid and all values are non-negative
+    // the first index where query(0, index) >= x, N if none, O(log(N))
+    int lowerBound(T x) const {
+        const T* tree = base();
+        if (tree[1] < x)
+            return N;
+
+        int k = 1;
+        while (k < P) {
+            prefetch(tree + 16 * k);
+            k <<= 1;
+            if (tree[k] < x) {
+                x -= tree[k];
+                k++;
+            }
+        }
+        return min(k - P, N);
+    }
+
+    // PRECONDITION: Monoid is MinMonoid or MaxMonoid
+    // the first index where value <= x (min) or value >= x (max), N if none, O(log(N))
+    int findFirst(T x) const {
+        const T* tree = base();
+        if (!(Monoid()(tree[1], x) == tree[1]))
+            return N;
+
+        int k = 1;
+        while (k < P) {
+            prefetch(tree + 16 * k);
+            k <<= 1;
+            if (!(Monoid()(tree[k], x) == tree[k]))
+                k++;
+        }
+        return min(k - P, N);
+    }
+
+private:
+    void copyFrom(const EytzingerSegmentTree& rhs) {
+        N = rhs.N;
+        P = rhs.P;
+        storage.assign(rhs.storage.size(), Monoid::identity());
+        if (!storage.empty())
+            copy(rhs.base(), rhs.base() + 2 * P, base());
+    }
+
+    // 64-byte aligned
+    T* base() {
+        return reinterpret_cast<T*>((reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t(63));
+    }
+
+    const T* base() const {
+        return reinterpret_cast<const T*>((reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t(63));
+    }
+
+    // descendants beyond the leaves are never read, prefetching them is harmless
+    static void prefetch(const T* p) {
+        for (int i = 0; i < PREFETCH_LINES; i++)
+            _mm_prefetch(reinterpret_cast<const char*>(p) + i * 64, _MM_HINT_T0);
+    }
+};
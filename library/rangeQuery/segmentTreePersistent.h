@@ -1,5 +1,7 @@
 #pragma once
 
+#include "monoid.h"
+
 template <typename T, typename MergeOp = function<T(T,T)>>
 struct PersistentSegmentTree {
     struct Node {
@@ -24,22 +26,22 @@ struct PersistentSegmentTree {
     MergeOp         mergeOp;
     T               defaultValue;
 
-    explicit PersistentSegmentTree(MergeOp op, T dflt = T()) : N(0), initRoot(-1), mergeOp(op), defaultValue(dflt) {
+    explicit PersistentSegmentTree(MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get()) : N(0), initRoot(-1), mergeOp(op), defaultValue(dflt) {
     }
 
-    PersistentSegmentTree(int n, MergeOp op, T dflt = T()) : mergeOp(op), defaultValue(dflt) {
+    explicit PersistentSegmentTree(int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get()) : mergeOp(op), defaultValue(dflt) {
         build(defaultValue, n);
     }
 
-    PersistentSegmentTree(T value, int n, MergeOp op, T dflt = T()) : mergeOp(op), defaultValue(dflt) {
+    PersistentSegmentTree(T value, int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get()) : mergeOp(op), defaultValue(dflt) {
         build(value, n);
     }
 
-    PersistentSegmentTree(const T A[], int n, MergeOp op, T dflt = T()) : mergeOp(op), defaultValue(dflt) {
+    PersistentSegmentTree(const T A[], int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get()) : mergeOp(op), defaultValue(dflt) {
         build(A, n);
     }
 
-    PersistentSegmentTree(const vector<T>& A, MergeOp op, T dflt = T()) : mergeOp(op), defaultValue(dflt) {
+    explicit PersistentSegmentTree(const vector<T>& A, MergeOp op = MergeOpDefault<MergeOp>::get(), T dflt = MergeOpIdentity<MergeOp, T>::get()) : mergeOp(op), defaultValue(dflt) {
         build(A);
     }
 
@@ -94,7 +96,8 @@ struct PersistentSegmentTree {
     //   f(x): xxxxxxxxxxxOOOOOOOO
     //         S          ^
     // O(logN)
-    int lowerBound(int root, const function<bool(T)>& f) const {
+    template <typename Pred>
+    int lowerBound(int root, const Pred& f) const {
         return recLowerBound(f, defaultValue, root, 0, N - 1);
     }
 
@@ -175,7 +178,8 @@ private:
                        recQuery(nodes[node].R, mid + 1, right, indexL, indexR));
     }
 
-    int recLowerBound(const function<bool(T)>& f, T delta, int node, int left, int right) const {
+    template <typename Pred>
+    int recLowerBound(const Pred& f, T delta, int node, int left, int right) const {
         if (left > right)
             return left;
 
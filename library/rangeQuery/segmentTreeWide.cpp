@@ -0,0 +1,249 @@
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+
+#include "segmentTreeWide.h"
+#include "segmentTreeEytzinger.h"
+#include "segmentTree.h"
+#include "segmentTreeCompact.h"
+
+/////////// For Testing ///////////////////////////////////////////////////////
+
+#include <time.h>
+#include <cassert>
+#include <string>
+#include <iostream>
+#include "../common/iostreamhelper.h"
+#include "../common/profile.h"
+#include "../common/rand.h"
+#include "../integer/bit.h"
+
+template <typename T, typename Monoid>
+static void checkStaticTree(const vector<T>& v0, int updateN) {
+    vector<T> v(v0);
+    int N = int(v.size());
+    WideSegmentTree<T, Monoid> wide(v);
+    EytzingerSegmentTree<T, Monoid> eytzinger(v);
+
+    for (int i = 0; i < 1000 + updateN; i++) {
+        if (i >= 1000) {
+            int idx = RandInt32::get() % N;
+            T x = T(RandInt32::get() % 10000);
+            v[idx] = x;
+            wide.update(idx, x);
+            eytzinger.update(idx, x);
+        }
+        int L = RandInt32::get() % N, R = RandInt32::get() % N;
+        if (L > R)
+            swap(L, R);
+        T gt = Monoid::identity();
+        for (int j = L; j <= R; j++)
+            gt = Monoid()(gt, v[j]);
+        assert(wide.query(L, R) == gt);
+        assert(eytzinger.query(L, R) == gt);
+        assert(wide.query(L) == v[L] && eytzinger.query(L) == v[L]);
+    }
+}
+
+void testSegmentTreeWide() {
+    return; //TODO: if you want to test, make this line a comment.
+
+    cout << "--- Wide (B-ary) / Eytzinger Segment Tree ---------------------------" << endl;
+    for (int N : { 1, 2, 15, 16, 17, 255, 256, 257, 1000, 4097, 70000 }) {
+        vector<int> v(N);
+        vector<long long> vl(N);
+        for (int i = 0; i < N; i++)
+            vl[i] = v[i] = RandInt32::get() % 10000;
+
+        checkStaticTree<int, SumMonoid<int>>(v, 300);
+        checkStaticTree<int, MinMonoid<int>>(v, 300);
+        checkStaticTree<int, MaxMonoid<int>>(v, 300);
+        checkStaticTree<long long, SumMonoid<long long>>(vl, 300);
+        checkStaticTree<long long, MinMonoid<long long>>(vl, 300);
+
+        WideSegmentTree<int, SumMonoid<int>> wideSum(v);
+        EytzingerSegmentTree<int, SumMonoid<int>> eytzingerSum(v);
+        WideSegmentTree<int, MinMonoid<int>> wideMin(v);
+        EytzingerSegmentTree<int, MinMonoid<int>> eytzingerMin(v);
+        WideSegmentTree<int, MaxMonoid<int>> wideMax(v);
+        EytzingerSegmentTree<int, MaxMonoid<int>> eytzingerMax(v);
+        WideSegmentTree<long long, SumMonoid<long long>> wideSumL(vl);
+
+        long long total = 0;
+        for (int x : v)
+            total += x;
+        for (int i = 0; i < 300; i++) {
+            int k = int(RandInt32::get() % (total + 2));
+            int gt = 0;
+            long long sum = 0;
+            while (gt < N && sum + v[gt] < k)
+                sum += v[gt++];
+            assert(wideSum.lowerBound(k) == gt);
+            assert(eytzingerSum.lowerBound(k) == gt);
+            assert(wideSumL.lowerBound(k) == gt);
+
+            int x = RandInt32::get() % 10000;
+            int gtMin = int(find_if(v.begin(), v.end(), [x](int a) { return a <= x; }) - v.begin());
+            int gtMax = int(find_if(v.begin(), v.end(), [x](int a) { return a >= x; }) - v.begin());
+            assert(wideMin.findFirst(x) == gtMin);
+            assert(eytzingerMin.findFirst(x) == gtMin);
+            assert(wideMax.findFirst(x) == gtMax);
+            assert(eytzingerMax.findFirst(x) == gtMax);
+        }
+        assert(wideMin.findFirst(-1) == N && eytzingerMin.findFirst(-1) == N);
+        assert(wideMax.findFirst(10000) == N && eytzingerMax.findFirst(10000) == N);
+
+        // copies
+        {
+            auto wideCopy = wideSum;
+            auto eytzingerCopy = eytzingerSum;
+            WideSegmentTree<int, SumMonoid<int>> wideAssigned(vector<int>(3, 1));
+            EytzingerSegmentTree<int, SumMonoid<int>> eytzingerAssigned(vector<int>(3, 1));
+            wideAssigned = wideSum;
+            eytzingerAssigned = eytzingerSum;
+            wideCopy.update(0, v[0] + 1);
+            eytzingerCopy.update(0, v[0] + 1);
+            for (int i = 0; i < 100; i++) {
+                int L = RandInt32::get() % N, R = RandInt32::get() % N;
+                if (L > R)
+                    swap(L, R);
+                int gt = wideSum.query(L, R);
+                assert(eytzingerSum.query(L, R) == gt);
+                assert(wideAssigned.query(L, R) == gt && eytzingerAssigned.query(L, R) == gt);
+                assert(wideCopy.query(L, R) == gt + (L == 0) && eytzingerCopy.query(L, R) == gt + (L == 0));
+            }
+        }
+    }
+    cout << "OK!" << endl;
+
+    cout << "*** Speed Test" << endl;
+    {
+        const int OPS = 1 << 22;
+
+        // from L1-sized arrays to main memory, 1 << 30 (4 GB of int) needs about 12 GB of memory with all trees
+        for (int N : { 1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 26 }) {
+            vector<int> v(N);
+            for (auto& x : v)
+                x = RandInt32::get() % 16;
+
+            vector<pair<int, int>> Q(OPS);
+            for (auto& q : Q) {
+                q.first = RandInt32::get() % N;
+                q.second = RandInt32::get() % N;
+                if (q.first > q.second)
+                    swap(q.first, q.second);
+            }
+            vector<int> K(OPS);
+            for (auto& k : K)
+                k = RandInt32::get() % (N * 7);
+
+            auto runQuery = [&](const auto& tree) {
+                long long res = 0;
+                for (auto& q : Q)
+                    res += tree.query(q.first, q.second);
+                return res;
+            };
+            auto runUpdate = [&](auto& tree) {
+                for (auto& q : Q)
+                    tree.update(q.first, q.second % 16);
+            };
+
+            long long res1, res2, res3, res4;
+            long long lb1 = 0, lb2 = 0, lb3 = 0;
+            {
+                SegmentTree<int, SumMonoid<int>> tree(v);
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", SegmentTree, query : ";
+                PROFILE_HI_START(0);
+                res1 = runQuery(tree);
+                PROFILE_HI_STOP(0);
+
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", SegmentTree, lowerBound : ";
+                PROFILE_HI_START(1);
+                for (int k : K)
+                    lb1 += tree.lowerBound([k](int x) { return x >= k; });
+                PROFILE_HI_STOP(1);
+            }
+            {
+                CompactSegmentTree<int, SumMonoid<int>> tree(v);
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", CompactSegmentTree, query : ";
+                PROFILE_HI_START(2);
+                res2 = runQuery(tree);
+                PROFILE_HI_STOP(2);
+
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", CompactSegmentTree, update : ";
+                PROFILE_HI_START(3);
+                runUpdate(tree);
+                PROFILE_HI_STOP(3);
+            }
+            {
+                WideSegmentTree<int, SumMonoid<int>> tree(v);
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", WideSegmentTree, query : ";
+                PROFILE_HI_START(4);
+                res3 = runQuery(tree);
+                PROFILE_HI_STOP(4);
+
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", WideSegmentTree, lowerBound : ";
+                PROFILE_HI_START(5);
+                for (int k : K)
+                    lb2 += tree.lowerBound(k);
+                PROFILE_HI_STOP(5);
+
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", WideSegmentTree, update : ";
+                PROFILE_HI_START(6);
+                runUpdate(tree);
+                PROFILE_HI_STOP(6);
+            }
+            {
+                EytzingerSegmentTree<int, SumMonoid<int>> tree(v);
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", EytzingerSegmentTree, query : ";
+                PROFILE_HI_START(7);
+                res4 = runQuery(tree);
+                PROFILE_HI_STOP(7);
+
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", EytzingerSegmentTree, lowerBound : ";
+                PROFILE_HI_START(8);
+                for (int k : K)
+                    lb3 += tree.lowerBound(k);
+                PROFILE_HI_STOP(8);
+
+                cout << "N = 2^" << log2Int(unsigned(N)) << ", EytzingerSegmentTree, update : ";
+                PROFILE_HI_START(9);
+                runUpdate(tree);
+                PROFILE_HI_STOP(9);
+            }
+            assert(res1 == res2 && res2 == res3 && res3 == res4);
+            assert(lb1 == lb2 && lb2 == lb3);
+        }
+    }
+    {
+        const int N = 1 << 22;
+        const int OPS = 1 << 22;
+        vector<int> v(N);
+        for (auto& x : v)
+            x = RandInt32::get();
+        vector<int> X(OPS);
+        for (auto& x : X)
+            x = RandInt32::get() % 100000;
+
+        WideSegmentTree<int, MinMonoid<int>> wide(v);
+        EytzingerSegmentTree<int, MinMonoid<int>> eytzinger(v);
+        long long res1 = 0, res2 = 0;
+
+        cout << "N = 2^22, WideSegmentTree, MinMonoid, findFirst : ";
+        PROFILE_HI_START(10);
+        for (int x : X)
+            res1 += wide.findFirst(x);
+        PROFILE_HI_STOP(10);
+
+        cout << "N = 2^22, EytzingerSegmentTree, MinMonoid, findFirst : ";
+        PROFILE_HI_START(11);
+        for (int x : X)
+            res2 += eytzinger.findFirst(x);
+        PROFILE_HI_STOP(11);
+
+        assert(res1 == res2);
+    }
+}
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <cstdint>
+#include "monoid.h"
+#include "../common/cpuFeature.h"
+
+/*
+  Static B-ary segment tree ("S-tree"), every node is one cache line
+
+  - Monoid : SumMonoid, MinMonoid, MaxMonoid, ... (monoid.h)
+  - B = 64 / sizeof(T) children per node (16-ary for int), levels are stored bottom-up and aligned to 64 bytes
+  - a range query reads at most two nodes per level, O(log_B(N)) cache lines
+    (in-node reductions are masked AVX2 operations for int)
+  - a point update rewrites one leaf-to-root path
+  - lowerBound() (sums of non-negative values) and findFirst() (min / max) descend from the root,
+    the B children of a node are compared at once with AVX2 for int (in-node prefix sums for lowerBound())
+
+  <How to use>
+    WideSegmentTree<int, MinMonoid<int>> tree(v);
+    int x = tree.query(left, right);        // inclusive
+    tree.update(index, value);
+*/
+
+//--------- In-node operations ------------------------------------------------
+
+template <typename T, typename Monoid>
+struct WideNodeOpScalar {
+    // combine of node[a..b]
+    static T reduce(const T* node, int a, int b) {
+        T res = Monoid::identity();
+        for (int i = a; i <= b; i++)
+            res = Monoid()(res, node[i]);
+        return res;
+    }
+
+    // the first j in [0, n) where Monoid()(node[j], x) == node[j] (node[j] <= x for min, node[j] >= x for max), n if none
+    static int findFirst(const T* node, int n, T x) {
+        for (int j = 0; j < n; j++) {
+            if (Monoid()(node[j], x) == node[j])
+                return j;
+        }
+        return n;
+    }
+
+    // the first j in [0, n) where node[0] + ... + node[j] >= x, x -= node[0] + ... + node[j - 1]
+    static int lowerBound(const T* node, int n, T& x) {
+        for (int j = 0; j < n; j++) {
+            if (x <= node[j])
+                return j;
+            x -= node[j];
+        }
+        return n;
+    }
+};
+
+template <typename T, typename Monoid>
+struct WideNodeOp : WideNodeOpScalar<T, Monoid> {
+};
+
+// AVX2 operations for int, 16 lanes (two vectors) per node
+struct WideNodeVecSum {
+    TARGET_AVX2 static __m256i combine(__m256i a, __m256i b) {
+        return _mm256_add_epi32(a, b);
+    }
+
+    TARGET_AVX2 static __m128i combine(__m128i a, __m128i b) {
+        return _mm_add_epi32(a, b);
+    }
+};
+
+struct WideNodeVecMin {
+    TARGET_AVX2 static __m256i combine(__m256i a, __m256i b) {
+        return _mm256_min_epi32(a, b);
+    }
+
+    TARGET_AVX2 static __m128i combine(__m128i a, __m128i b) {
+        return _mm_min_epi32(a, b);
+    }
+
+    // lanes where v <= x
+    TARGET_AVX2 static __m256i reaches(__m256i v, __m256i x) {
+        return _mm256_xor_si256(_mm256_cmpgt_epi32(v, x), _mm256_set1_epi32(-1));
+    }
+};
+
+struct WideNodeVecMax {
+    TARGET_AVX2 static __m256i combine(__m256i a, __m256i b) {
+        return _mm256_max_epi32(a, b);
+    }
+
+    TARGET_AVX2 static __m128i combine(__m128i a, __m128i b) {
+        return _mm_max_epi32(a, b);
+    }
+
+    // lanes where v >= x
+    TARGET_AVX2 static __m256i reaches(__m256i v, __m256i x) {
+        return _mm256_xor_si256(_mm256_cmpgt_epi32(x, v), _mm256_set1_epi32(-1));
+    }
+};
+
+template <typename Monoid, typename Vec>
+struct WideNodeOpInt32 : WideNodeOpScalar<int, Monoid> {
+    typedef WideNodeOpScalar<int, Monoid> Scalar;
+
+    static int reduce(const int* node, int a, int b) {
+        if (CpuFeature::hasAVX2())
+            return reduceAVX2(node, a, b);
+        return Scalar::reduce(node, a, b);
+    }
+
+    static int findFirst(const int* node, int n, int x) {
+        if (n == 16 && CpuFeature::hasAVX2())
+            return findFirstAVX2(node, x);
+        return Scalar::findFirst(node, n, x);
+    }
+
+private:
+    TARGET_AVX2
+    static int reduceAVX2(const int* node, int a, int b) {
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i lo = _mm256_set1_epi32(a - 1), hi = _mm256_set1_epi32(b + 1);
+        __m256i identity = _mm256_set1_epi32(Monoid::identity());
+
+        __m256i idx0 = lane, idx1 = _mm256_add_epi32(lane, _mm256_set1_epi32(8));
+        __m256i m0 = _mm256_and_si256(_mm256_cmpgt_epi32(idx0, lo), _mm256_cmpgt_epi32(hi, idx0));
+        __m256i m1 = _mm256_and_si256(_mm256_cmpgt_epi32(idx1, lo), _mm256_cmpgt_epi32(hi, idx1));
+        __m256i v0 = _mm256_blendv_epi8(identity, _mm256_load_si256(reinterpret_cast<const __m256i*>(node)), m0);
+        __m256i v1 = _mm256_blendv_epi8(identity, _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8)), m1);
+
+        __m256i v = Vec::combine(v0, v1);
+        __m128i t = Vec::combine(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        t = Vec::combine(t, _mm_shuffle_epi32(t, 0x4E));
+        t = Vec::combine(t, _mm_shuffle_epi32(t, 0xB1));
+        return _mm_cvtsi128_si32(t);
+    }
+
+    TARGET_AVX2
+    static int findFirstAVX2(const int* node, int x) {
+        __m256i vx = _mm256_set1_epi32(x);
+        __m256i m0 = Vec::reaches(_mm256_load_si256(reinterpret_cast<const __m256i*>(node)), vx);
+        __m256i m1 = Vec::reaches(_mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8)), vx);
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(m0)))
+                      | (unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(m1))) << 8);
+        if (mask == 0)
+            return 16;
+#ifndef __GNUC__
+        return int(_tzcnt_u32(mask));
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+};
+
+template <>
+struct WideNodeOp<int, SumMonoid<int>> : WideNodeOpInt32<SumMonoid<int>, WideNodeVecSum> {
+    static int lowerBound(const int* node, int n, int& x) {
+        if (n == 16 && CpuFeature::hasAVX2())
+            return lowerBoundAVX2(node, x);
+        return Scalar::lowerBound(node, n, x);
+    }
+
+private:
+    // in-node prefix sums, the answer is the number of prefix sums less than x
+    TARGET_AVX2
+    static int lowerBoundAVX2(const int* node, int& x) {
+        __m256i p0 = prefixSum(_mm256_load_si256(reinterpret_cast<const __m256i*>(node)));
+        __m256i p1 = prefixSum(_mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8)));
+        p1 = _mm256_add_epi32(p1, _mm256_permutevar8x32_epi32(p0, _mm256_set1_epi32(7)));
+
+        __m256i vx = _mm256_set1_epi32(x);
+        unsigned mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vx, p0))))
+                      | (unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vx, p1)))) << 8);
+#ifndef __GNUC__
+        int j = int(__popcnt(mask));
+#else
+        int j = __builtin_popcount(mask);
+#endif
+        if (j > 0) {
+            alignas(32) int prefix[16];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(prefix), p0);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(prefix + 8), p1);
+            x -= prefix[j - 1];
+        }
+        return j;
+    }
+
+    TARGET_AVX2
+    static __m256i prefixSum(__m256i v) {
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        __m256i carry = _mm256_permute2x128_si256(v, v, 0x08);     // (0, low half)
+        return _mm256_add_epi32(v, _mm256_shuffle_epi32(carry, 0xFF));
+    }
+};
+
+template <>
+struct WideNodeOp<int, MinMonoid<int>> : WideNodeOpInt32<MinMonoid<int>, WideNodeVecMin> {
+};
+
+template <>
+struct WideNodeOp<int, MaxMonoid<int>> : WideNodeOpInt32<MaxMonoid<int>, WideNodeVecMax> {
+};
+
+//--------- Wide Segment Tree -------------------------------------------------
+
+template <typename T, typename Monoid>
+struct WideSegmentTree {
+    typedef WideNodeOp<T, Monoid> NodeOp;
+
+    static const int B = 64 / sizeof(T);    // children per node, one cache line
+
+    int         N;
+    vector<int> offset;                     // offset[h] = the first element of level h (level 0 = leaves)
+    vector<T>   storage;
+
+    WideSegmentTree() : N(0) {
+    }
+
+    explicit WideSegmentTree(const vector<T>& v) {
+        build(v);
+    }
+
+    WideSegmentTree(const T a[], int n) {
+        build(a, n);
+    }
+
+    // the aligned start of a copy's storage is at another offset, so the data is copied through base()
+    WideSegmentTree(const WideSegmentTree& rhs) {
+        copyFrom(rhs);
+    }
+
+    WideSegmentTree(WideSegmentTree&& rhs) = default;
+
+    WideSegmentTree& operator =(const WideSegmentTree& rhs) {
+        if (this != &rhs)
+            copyFrom(rhs);
+        return *this;
+    }
+
+    WideSegmentTree& operator =(WideSegmentTree&& rhs) = default;
+
+    // O(N)
+    void build(const T a[], int n) {
+        N = n;
+
+        offset.clear();
+        int size = roundUp(max(n, 1));
+        int total = 0;
+        while (true) {
+            offset.push_back(total);
+            total += size;
+            if (size <= B)
+                break;
+            size = roundUp((size + B - 1) / B);
+        }
+        offset.push_back(total);
+
+        storage.assign(total + B, Monoid::identity());
+        copy(a, a + n, level(0));
+        for (int h = 1; h < height(); h++) {
+            const T* child = level(h - 1);
+            T* node = level(h);
+            int n = (levelSize(h - 1) + B - 1) / B;
+            for (int i = 0; i < n; i++)
+                node[i] = NodeOp::reduce(child + i * B, 0, B - 1);
+        }
+    }
+
+    void build(const vector<T>& v) {
+        build(v.data(), int(v.size()));
+    }
+
+    int height() const {
+        return int(offset.size()) - 1;
+    }
+
+    //--- query
+
+    T query(int index) const {
+        return level(0)[index];
+    }
+
+    // inclusive, O(log_B(N))
+    T query(int left, int right) const {
+        T res = Monoid::identity();
+        for (int h = 0; left <= right; h++) {
+            const T* a = level(h);
+            int nodeL = left / B, nodeR = right / B;
+            if (nodeL == nodeR)
+                return Monoid()(res, NodeOp::reduce(a + nodeL * B, left % B, right % B));
+
+            if (left % B) {
+                res = Monoid()(res, NodeOp::reduce(a + nodeL * B, left % B, B - 1));
+                nodeL++;
+            }
+            if (right % B != B - 1) {
+                res = Monoid()(res, NodeOp::reduce(a + nodeR * B, 0, right % B));
+                nodeR--;
+            }
+            left = nodeL;
+            right = nodeR;
+        }
+        return res;
+    }
+
+    //--- update
+
+    // O(B * log_B(N))
+    void update(int index, T value) {
+        level(0)[index] = value;
+        for (int h = 1; h < height(); h++) {
+            index /= B;
+            level(h)[index] = NodeOp::reduce(level(h - 1) + index * B, 0, B - 1);
+        }
+    }
+
+    //--- search
+
+    // PRECONDITION: Monoid is SumMonoid and all values are non-negative
+    // the first index where query(0, index) >= x, N if none, O(B * log_B(N))
+    int lowerBound(T x) const {
+        int k = 0;
+        for (int h = height() - 1; h >= 0; h--) {
+            int j = NodeOp::lowerBound(level(h) + k * B, B, x);
+            if (j >= B)
+                return N;
+            k = k * B + j;
+            if (h > 0)
+                prefetch(level(h - 1) + k * B);
+        }
+        return min(k, N);
+    }
+
+    // PRECONDITION: Monoid is MinMonoid or MaxMonoid
+    // the first index in [0, N) where value <= x (min) or value >= x (max), N if none, O(log_B(N))
+    int findFirst(T x) const {
+        int k = 0;
+        for (int h = height() - 1; h >= 0; h--) {
+            int j = NodeOp::findFirst(level(h) + k * B, B, x);
+            if (j >= B)
+                return N;
+            k = k * B + j;
+            if (h > 0)
+                prefetch(level(h - 1) + k * B);
+        }
+        return min(k, N);
+    }
+
+private:
+    void copyFrom(const WideSegmentTree& rhs) {
+        N = rhs.N;
+        offset = rhs.offset;
+        storage.assign(rhs.storage.size(), Monoid::identity());
+        if (!storage.empty())
+            copy(rhs.base(), rhs.base() + offset.back(), base());
+    }
+
+    static int roundUp(int n) {
+        return (n + B - 1) / B * B;
+    }
+
+    int levelSize(int h) const {
+        return offset[h + 1] - offset[h];
+    }
+
+    // 64-byte aligned
+    T* base() {
+        return reinterpret_cast<T*>((reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t(63));
+    }
+
+    const T* base() const {
+        return reinterpret_cast<const T*>((reinterpret_cast<uintptr_t>(storage.data()) + 63) & ~uintptr_t(63));
+    }
+
+    T* level(int h) {
+        return base() + offset[h];
+    }
+
+    const T* level(int h) const {
+        return base() + offset[h];
+    }
+
+    static void prefetch(const T* p) {
+        _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0);
+    }
+};
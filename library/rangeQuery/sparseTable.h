@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <functional>
+#include "monoid.h"
 
 //--------- General Sparse Table ----------------------------------------------
 
@@ -13,16 +14,16 @@ struct SparseTable {
     MergeOp             mergeOp;
     T                   defaultValue;
 
-    explicit SparseTable(MergeOp op, T dfltValue = T())
+    explicit SparseTable(MergeOp op = MergeOpDefault<MergeOp>::get(), T dfltValue = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dfltValue) {
     }
 
-    SparseTable(const T a[], int n, MergeOp op, T dfltValue = T())
+    SparseTable(const T a[], int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dfltValue = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dfltValue) {
         build(a, n);
     }
 
-    SparseTable(const vector<T>& a, MergeOp op, T dfltValue = T())
+    explicit SparseTable(const vector<T>& a, MergeOp op = MergeOpDefault<MergeOp>::get(), T dfltValue = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dfltValue) {
         build(a);
     }
@@ -101,6 +102,11 @@ inline SparseTable<T, MergeOp> makeSparseTable(const T arr[], int size, MergeOp
 }
 
 /* example
+    0) with a monoid (no std::function)
+        SparseTable<int, MinMonoid<int>> sparseTable(v);
+        ...
+        sparseTable.query(left, right);
+
     1) Min Sparse Table (RMQ)
         auto sparseTable = makeSparseTable<int>(v, [](int a, int b) { return min(a, b); }, INT_MAX);
         ...
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <functional>
+#include "monoid.h"
 
 // ref: https://cp-algorithms.com/data_structures/sqrt-tree.html
 
@@ -22,16 +23,16 @@ struct SqrtTree {
     MergeOp             mergeOp;
     T                   defaultValue;
 
-    explicit SqrtTree(MergeOp op, T dfltValue = T())
+    explicit SqrtTree(MergeOp op = MergeOpDefault<MergeOp>::get(), T dfltValue = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dfltValue) {
     }
 
-    SqrtTree(const T a[], int n, MergeOp op, T dfltValue = T())
+    SqrtTree(const T a[], int n, MergeOp op = MergeOpDefault<MergeOp>::get(), T dfltValue = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dfltValue) {
         build(a, n);
     }
 
-    SqrtTree(const vector<T>& a, MergeOp op, T dfltValue = T())
+    explicit SqrtTree(const vector<T>& a, MergeOp op = MergeOpDefault<MergeOp>::get(), T dfltValue = MergeOpIdentity<MergeOp, T>::get())
         : mergeOp(op), defaultValue(dfltValue) {
         build(a);
     }